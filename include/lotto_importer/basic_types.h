@@ -22,25 +22,73 @@ typedef enum : uint64_t
 	UNKNOWN,
 } ruota_t;
 
-typedef struct __attribute__((packed)) BITS
-{
-	uint64_t ruota : 4;
-	uint64_t a     : 7;
-	uint64_t b     : 7;
-	uint64_t c     : 7;
-	uint64_t d     : 7;
-	uint64_t e     : 7;
-	uint64_t day   : 5;
-	uint64_t month : 4;
-	uint64_t year  : 16;
-} bits_t;
-
-typedef union __attribute__((packed)) EXTRACTION
+// a draw on one ruota as a 64 bit word, fields from the most significant
+// bit down:
+//   year (16) | month (4) | day (5) | ruota (4) | a | b | c | d | e (7 each)
+// year, month and day read together are make_date(), and the raw words
+// order like (year, month, day, ruota), so that sorting, merging, range
+// searches and dedup of records are plain integer operations. The layout
+// is fixed by the shifts below, whatever the compiler or the host
+#define LOTTO_SHIFT_E        (0)
+#define LOTTO_SHIFT_D        (7)
+#define LOTTO_SHIFT_C        (14)
+#define LOTTO_SHIFT_B        (21)
+#define LOTTO_SHIFT_A        (28)
+#define LOTTO_SHIFT_RUOTA    (35)
+#define LOTTO_SHIFT_DAY      (39)
+#define LOTTO_SHIFT_MONTH    (44)
+#define LOTTO_SHIFT_YEAR     (48)
+#define LOTTO_SHIFT_DATE     LOTTO_SHIFT_DAY
+
+#define LOTTO_MASK_NUMBER    (0x7F)
+#define LOTTO_MASK_RUOTA     (0xF)
+#define LOTTO_MASK_DAY       (0x1F)
+#define LOTTO_MASK_MONTH     (0xF)
+#define LOTTO_MASK_YEAR      (0xFFFF)
+
+typedef struct EXTRACTION
 {
 	uint64_t raw;
-	bits_t   bits;
+
+	constexpr uint32_t field(uint32_t shift, uint64_t mask) const { return (uint32_t) ( (raw >> shift) & mask ); }
+
+	constexpr uint32_t year() const  { return field(LOTTO_SHIFT_YEAR, LOTTO_MASK_YEAR); }
+	constexpr uint32_t month() const { return field(LOTTO_SHIFT_MONTH, LOTTO_MASK_MONTH); }
+	constexpr uint32_t day() const   { return field(LOTTO_SHIFT_DAY, LOTTO_MASK_DAY); }
+	// as make_date()
+	constexpr uint32_t date() const  { return (uint32_t) ( raw >> LOTTO_SHIFT_DATE ); }
+	constexpr uint32_t ruota() const { return field(LOTTO_SHIFT_RUOTA, LOTTO_MASK_RUOTA); }
+	// date and ruota, one record per key in a db without duplicates
+	constexpr uint64_t key() const   { return raw >> LOTTO_SHIFT_RUOTA; }
+	constexpr uint32_t a() const     { return field(LOTTO_SHIFT_A, LOTTO_MASK_NUMBER); }
+	constexpr uint32_t b() const     { return field(LOTTO_SHIFT_B, LOTTO_MASK_NUMBER); }
+	constexpr uint32_t c() const     { return field(LOTTO_SHIFT_C, LOTTO_MASK_NUMBER); }
+	constexpr uint32_t d() const     { return field(LOTTO_SHIFT_D, LOTTO_MASK_NUMBER); }
+	constexpr uint32_t e() const     { return field(LOTTO_SHIFT_E, LOTTO_MASK_NUMBER); }
 } extraction_t;
 
+// fields out of range are cut to their width
+constexpr extraction_t make_extraction(uint64_t year, uint64_t month, uint64_t day, uint64_t ruota,
+		uint64_t a, uint64_t b, uint64_t c, uint64_t d, uint64_t e)
+{
+	return extraction_t{ ( (year & LOTTO_MASK_YEAR) << LOTTO_SHIFT_YEAR ) | \
+	                     ( (month & LOTTO_MASK_MONTH) << LOTTO_SHIFT_MONTH ) | \
+	                     ( (day & LOTTO_MASK_DAY) << LOTTO_SHIFT_DAY ) | \
+	                     ( (ruota & LOTTO_MASK_RUOTA) << LOTTO_SHIFT_RUOTA ) | \
+	                     ( (a & LOTTO_MASK_NUMBER) << LOTTO_SHIFT_A ) | \
+	                     ( (b & LOTTO_MASK_NUMBER) << LOTTO_SHIFT_B ) | \
+	                     ( (c & LOTTO_MASK_NUMBER) << LOTTO_SHIFT_C ) | \
+	                     ( (d & LOTTO_MASK_NUMBER) << LOTTO_SHIFT_D ) | \
+	                     ( (e & LOTTO_MASK_NUMBER) << LOTTO_SHIFT_E ) };
+}
+
+static_assert(make_extraction(2020, 12, 27, 5, 17, 34, 51, 68, 85).year() == 2020 && \
+              make_extraction(2020, 12, 27, 5, 17, 34, 51, 68, 85).ruota() == 5 && \
+              make_extraction(2020, 12, 27, 5, 17, 34, 51, 68, 85).e() == 85, "record fields");
+static_assert(make_extraction(2020, 1, 3, 0, 90, 90, 90, 90, 90).raw < make_extraction(2020, 1, 3, 1, 1, 1, 1, 1, 1).raw && \
+              make_extraction(2020, 1, 3, 10, 90, 90, 90, 90, 90).raw < make_extraction(2020, 1, 4, 0, 1, 1, 1, 1, 1).raw,
+              "records order by date and ruota");
+
 typedef enum : uint64_t
 {
 	NULL_MESE = 0,
@@ -0,0 +1,36 @@
+// benchmarks of the import phases
+
+#ifndef LOTTO_BENCHMARKS_H
+#define LOTTO_BENCHMARKS_H
+
+#include <cstdint>
+#include <boost/filesystem.hpp>
+
+// runs when no --repeat is given
+#define LOTTO_BENCH_SCANNER_REPEAT    (1000)
+#define LOTTO_BENCH_DECODE_REPEAT     (1000)
+#define LOTTO_BENCH_IMPORT_REPEAT     (5)
+#define LOTTO_BENCH_DAEMON_REPEAT     (10000)
+// requests sent at once in the pipelined runs
+#define LOTTO_BENCH_DAEMON_BATCH      (64)
+
+// time the record scanner against the boost::tokenizer double walk on
+// the records of one year file, each run parses every record repeat times
+int32_t bench_record_scanner(const boost::filesystem::path& year_file, uint32_t repeat);
+
+// time the decoding of the blocks of a compressed file against the
+// decoding of the same records stored as in a db, repeat times each
+int32_t bench_decode_compressed(const boost::filesystem::path& file_z, uint32_t repeat);
+
+// time each phase of an import of the year files from start_year to
+// end_year in the current directory (parse, encode, write, verify),
+// repeat runs, reporting the best and the median run of each phase;
+// cached years are parsed once and read from the parse cache after
+int32_t bench_import(uint32_t start_year, uint32_t end_year, uint32_t jobs, uint32_t repeat, bool cached);
+
+// time the queries of a running daemon, frequency, ritardo and range
+// requests on random year windows: the latency of repeat requests sent
+// one at a time and the throughput of repeat requests pipelined
+int32_t bench_daemon(const boost::filesystem::path& socket_path, uint32_t repeat);
+
+#endif // LOTTO_BENCHMARKS_H
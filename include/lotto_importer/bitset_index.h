@@ -0,0 +1,73 @@
+// per draw bitset index kept next to a db
+//
+// every record of the db becomes two 64 bit words: numbers 1..64 are
+// bits 0..63 of the first, numbers 65..90 bits 0..25 of the second,
+// whose bits 32..35 hold the ruota and bits 36..60 the date as
+// make_date(); membership of an ambo, terno, ... is then an AND and a
+// compare, and a count over the history a scan of the words
+//
+// layout, all integers big endian:
+//   magic "LTBITSET", version (u32), padding (u32), number of
+//   records (u64), db crc32c (u32), padding (u32), then per record
+//   the two words
+
+#ifndef LOTTO_BITSET_INDEX_H
+#define LOTTO_BITSET_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <boost/filesystem.hpp>
+#include "basic_types.h"
+
+#define LOTTO_BITSET_MAGIC         "LTBITSET"
+#define LOTTO_BITSET_VERSION       (1)
+#define LOTTO_BITSET_SUFFIX        ".bits"
+#define LOTTO_BITSET_HEADER_BYTES  (32)
+#define LOTTO_BITSET_ENTRY_BYTES   (16)
+
+#define LOTTO_BITSET_NUMBERS_HI    (0x3FFFFFFULL)
+#define LOTTO_BITSET_SHIFT_RUOTA   (32)
+#define LOTTO_BITSET_SHIFT_DATE    (36)
+
+typedef struct DRAW_BITS
+{
+	uint64_t lo;
+	uint64_t hi;
+} draw_bits_t;
+
+inline void draw_bits_set(draw_bits_t& bits, uint64_t number)
+{
+	if( number >= 1 && number <= 64 )
+	{
+		bits.lo |= 1ULL << (number - 1);
+	}
+	else if( number >= 65 && number <= 90 )
+	{
+		bits.hi |= 1ULL << (number - 65);
+	}
+}
+
+draw_bits_t make_draw_bits(const extraction_t& e);
+
+// draws of each ruota holding all the numbers, the TUTTE entry sums them
+typedef struct COMBO_RESULT
+{
+	uint64_t counts[ruota_t::UNKNOWN];
+	uint32_t last_date[ruota_t::UNKNOWN];  // as make_date(), 0 if never
+} combo_result_t;
+
+// entries as stored in the index; ruota UNKNOWN matches every ruota
+void count_combo(const uint8_t *entries, uint64_t n_entries, const uint32_t *numbers, size_t n_numbers,
+		ruota_t ruota, uint32_t from_date, uint32_t to_date, combo_result_t& result);
+
+boost::filesystem::path bitset_index_path(const boost::filesystem::path& file_db);
+
+// write the index of a db with a scan of its records
+int32_t build_bitset_index(const boost::filesystem::path& file_db);
+
+// count the draws holding all the numbers, the index is rebuilt first
+// when missing or not matching the db
+int32_t query_combo(const boost::filesystem::path& file_db, const uint32_t *numbers, size_t n_numbers,
+		ruota_t ruota, uint32_t from_date, uint32_t to_date, combo_result_t& result);
+
+#endif // LOTTO_BITSET_INDEX_H
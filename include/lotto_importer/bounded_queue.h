@@ -0,0 +1,65 @@
+// blocking queue of bounded capacity connecting pipeline stages
+
+#ifndef LOTTO_BOUNDED_QUEUE_H
+#define LOTTO_BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+template <typename T>
+class bounded_queue_t
+{
+public:
+	explicit bounded_queue_t(size_t capacity) : capacity_(capacity > 0 ? capacity : 1), closed_(false)
+	{
+	}
+
+	bounded_queue_t(const bounded_queue_t&) = delete;
+	bounded_queue_t& operator=(const bounded_queue_t&) = delete;
+
+	// blocks while the queue is full, false when the queue was closed
+	bool push(T item)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		not_full_.wait(lock, [this]{ return closed_ || items_.size() < capacity_; });
+		if( closed_ )
+			return false;
+		items_.push_back(std::move(item));
+		not_empty_.notify_one();
+		return true;
+	}
+
+	// blocks while the queue is empty, false when closed and drained
+	bool pop(T& item)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		not_empty_.wait(lock, [this]{ return closed_ || !items_.empty(); });
+		if( items_.empty() )
+			return false;
+		item = std::move(items_.front());
+		items_.pop_front();
+		not_full_.notify_one();
+		return true;
+	}
+
+	// no more pushes, pending items can still be popped
+	void close()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		closed_ = true;
+		not_empty_.notify_all();
+		not_full_.notify_all();
+	}
+
+private:
+	const size_t            capacity_;
+	bool                    closed_;
+	std::deque<T>           items_;
+	std::mutex              mutex_;
+	std::condition_variable not_empty_;
+	std::condition_variable not_full_;
+};
+
+#endif // LOTTO_BOUNDED_QUEUE_H
@@ -0,0 +1,39 @@
+// pair co-occurrence matrices of the drawn numbers
+
+#ifndef LOTTO_COOCCURRENCE_H
+#define LOTTO_COOCCURRENCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "basic_types.h"
+
+// dates as make_date(year, month, day), both ends included
+typedef struct DATE_WINDOW
+{
+	uint32_t from_date;
+	uint32_t to_date;
+} date_window_t;
+
+// counts[ruota][a][b] draws of the ruota holding both a and b, the
+// matrices are symmetric, the diagonal holds the draws holding a and
+// the TUTTE matrix sums every ruota; row and column 0 are unused
+typedef struct COOCCURRENCE_MATRIX
+{
+	uint32_t counts[ruota_t::UNKNOWN][91][91];
+} cooccurrence_matrix_t;
+
+// one matrix per window, all of them built in a single pass over the
+// records split among jobs threads
+int32_t compute_cooccurrence(const std::vector<extraction_t>& extraction_vec, const std::vector<date_window_t>& windows,
+		uint32_t jobs, std::vector<cooccurrence_matrix_t>& matrices);
+
+// the same over the records of a db
+int32_t query_cooccurrence(const boost::filesystem::path& file_db, const std::vector<date_window_t>& windows,
+		uint32_t jobs, std::vector<cooccurrence_matrix_t>& matrices);
+
+// one line "window,ruota,a,b,count" per pair a < b drawn together
+int32_t save_cooccurrence_csv(const std::vector<cooccurrence_matrix_t>& matrices, const boost::filesystem::path& file_csv);
+
+#endif // LOTTO_COOCCURRENCE_H
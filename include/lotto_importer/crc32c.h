@@ -0,0 +1,13 @@
+// CRC-32C (Castagnoli) checksum
+
+#ifndef LOTTO_CRC32C_H
+#define LOTTO_CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+// extend crc, the checksum of the previous bytes (0 for none), with
+// n more bytes; uses the SSE 4.2 crc32 instruction when available
+uint32_t crc32c_update(uint32_t crc, const uint8_t *data, size_t n);
+
+#endif // LOTTO_CRC32C_H
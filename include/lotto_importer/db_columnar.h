@@ -0,0 +1,58 @@
+// columnar (structure of arrays) export of the extractions
+//
+// layout, all integers big endian:
+//   magic "LTCOLUMN", version (u32), number of columns (u32),
+//   number of records (u64), then one directory entry per column:
+//   column id (u32), element bytes (u32), offset (u64), bytes (u64);
+//   each column is a contiguous array of n records starting at a
+//   64 bytes aligned offset, the year is u16, every other column u8
+
+#ifndef LOTTO_DB_COLUMNAR_H
+#define LOTTO_DB_COLUMNAR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "basic_types.h"
+
+#define LOTTO_COLUMNAR_MAGIC      "LTCOLUMN"
+#define LOTTO_COLUMNAR_VERSION    (1)
+#define LOTTO_COLUMNAR_ALIGN      (64)
+
+typedef enum : uint32_t
+{
+	COL_YEAR = 0,
+	COL_MONTH,
+	COL_DAY,
+	COL_RUOTA,
+	COL_A,
+	COL_B,
+	COL_C,
+	COL_D,
+	COL_E,
+	COL_COUNT,
+} column_t;
+
+typedef struct COLUMN_ENTRY
+{
+	uint32_t id;
+	uint32_t element_bytes;
+	uint64_t offset;
+	uint64_t bytes;
+} column_entry_t;
+
+typedef struct COLUMNAR_DIRECTORY
+{
+	uint32_t       version;
+	uint64_t       n_records;
+	column_entry_t columns[COL_COUNT];  // indexed by column_t
+} columnar_directory_t;
+
+// read and check the directory of a mapped columnar file
+int32_t parse_columnar_directory(const uint8_t *data, uint64_t size, columnar_directory_t& directory);
+
+int32_t save_file_columnar(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_col);
+int32_t verify_file_columnar(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_col);
+
+#endif // LOTTO_DB_COLUMNAR_H
@@ -0,0 +1,67 @@
+// compressed block format of the extractions
+//
+// the records are grouped into independent blocks of whole draws (the
+// records sharing a date), layout, all integers big endian unless noted:
+//   magic "LTBLOCKZ", version (u32), byte order mark (u32), number of
+//   records (u64), number of blocks (u32), CRC-32C of the records as
+//   stored in a db (u32), then one directory entry per block: first
+//   record (u64), offset (u64), bytes (u32), records (u32), first and
+//   last date as make_date() (u32 each), CRC-32C of the block (u32),
+//   padding (u32)
+// a packed block is:
+//   type 0 (u8), padding (u8), draws (u16), records (u16), padding (u16),
+//   date of its first draw (u32), ruota order (u64, 11 nibbles, the
+//   ruota of rank k in bits 4k..4k+3), then per draw the date delta
+//   from the previous draw (LEB128 varint) and the ruote present as a
+//   mask of ranks (u16, little endian), then the five numbers of each
+//   record as a little endian stream of 7 bit fields
+// a draw that can not be packed (a ruota twice, or out of range) goes
+// into a raw block: type 1 (u8), padding, records (u16), then the
+// records as in a db. Version 1 files held them as legacy words
+
+#ifndef LOTTO_DB_COMPRESSED_H
+#define LOTTO_DB_COMPRESSED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "basic_types.h"
+
+#define LOTTO_COMPRESSED_MAGIC          "LTBLOCKZ"
+#define LOTTO_COMPRESSED_VERSION        (2)
+#define LOTTO_COMPRESSED_HEADER_BYTES   (32)
+#define LOTTO_COMPRESSED_ENTRY_BYTES    (40)
+#define LOTTO_COMPRESSED_SUFFIX         "z"
+
+// records per block, blocks end on a draw
+#define LOTTO_COMPRESSED_BLOCK_RECORDS  (4096)
+
+typedef struct COMPRESSED_BLOCK
+{
+	uint64_t first_record;
+	uint64_t offset;
+	uint32_t bytes;
+	uint32_t n_records;
+	uint32_t first_date;
+	uint32_t last_date;
+	uint32_t crc;
+} compressed_block_t;
+
+// unpack n 7 bit fields of a little endian bit stream of src_bytes
+// into one byte each
+void unpack_numbers(const uint8_t *src, size_t src_bytes, size_t n, uint8_t *dst);
+
+// read and check the header and directory of a mapped compressed file
+int32_t parse_compressed_directory(const uint8_t *data, uint64_t size, uint64_t& n_records, uint32_t& records_crc,
+		std::vector<compressed_block_t>& blocks);
+
+// decode the records of one block into its n_records entries of dst
+int32_t decode_compressed_block(const uint8_t *block, const compressed_block_t& entry, extraction_t *dst);
+
+int32_t save_file_compressed(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_z);
+// every block is checked against its checksum
+int32_t load_file_compressed(const boost::filesystem::path& file_z, std::vector<extraction_t>& extraction_vec);
+int32_t verify_file_compressed(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_z);
+
+#endif // LOTTO_DB_COMPRESSED_H
@@ -0,0 +1,177 @@
+// reading and writing whole db files: a reader mapping the file and
+// handing out the records as decoded views, with no copy of the data
+
+#ifndef LOTTO_DB_FILE_H
+#define LOTTO_DB_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "basic_types.h"
+#include "db_io.h"
+#include "mapped_file.h"
+
+// the record at src of a db, legacy for the versions before 3
+inline extraction_t decode_stored_record(const uint8_t *src, bool legacy)
+{
+	return legacy ? decode_legacy_record(src) : decode_record(src);
+}
+
+// random access range over records stored in a mapped db, each record
+// is decoded when accessed, legacy records into the current layout;
+// valid while its db_reader_t is open
+class db_range_t
+{
+public:
+	class iterator
+	{
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef extraction_t                    value_type;
+		typedef std::ptrdiff_t                  difference_type;
+		typedef void                            pointer;
+		typedef extraction_t                    reference;
+
+		iterator() : record_(NULL), legacy_(false) {}
+		iterator(const uint8_t *record, bool legacy) : record_(record), legacy_(legacy) {}
+
+		extraction_t operator*() const { return decode_stored_record(record_, legacy_); }
+		extraction_t operator[](difference_type n) const { return decode_stored_record(record_ + n * LOTTO_RECORD_BYTES, legacy_); }
+
+		iterator& operator++() { record_ += LOTTO_RECORD_BYTES; return *this; }
+		iterator operator++(int) { iterator it(*this); ++*this; return it; }
+		iterator& operator--() { record_ -= LOTTO_RECORD_BYTES; return *this; }
+		iterator operator--(int) { iterator it(*this); --*this; return it; }
+		iterator& operator+=(difference_type n) { record_ += n * LOTTO_RECORD_BYTES; return *this; }
+		iterator& operator-=(difference_type n) { record_ -= n * LOTTO_RECORD_BYTES; return *this; }
+		iterator operator+(difference_type n) const { return iterator(record_ + n * LOTTO_RECORD_BYTES, legacy_); }
+		iterator operator-(difference_type n) const { return iterator(record_ - n * LOTTO_RECORD_BYTES, legacy_); }
+		difference_type operator-(const iterator& other) const { return (record_ - other.record_) / LOTTO_RECORD_BYTES; }
+
+		bool operator==(const iterator& other) const { return record_ == other.record_; }
+		bool operator!=(const iterator& other) const { return record_ != other.record_; }
+		bool operator<(const iterator& other) const { return record_ < other.record_; }
+		bool operator>(const iterator& other) const { return record_ > other.record_; }
+		bool operator<=(const iterator& other) const { return record_ <= other.record_; }
+		bool operator>=(const iterator& other) const { return record_ >= other.record_; }
+
+	private:
+		const uint8_t *record_;
+		bool           legacy_;
+	};
+
+	db_range_t() : records_(NULL), first_record_(0), size_(0), legacy_(false) {}
+	db_range_t(const uint8_t *records, uint64_t first_record, uint64_t size, bool legacy) :
+		records_(records), first_record_(first_record), size_(size), legacy_(legacy) {}
+
+	uint64_t size() const { return size_; }
+	bool empty() const { return 0 == size_; }
+	// position in the db of the first record of the range
+	uint64_t first_record() const { return first_record_; }
+	// the records as stored, LOTTO_RECORD_BYTES each
+	const uint8_t *bytes() const { return records_; }
+	// stored as legacy words, by a db before version 3
+	bool legacy() const { return legacy_; }
+
+	extraction_t operator[](uint64_t i) const { return decode_stored_record(records_ + i * LOTTO_RECORD_BYTES, legacy_); }
+	extraction_t front() const { return (*this)[0]; }
+	extraction_t back() const { return (*this)[size_ - 1]; }
+	iterator begin() const { return iterator(records_, legacy_); }
+	iterator end() const { return iterator(records_ + size_ * LOTTO_RECORD_BYTES, legacy_); }
+
+	// records [offset, offset + count) of the range
+	db_range_t subrange(uint64_t offset, uint64_t count) const
+	{
+		return db_range_t(records_ + offset * LOTTO_RECORD_BYTES, first_record_ + offset, count, legacy_);
+	}
+	// bulk decoding of n records from offset, faster than one at a time
+	void decode(uint64_t offset, size_t n, extraction_t *dst) const
+	{
+		if( legacy_ )
+			decode_legacy_records(records_ + offset * LOTTO_RECORD_BYTES, n, dst);
+		else
+			decode_records(records_ + offset * LOTTO_RECORD_BYTES, n, dst);
+	}
+	// n records from offset as encode_records() gives them, legacy
+	// records are converted
+	void encode(uint64_t offset, size_t n, uint8_t *dst) const
+	{
+		if( !legacy_ )
+		{
+			std::memcpy(dst, records_ + offset * LOTTO_RECORD_BYTES, n * LOTTO_RECORD_BYTES);
+			return;
+		}
+		for( size_t i = 0; i < n; i++ )
+		{
+			store_be(dst + i * LOTTO_RECORD_BYTES, (*this)[offset + i].raw, LOTTO_RECORD_BYTES);
+		}
+	}
+
+private:
+	const uint8_t *records_;
+	uint64_t       first_record_;
+	uint64_t       size_;
+	bool           legacy_;
+};
+
+// read-only db of any version, mapped whole
+class db_reader_t
+{
+public:
+	db_reader_t();
+
+	db_reader_t(const db_reader_t&) = delete;
+	db_reader_t& operator=(const db_reader_t&) = delete;
+
+	// map and check the layout of a db, returns 0 on success, -1 on error
+	int32_t open(const char *filename);
+	void close();
+
+	bool is_open() const { return file_.is_open(); }
+	const db_layout_t& layout() const { return layout_; }
+	uint64_t size() const { return layout_.n_records; }
+	// image of the whole file
+	const uint8_t *data() const { return (const uint8_t *) file_.data(); }
+
+	db_range_t records() const
+	{
+		return db_range_t(data() + layout_.records_offset, 0, layout_.n_records, layout_.version < LOTTO_DB_SORTED_VERSION);
+	}
+	// the records dated from_date to to_date, as make_date()
+	db_range_t range(uint32_t from_date, uint32_t to_date) const;
+	// the records are in date order, so that a date range is contiguous:
+	// a db with a header has a month index unless they are not, a db
+	// without one was written in the order of the year files
+	bool date_ordered() const { return NULL != layout_.months || 0 == layout_.n_records || 0 == layout_.records_offset; }
+	extraction_t operator[](uint64_t i) const { return records()[i]; }
+
+	// CRC-32C of the records, -1 without a trailer or when it does not
+	// match the one in the trailer
+	int32_t verify(uint32_t& crc) const;
+
+private:
+	mapped_file_t file_;
+	db_layout_t   layout_;
+	std::string   filename_;
+};
+
+int32_t save_file_db(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_db);
+// the records of the last date in the db, at most one per ruota; -1 when
+// the records are not in date order
+int32_t read_last_draw(const boost::filesystem::path& file_db, std::vector<extraction_t>& last_draw, uint64_t& n_records, uint32_t& version);
+// the first n_records records of a db
+int32_t read_file_db(const boost::filesystem::path& file_db, std::vector<extraction_t>& extraction_vec, uint64_t n_records);
+// the records of a db from first_record on against extraction_vec, then its checksum
+int32_t verify_file_db(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_db, uint64_t first_record);
+int32_t verify_file_db_checksum(const boost::filesystem::path& file_db, uint64_t& n_records, uint32_t& crc);
+void print_extraction(const char *title, const extraction_t& e);
+// rewrite a db of any version as a current one, the legacy records of
+// the older versions reordered as the current encoding sorts them;
+// file_to must not exist, unless it is file_from rewritten in place
+int32_t convert_file_db(const boost::filesystem::path& file_from, const boost::filesystem::path& file_to);
+
+#endif // LOTTO_DB_FILE_H
@@ -0,0 +1,239 @@
+// binary db encoding and buffered writing
+
+#ifndef LOTTO_DB_IO_H
+#define LOTTO_DB_IO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "basic_types.h"
+
+// size of one record in the db file
+#define LOTTO_RECORD_BYTES    (8)
+
+// big endian integers of n_bytes
+inline void store_be(uint8_t *dst, uint64_t value, size_t n_bytes)
+{
+	for( size_t i = 0; i < n_bytes; i++ )
+	{
+		dst[i] = (uint8_t) ( value >> (8 * (n_bytes - 1 - i)) );
+	}
+}
+
+inline uint64_t load_be(const uint8_t *src, size_t n_bytes)
+{
+	uint64_t value = 0;
+	for( size_t i = 0; i < n_bytes; i++ )
+	{
+		value = (value << 8) | src[i];
+	}
+	return value;
+}
+
+// records are stored as big endian 64 bit words, n records of src are
+// encoded into 8 * n bytes of dst and back
+void encode_records(const extraction_t *src, size_t n, uint8_t *dst);
+void decode_records(const uint8_t *src, size_t n, extraction_t *dst);
+
+// one record, for random access
+inline extraction_t decode_record(const uint8_t *src)
+{
+	return extraction_t{ load_be(src, LOTTO_RECORD_BYTES) };
+}
+
+// the dbs before version 3 hold the words of the former bitfield record,
+// as GCC laid it out on the little endian hosts that wrote them: ruota
+// from bit 0, a to e from bit 4, then the date from bit 39 as now
+#define LOTTO_LEGACY_SHIFT_RUOTA    (0)
+#define LOTTO_LEGACY_SHIFT_A        (4)
+#define LOTTO_LEGACY_SHIFT_B        (11)
+#define LOTTO_LEGACY_SHIFT_C        (18)
+#define LOTTO_LEGACY_SHIFT_D        (25)
+#define LOTTO_LEGACY_SHIFT_E        (32)
+
+constexpr extraction_t extraction_from_legacy(uint64_t word)
+{
+	return extraction_t{ ( word & ~(((uint64_t) 1 << LOTTO_SHIFT_DATE) - 1) ) | \
+	                     ( ((word >> LOTTO_LEGACY_SHIFT_RUOTA) & LOTTO_MASK_RUOTA) << LOTTO_SHIFT_RUOTA ) | \
+	                     ( ((word >> LOTTO_LEGACY_SHIFT_A) & LOTTO_MASK_NUMBER) << LOTTO_SHIFT_A ) | \
+	                     ( ((word >> LOTTO_LEGACY_SHIFT_B) & LOTTO_MASK_NUMBER) << LOTTO_SHIFT_B ) | \
+	                     ( ((word >> LOTTO_LEGACY_SHIFT_C) & LOTTO_MASK_NUMBER) << LOTTO_SHIFT_C ) | \
+	                     ( ((word >> LOTTO_LEGACY_SHIFT_D) & LOTTO_MASK_NUMBER) << LOTTO_SHIFT_D ) | \
+	                     ( ((word >> LOTTO_LEGACY_SHIFT_E) & LOTTO_MASK_NUMBER) << LOTTO_SHIFT_E ) };
+}
+
+static_assert(extraction_from_legacy(0x07E4CDD5B3088A25ull).raw == make_extraction(2020, 12, 27, 5, 34, 17, 66, 89, 85).raw, \
+              "legacy record layout");
+
+inline extraction_t decode_legacy_record(const uint8_t *src)
+{
+	return extraction_from_legacy(load_be(src, LOTTO_RECORD_BYTES));
+}
+
+void decode_legacy_records(const uint8_t *src, size_t n, extraction_t *dst);
+
+// a db file is, all integers big endian:
+//   header | records | month index | trailer
+// the header is self describing and points to the month index, one
+// entry per year and month present giving its first record, so that a
+// date range is found with a binary search; the trailer holds the
+// number of records, the CRC-32C of the record bytes and a magic.
+// Files written before the header have no header and no index
+// (version 1), or are a bare record stream (version 0); the records of
+// versions 0 to 2 are legacy words, decoded with extraction_from_legacy()
+#define LOTTO_DB_MAGIC         "LOTTO_DB"
+#define LOTTO_DB_VERSION       (3)
+// first version with the records of extraction_t, sorted as raw words
+#define LOTTO_DB_SORTED_VERSION    (3)
+#define LOTTO_DB_BYTE_ORDER    (0x01020304)
+#define LOTTO_HEADER_BYTES     (64)
+#define LOTTO_MONTH_BYTES      (16)
+#define LOTTO_TRAILER_BYTES    (16)
+#define LOTTO_TRAILER_MAGIC    "LTCK"
+
+// header layout:
+//   magic "LOTTO_DB", version (u32), byte order mark (u32), header
+//   bytes (u32), record bytes (u32), number of records (u64), first
+//   and last date as make_date() (u32 each), month index offset (u64),
+//   month index entries (u32), CRC-32C of the month index (u32),
+//   CRC-32C of the header bytes before it (u32), reserved (u32)
+typedef struct DB_HEADER
+{
+	uint32_t version;
+	uint64_t n_records;
+	uint32_t first_date;
+	uint32_t last_date;
+	uint64_t index_offset;
+	uint32_t n_months;
+	uint32_t index_crc;
+} db_header_t;
+
+void encode_header(const db_header_t& header, uint8_t *dst);
+// -1 when the magic, byte order, sizes or checksum do not match
+int32_t decode_header(const uint8_t *src, db_header_t& header);
+
+// month index entry: year << 4 | month (u32), records in the month
+// (u32), first record of the month (u64)
+typedef struct DB_MONTH
+{
+	uint32_t key;
+	uint32_t n_records;
+	uint64_t first_record;
+} db_month_t;
+
+inline uint32_t make_month_key(uint32_t date)
+{
+	return date >> 5;
+}
+
+// date of a record as stored, without decoding it
+inline uint32_t stored_record_date(const uint8_t *record)
+{
+	return (uint32_t) ( load_be(record, 4) >> 7 );
+}
+
+typedef struct DB_TRAILER
+{
+	uint64_t n_records;
+	uint32_t crc;
+} db_trailer_t;
+
+void encode_trailer(const db_trailer_t& trailer, uint8_t *dst);
+// false when the magic is missing
+bool decode_trailer(const uint8_t *src, db_trailer_t& trailer);
+
+typedef struct DB_LAYOUT
+{
+	uint32_t       version;         // 0 to LOTTO_DB_VERSION
+	uint64_t       records_offset;  // of the first record in the file
+	uint64_t       n_records;
+	bool           has_trailer;     // false for a bare record stream
+	uint32_t       crc;             // from the trailer
+	uint32_t       first_date;      // from the header, 0 without one
+	uint32_t       last_date;
+	const uint8_t *months;          // month index in the image, NULL without one
+	uint32_t       n_months;
+} db_layout_t;
+
+// locate the records in the image of a db file from its header, or for
+// older files from the trailer alone or the file size; the header and
+// month index are checked, the records are not; -1 when inconsistent
+int32_t parse_db_layout(const uint8_t *data, uint64_t size, db_layout_t& layout);
+
+// records [first, end) of the db dated from_date to to_date, found
+// with the month index and a short scan of the boundary months; none
+// when from_date is after to_date, the whole db without an index, for
+// the caller to filter by date
+void locate_date_range(const uint8_t *data, const db_layout_t& layout, uint32_t from_date, uint32_t to_date,
+		uint64_t& first, uint64_t& end);
+
+// buffered writer of a db file: data is gathered in a large aligned
+// buffer and written in big chunks to a temporary file next to the
+// destination, which replaces the destination only on commit; in
+// append mode the bytes of the existing file before an offset are
+// copied to the temporary file first and data goes on after them.
+// The destination is never written in place: a reader mapping it, as
+// the query daemon does, keeps the whole file it mapped.
+// Opened with open_db() or open_db_append() it writes the db format:
+// the header is reserved up front and filled in on commit, the month
+// index is collected from the records as they go through
+class db_file_writer_t
+{
+public:
+	db_file_writer_t();
+	~db_file_writer_t();
+
+	db_file_writer_t(const db_file_writer_t&) = delete;
+	db_file_writer_t& operator=(const db_file_writer_t&) = delete;
+
+	// expected_bytes is preallocated when known, 0 otherwise
+	int32_t open(const char *filename, uint64_t expected_bytes);
+	int32_t open_append(const char *filename, uint64_t offset);
+	// a new db, expected_records is preallocated when known, 0 otherwise
+	int32_t open_db(const char *filename, uint64_t expected_records);
+	// an existing db of the current version, records are written from first_record on
+	int32_t open_db_append(const char *filename, uint64_t first_record);
+	int32_t write_records(const extraction_t *records, size_t n);
+	// records already encoded by encode_records()
+	int32_t write_encoded_records(const uint8_t *bytes, size_t n);
+	int32_t write_bytes(const void *data, size_t n);
+	// close the record stream with the month index and the trailer
+	int32_t write_trailer();
+	// flush, sync and rename the temporary file over the destination
+	int32_t commit();
+	// drop the temporary file, the destination is left untouched
+	void abort();
+
+	// offset in the file of the next write
+	uint64_t offset() const { return bytes_written_ + buffer_used_; }
+	// CRC-32C of the file bytes before offset(), of the records only
+	// for a db
+	uint32_t crc() const { return crc_; }
+
+private:
+	int32_t copy_prefix(uint64_t offset, uint64_t checksum_from, bool records);
+	void add_record_date(uint32_t date);
+	int32_t buffer_bytes(const void *data, size_t n);
+	int32_t flush();
+
+	int         fd_;
+	uint8_t    *buffer_;
+	size_t      buffer_used_;
+	uint64_t    bytes_written_;
+	uint32_t    crc_;
+	std::string filename_;
+	std::string tmp_filename_;
+
+	// db format state
+	bool                    db_;
+	uint64_t                n_records_;
+	uint32_t                first_date_;
+	uint32_t                last_date_;
+	bool                    months_sorted_;
+	std::vector<db_month_t> months_;
+	bool                    header_pending_;
+	uint8_t                 header_[LOTTO_HEADER_BYTES];
+};
+
+#endif // LOTTO_DB_IO_H
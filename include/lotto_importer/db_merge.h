@@ -0,0 +1,40 @@
+// merge of db files: the records of N dbs are merged in one pass, in the
+// order of their key (date and ruota), into a single db
+//
+// a db whose records are not in key order, one written before version 3
+// or by hand, is first sorted externally: it is cut in runs of at most
+// LOTTO_MERGE_RUN_RECORDS, each sorted and written next to the output,
+// and the runs join the merge as inputs of their own. The memory used is
+// bounded by the runs and the decode buffers, whatever the size of the
+// dbs. Records with the same key are duplicates: the same record found
+// twice is kept once, different ones are settled by the policy
+
+#ifndef LOTTO_DB_MERGE_H
+#define LOTTO_DB_MERGE_H
+
+#include <cstdint>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "import_stats.h"
+
+// records sorted in memory at a time for an unsorted db
+#define LOTTO_MERGE_RUN_RECORDS       (1 << 20)
+// records decoded at a time from each input
+#define LOTTO_MERGE_BUFFER_RECORDS    (4096)
+// run files, next to the output, removed once mapped
+#define LOTTO_MERGE_RUN_SUFFIX        ".run"
+
+typedef enum : uint32_t
+{
+	MERGE_FAIL = 0,    // different records with the same key are an error
+	MERGE_KEEP_FIRST,  // the record of the first db given wins
+	MERGE_KEEP_LAST,   // the record of the last db given wins, as a reprint
+} merge_policy_t;
+
+// merge the dbs of any version into file_out, written as a current db
+// with its indexes; file_out must not exist. Within one db the later of
+// two records wins for MERGE_KEEP_LAST
+int32_t merge_file_dbs(const std::vector<boost::filesystem::path>& files_in, const boost::filesystem::path& file_out,
+		merge_policy_t policy, import_stats_t& stats);
+
+#endif // LOTTO_DB_MERGE_H
@@ -0,0 +1,27 @@
+// frequency queries over the records of a db file
+
+#ifndef LOTTO_DB_QUERY_H
+#define LOTTO_DB_QUERY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <boost/filesystem.hpp>
+#include "basic_types.h"
+#include "db_file.h"
+
+// numbers drawn on each ruota, counts[ruota][number] for numbers 1..90,
+// the TUTTE row sums every ruota
+typedef struct FREQUENCY_TABLE
+{
+	uint32_t counts[ruota_t::UNKNOWN][91];
+	uint64_t n_records;  // records within the date range
+} frequency_table_t;
+
+// dates as make_date(year, month, day), both ends included; the records
+// of the range are read in place, in the layout of their db version
+void compute_frequencies(const db_range_t& range, uint32_t from_date, uint32_t to_date, frequency_table_t& table);
+
+// map the db and compute its frequencies
+int32_t query_frequencies(const boost::filesystem::path& file_db, uint32_t from_date, uint32_t to_date, frequency_table_t& table);
+
+#endif // LOTTO_DB_QUERY_H
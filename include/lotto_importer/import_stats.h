@@ -0,0 +1,72 @@
+// per-phase instrumentation of the import: wall and CPU time, bytes
+// read and written, records per second, allocations and peak RSS
+//
+// bytes are counted where the files are touched (a mapped file counts
+// whole as read, a db_file_writer_t counts what it writes) and the
+// allocations by the global operator new, all with relaxed atomics
+
+#ifndef LOTTO_IMPORT_STATS_H
+#define LOTTO_IMPORT_STATS_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+typedef enum : uint32_t
+{
+	STATS_NONE = 0,
+	STATS_TEXT,
+	STATS_JSON,
+} stats_format_t;
+
+// process counters at one point in time
+typedef struct STATS_SAMPLE
+{
+	uint64_t wall_ns;
+	uint64_t cpu_ns;           // of all the threads of the process
+	uint64_t bytes_read;
+	uint64_t bytes_written;
+	uint64_t allocations;
+	uint64_t allocated_bytes;
+} stats_sample_t;
+
+typedef struct PHASE_STATS
+{
+	std::string name;
+	uint64_t    wall_ns;
+	uint64_t    cpu_ns;
+	uint64_t    records;
+	uint64_t    bytes_read;
+	uint64_t    bytes_written;
+	uint64_t    allocations;
+	uint64_t    allocated_bytes;
+	uint64_t    peak_rss_kb;       // of the process at the end of the phase
+} phase_stats_t;
+
+void stats_add_bytes_read(uint64_t n);
+void stats_add_bytes_written(uint64_t n);
+stats_sample_t stats_sample();
+uint64_t stats_peak_rss_kb();
+
+// phases are timed one after the other, begin() closes nothing: every
+// begin() is followed by its end()
+class import_stats_t
+{
+public:
+	import_stats_t();
+
+	void begin(const char *name);
+	void end(uint64_t records);
+
+	const std::vector<phase_stats_t>& phases() const { return phases_; }
+	void print(stats_format_t format, std::ostream& out) const;
+
+private:
+	std::vector<phase_stats_t> phases_;
+	stats_sample_t             start_;
+	stats_sample_t             phase_start_;
+	std::string                phase_name_;
+};
+
+#endif // LOTTO_IMPORT_STATS_H
@@ -0,0 +1,91 @@
+// asynchronous, level filtered logging of the diagnostics
+//
+// the level is checked before anything is formatted, a line that passes
+// is formatted on the stack of the caller and queued in a lock-free ring
+// of fixed slots; a background thread writes the queued lines to stdout
+// in batches, so a caller never waits on the terminal or the journal.
+// Results still go to std::cout, after a log_flush() keeping them in
+// order with the lines queued before
+//
+//   LOTTO_LOG(LOG_INFO) << "records: " << n;
+
+#ifndef LOTTO_LOGGER_H
+#define LOTTO_LOGGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <ostream>
+#include <streambuf>
+
+// longest line, a longer one is cut
+#define LOTTO_LOG_LINE_BYTES    (512)
+// lines waiting to be written, a power of 2; a full ring makes the
+// callers wait, lines are never dropped
+#define LOTTO_LOG_RING_SLOTS    (1024)
+
+typedef enum : int32_t
+{
+	LOG_SILENT = 0,  // as a threshold only, nothing is written
+	LOG_ERROR,
+	LOG_WARN,
+	LOG_INFO,
+	LOG_DEBUG,
+} log_level_t;
+
+extern std::atomic<int32_t> log_threshold;
+
+inline bool log_enabled(log_level_t level)
+{
+	return (int32_t) level <= log_threshold.load(std::memory_order_relaxed);
+}
+
+// the lines of level up to threshold are written, LOG_INFO by default
+void log_set_level(log_level_t threshold);
+log_level_t log_get_level();
+
+// wait until every line queued so far is written and stdout flushed
+void log_flush();
+
+// a line being formatted, queued when it goes out of scope
+class log_line_t
+{
+public:
+	log_line_t() : stream_(&buf_) {}
+	~log_line_t();
+
+	log_line_t(const log_line_t&) = delete;
+	log_line_t& operator=(const log_line_t&) = delete;
+
+	std::ostream& stream() { return stream_; }
+
+private:
+	// fixed buffer on the stack, what does not fit is dropped
+	class line_buf_t : public std::streambuf
+	{
+	public:
+		line_buf_t() { setp(text_, text_ + sizeof(text_) - 1); }
+		const char *text() const { return text_; }
+		size_t size() const { return (size_t) (pptr() - pbase()); }
+		// ends the line, the byte for the newline is kept out of the put area
+		size_t end_line() { text_[size()] = '\n'; return size() + 1; }
+	protected:
+		int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+	private:
+		char text_[LOTTO_LOG_LINE_BYTES];
+	};
+
+	line_buf_t   buf_;
+	std::ostream stream_;
+};
+
+// turns the stream expression into void for the conditional of LOTTO_LOG
+struct log_voidify_t
+{
+	void operator&(std::ostream&) {}
+};
+
+#define LOTTO_LOG(level) \
+	!log_enabled(level) ? (void) 0 : log_voidify_t() & log_line_t().stream()
+
+#endif // LOTTO_LOGGER_H
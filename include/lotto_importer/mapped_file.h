@@ -0,0 +1,34 @@
+// read-only memory mapped file
+
+#ifndef LOTTO_MAPPED_FILE_H
+#define LOTTO_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+class mapped_file_t
+{
+public:
+	mapped_file_t();
+	~mapped_file_t();
+
+	mapped_file_t(const mapped_file_t&) = delete;
+	mapped_file_t& operator=(const mapped_file_t&) = delete;
+
+	// map the whole file read-only, returns 0 on success, -1 on error
+	int32_t open(const char *filename);
+	void close();
+
+	bool is_open() const { return is_open_; }
+	const char *data() const { return data_; }
+	size_t size() const { return size_; }
+	std::string_view view() const { return std::string_view(data_, size_); }
+
+private:
+	const char *data_;
+	size_t      size_;
+	bool        is_open_;
+};
+
+#endif // LOTTO_MAPPED_FILE_H
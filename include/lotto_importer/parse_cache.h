@@ -0,0 +1,36 @@
+// parse cache of the year files
+//
+// the records parsed from a year file are kept in a cache file, one per
+// year, tied to the size and CRC-32C of the text they were parsed from;
+// a year file with the same contents is then read back from the cache
+// instead of being parsed again
+//
+// layout, all integers big endian:
+//   magic "LTPCACHE", version (u32), year (u32), text bytes (u64),
+//   CRC-32C of the text (u32), CRC-32C of the records (u32), number of
+//   records (u64), CRC-32C of the header bytes before it (u32),
+//   reserved (u32), then the records as stored in a db
+
+#ifndef LOTTO_PARSE_CACHE_H
+#define LOTTO_PARSE_CACHE_H
+
+#include <cstdint>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "basic_types.h"
+
+#define LOTTO_PARSE_CACHE_MAGIC      "LTPCACHE"
+// to be raised whenever the parser changes the records it produces
+#define LOTTO_PARSE_CACHE_VERSION    (2)
+#define LOTTO_PARSE_CACHE_HEADER     (48)
+// in the current directory, next to the year files
+#define LOTTO_PARSE_CACHE_DIR        ".lotto_cache"
+
+boost::filesystem::path parse_cache_path(uint32_t year);
+
+// as process_file(), the records come from the cache when it matches
+// the year file and the cache is written after a parse otherwise; a
+// cache that can not be written is reported and the parse kept
+int32_t process_file_cached(std::vector<extraction_t>& extraction_vec, uint32_t year);
+
+#endif // LOTTO_PARSE_CACHE_H
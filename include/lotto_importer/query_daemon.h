@@ -0,0 +1,83 @@
+// resident query daemon: a db mapped once with its indexes kept hot,
+// answering over a local Unix domain socket
+//
+// the protocol is a stream of fixed size requests, all integers big
+// endian as in the db:
+//   op (u8), ruota (u8), padding (u16), from date (u32), to date (u32),
+//   limit (u32)
+// each answered in order with status (u32), payload bytes (u32) and the
+// payload:
+//   QUERY_INFO       generation (u32), db version (u32), records (u64),
+//                    crc32c (u32), first and last date (u32 each),
+//                    padding (u32)
+//   QUERY_FREQUENCY  records in the date range (u64), then how many
+//                    times each number 1..90 was drawn on the ruota
+//                    (u32 each), TUTTE sums every ruota
+//   QUERY_RITARDO    draws of the ruota (u32), date of its last draw
+//                    (u32), then for each number 1..90 the current and
+//                    the maximum delay (u32 each)
+//   QUERY_RANGE      records in the date range (u64), records returned
+//                    (u32), padding (u32), then up to limit records of
+//                    the range as stored in a current db, those of an
+//                    older db converted
+// dates are make_date() values, both ends included; requests may be
+// pipelined and are answered in batches. The db is reloaded, and the
+// generation increased, when the file is replaced or rewritten
+
+#ifndef LOTTO_QUERY_DAEMON_H
+#define LOTTO_QUERY_DAEMON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "basic_types.h"
+
+#define LOTTO_DAEMON_REQUEST_BYTES     (16)
+#define LOTTO_DAEMON_REPLY_BYTES       (8)
+// records returned at most by a range query
+#define LOTTO_DAEMON_MAX_RANGE         (65536)
+// records per block of the frequency prefix sums
+#define LOTTO_DAEMON_PREFIX_RECORDS    (2048)
+// socket next to the db when none is given
+#define LOTTO_DAEMON_SOCKET_SUFFIX     ".sock"
+// how often the db file is checked for a new version
+#define LOTTO_DAEMON_RELOAD_MS         (100)
+
+typedef enum : uint8_t
+{
+	QUERY_INFO = 0,
+	QUERY_FREQUENCY,
+	QUERY_RITARDO,
+	QUERY_RANGE,
+} query_op_t;
+
+typedef enum : uint32_t
+{
+	REPLY_OK = 0,
+	REPLY_BAD_REQUEST,
+} reply_status_t;
+
+typedef struct DAEMON_REQUEST
+{
+	query_op_t op;
+	ruota_t    ruota;
+	uint32_t   from_date;
+	uint32_t   to_date;
+	uint32_t   limit;
+} daemon_request_t;
+
+void encode_request(const daemon_request_t& request, uint8_t *dst);
+void decode_request(const uint8_t *src, daemon_request_t& request);
+
+// serve the db until SIGINT or SIGTERM
+int32_t serve_db(const boost::filesystem::path& file_db, const boost::filesystem::path& socket_path);
+
+// client side, a connected socket or -1
+int daemon_connect(const boost::filesystem::path& socket_path);
+// send the requests at once and read their replies, the payloads are
+// appended to payload with their offsets and statuses
+int32_t daemon_query(int fd, const daemon_request_t *requests, size_t n, std::vector<uint32_t>& statuses,
+		std::vector<size_t>& offsets, std::vector<uint8_t>& payload);
+
+#endif // LOTTO_QUERY_DAEMON_H
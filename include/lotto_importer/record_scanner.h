@@ -0,0 +1,40 @@
+// single pass scanner for the year file records
+
+#ifndef LOTTO_RECORD_SCANNER_H
+#define LOTTO_RECORD_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "basic_types.h"
+
+// maximum number of ruote in a year file header
+#define LOTTO_MAX_RUOTE    (12)
+
+typedef enum : int32_t
+{
+	SCAN_OK = 0,
+	SCAN_END,
+	SCAN_ILL_FORMED,
+	SCAN_BAD_DAY,
+	SCAN_BAD_MONTH,
+	SCAN_BAD_NUMBER,
+} scan_status_t;
+
+typedef struct RECORD
+{
+	uint64_t         day;
+	mese_t           month;
+	uint64_t         numbers[5 * LOTTO_MAX_RUOTE];  // 0 stands for "--"
+	size_t           tok_size;                      // tokens found in the line
+	std::string_view bad_token;                     // first invalid token
+	uint64_t         bad_value;                     // and its decoded value
+} record_t;
+
+// scan a record line "DD MMM NN NN NN NN NN ... X" holding five numbers
+// for each of the n_ruote ruote in one forward pass, the trailing token
+// is counted and ignored; decoding errors are reported only when the
+// field count is right, as the header dictates
+scan_status_t scan_record(std::string_view line, size_t n_ruote, record_t& record);
+
+#endif // LOTTO_RECORD_SCANNER_H
@@ -0,0 +1,71 @@
+// ritardo (delay) index kept next to a db
+//
+// for every ruota and number the index holds the draw of the ruota in
+// which the number last came out and the longest delay closed so far,
+// so that current and maximum delays are lookups instead of scans of
+// the whole history; it is updated with the records as they are
+// written and tied to the db by its number of records and checksum
+//
+// layout, all integers big endian:
+//   magic "LTRITARD", version (u32), number of ruote (u32),
+//   db records (u64), db crc32c (u32), padding (u32), then per ruota
+//   the draws of the ruota (u32) and the date of its last draw (u32),
+//   then per ruota and number 1..90 the draw it was last seen in (u32,
+//   0 = never) and its maximum delay (u32)
+
+#ifndef LOTTO_RITARDO_INDEX_H
+#define LOTTO_RITARDO_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <boost/filesystem.hpp>
+#include "basic_types.h"
+
+#define LOTTO_RITARDO_MAGIC      "LTRITARD"
+#define LOTTO_RITARDO_VERSION    (1)
+#define LOTTO_RITARDO_SUFFIX     ".rit"
+
+typedef struct RITARDO_ENTRY
+{
+	uint32_t last_seen;  // draw of the ruota, counted from 1
+	uint32_t max_delay;  // longest run of draws without the number, closed
+} ritardo_entry_t;
+
+typedef struct RITARDO_INDEX
+{
+	uint64_t        db_records;
+	uint32_t        db_crc;
+	uint32_t        draws[ruota_t::TUTTE];
+	uint32_t        last_date[ruota_t::TUTTE];  // as make_date()
+	ritardo_entry_t entries[ruota_t::TUTTE][91];
+} ritardo_index_t;
+
+void ritardo_reset(ritardo_index_t& index);
+// records in date order; a record of a ruota not newer than the last
+// draw indexed for it is already counted and is skipped
+void ritardo_update(ritardo_index_t& index, const extraction_t *records, size_t n);
+
+// draws of the ruota since the number last came out
+inline uint32_t ritardo_current(const ritardo_index_t& index, ruota_t ruota, uint32_t number)
+{
+	return index.draws[ruota] - index.entries[ruota][number].last_seen;
+}
+
+// longest delay of the number on the ruota, the current one included
+inline uint32_t ritardo_max(const ritardo_index_t& index, ruota_t ruota, uint32_t number)
+{
+	const uint32_t current = ritardo_current(index, ruota, number);
+	return ( current > index.entries[ruota][number].max_delay ) ? current : index.entries[ruota][number].max_delay;
+}
+
+boost::filesystem::path ritardo_index_path(const boost::filesystem::path& file_db);
+
+int32_t save_ritardo_index(const ritardo_index_t& index, const boost::filesystem::path& file_rit);
+int32_t load_ritardo_index(const boost::filesystem::path& file_rit, ritardo_index_t& index);
+
+// load the index of a db, -1 when missing or not matching the db
+int32_t load_current_ritardo_index(const boost::filesystem::path& file_db, ritardo_index_t& index);
+// rebuild the index with a scan of the whole db and save it
+int32_t build_ritardo_index(const boost::filesystem::path& file_db, ritardo_index_t& index);
+
+#endif // LOTTO_RITARDO_INDEX_H
@@ -1,19 +1,173 @@
+// conversions between names and ruota_t / mese_t, header only and
+// free of allocations: lookups are constexpr and case insensitive
 
 #ifndef LOTTO_UTILITIES_H
 #define LOTTO_UTILITIES_H
 
-#include <string>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 #include "basic_types.h"
 
-std::string convert_ruota_to_string(ruota_t ruota);
+// names indexed by ruota_t
+inline constexpr std::string_view ruota_names[] =
+{
+	"NAZIONALE",
+	"BARI",
+	"CAGLIARI",
+	"FIRENZE",
+	"GENOVA",
+	"MILANO",
+	"NAPOLI",
+	"PALERMO",
+	"ROMA",
+	"TORINO",
+	"VENEZIA",
+	"TUTTE",
+	"UNKNOWN",
+};
 
-std::string my_str_toupper(std::string s);
+// names indexed by mese_t
+inline constexpr std::string_view mese_names[] =
+{
+	"UNKNOWN",
+	"GEN",
+	"FEB",
+	"MAR",
+	"APR",
+	"MAG",
+	"GIU",
+	"LUG",
+	"AGO",
+	"SET",
+	"OTT",
+	"NOV",
+	"DIC",
+};
 
-ruota_t convert_string_to_ruota(std::string ruota_name);
+constexpr char ascii_toupper(char c)
+{
+	return ( c >= 'a' && c <= 'z' ) ? (char) (c - 'a' + 'A') : c;
+}
 
-std::string convert_mese_to_string(mese_t mese);
+// case insensitive compare against an upper case name
+constexpr bool equal_upper(std::string_view s, std::string_view upper_name)
+{
+	if( s.size() != upper_name.size() )
+		return false;
 
-mese_t convert_string_to_mese(std::string mese_name);
+	for( size_t i = 0; i < s.size(); i++ )
+	{
+		if( ascii_toupper(s[i]) != upper_name[i] )
+			return false;
+	}
+	return true;
+}
 
+// perfect hash of the ruota names: (2 * first + last + length) mod 16
+constexpr size_t ruota_hash(std::string_view s)
+{
+	return ( 2 * (size_t) (unsigned char) ascii_toupper(s.front()) + \
+	             (size_t) (unsigned char) ascii_toupper(s.back()) + s.size() ) & 15;
+}
+
+constexpr std::array<ruota_t, 16> make_ruota_hash_table()
+{
+	std::array<ruota_t, 16> table = { };
+	for( auto& slot : table )
+	{
+		slot = ruota_t::UNKNOWN;
+	}
+	for( uint64_t r = ruota_t::NAZIONALE; r < ruota_t::UNKNOWN; r++ )
+	{
+		table[ruota_hash(ruota_names[r])] = (ruota_t) r;
+	}
+	return table;
+}
+
+inline constexpr std::array<ruota_t, 16> ruota_hash_table = make_ruota_hash_table();
+
+constexpr bool ruota_hash_is_perfect()
+{
+	for( uint64_t r = ruota_t::NAZIONALE; r < ruota_t::UNKNOWN; r++ )
+	{
+		if( ruota_hash_table[ruota_hash(ruota_names[r])] != (ruota_t) r )
+			return false;
+	}
+	return true;
+}
+
+static_assert(ruota_hash_is_perfect(), "ruota names hash collision");
+
+// three upper case letters packed in an integer
+constexpr uint32_t pack_mese(std::string_view s)
+{
+	return ( ((uint32_t) (unsigned char) ascii_toupper(s[0])) << 16 ) | \
+	       ( ((uint32_t) (unsigned char) ascii_toupper(s[1])) <<  8 ) | \
+	       ( ((uint32_t) (unsigned char) ascii_toupper(s[2])) <<  0 );
+}
+
+constexpr std::string_view convert_ruota_to_string(ruota_t ruota)
+{
+	return ( ruota < ruota_t::UNKNOWN ) ? ruota_names[ruota] : ruota_names[ruota_t::UNKNOWN];
+}
+
+constexpr ruota_t convert_string_to_ruota(std::string_view ruota_name)
+{
+	if( ruota_name.empty() )
+		return ruota_t::UNKNOWN;
+
+	const ruota_t candidate = ruota_hash_table[ruota_hash(ruota_name)];
+	if( ruota_t::UNKNOWN != candidate && equal_upper(ruota_name, ruota_names[candidate]) )
+		return candidate;
+
+	return ruota_t::UNKNOWN;
+}
+
+constexpr std::string_view convert_mese_to_string(mese_t mese)
+{
+	return ( mese <= mese_t::DIC ) ? mese_names[mese] : mese_names[mese_t::NULL_MESE];
+}
+
+constexpr mese_t convert_string_to_mese(std::string_view mese_name)
+{
+	if( 3 != mese_name.size() )
+		return mese_t::NULL_MESE;
+
+	switch (pack_mese(mese_name))
+	{
+		case pack_mese("GEN"): return mese_t::GEN;
+		case pack_mese("FEB"): return mese_t::FEB;
+		case pack_mese("MAR"): return mese_t::MAR;
+		case pack_mese("APR"): return mese_t::APR;
+		case pack_mese("MAG"): return mese_t::MAG;
+		case pack_mese("GIU"): return mese_t::GIU;
+		case pack_mese("LUG"): return mese_t::LUG;
+		case pack_mese("AGO"): return mese_t::AGO;
+		case pack_mese("SET"): return mese_t::SET;
+		case pack_mese("OTT"): return mese_t::OTT;
+		case pack_mese("NOV"): return mese_t::NOV;
+		case pack_mese("DIC"): return mese_t::DIC;
+		default: return mese_t::NULL_MESE;
+	}
+}
+
+static_assert(ruota_t::ROMA == convert_string_to_ruota("roma"), "ruota lookup");
+static_assert(ruota_t::UNKNOWN == convert_string_to_ruota("RAMO"), "ruota lookup");
+static_assert(mese_t::DIC == convert_string_to_mese("Dic"), "mese lookup");
+
+// draw date as an integer ordered like the dates: year << 9 | month << 5 | day
+constexpr uint32_t make_date(uint32_t year, uint32_t month, uint32_t day)
+{
+	return (year << 9) | (month << 5) | day;
+}
+
+inline uint32_t extraction_date(const extraction_t& ex)
+{
+	return ex.date();
+}
+
+static_assert(make_extraction(2020, 12, 27, 5, 1, 2, 3, 4, 5).date() == make_date(2020, 12, 27), "record date");
 
 #endif // LOTTO_UTILITIES_H
@@ -0,0 +1,27 @@
+// synthetic year files in the grammar of the real ones, for benchmarks
+// of the import at sizes the history does not reach
+//
+// a file NNNN.txt holds the header "NNNN BARI ... VENEZIA NAZIONALE NNNN",
+// one line "DD MMM" plus five distinct numbers (or five "--" when the
+// ruota was not drawn) per ruota and the year, then "END"; the content
+// depends only on the year, the draws per year and the seed
+
+#ifndef LOTTO_YEAR_GENERATOR_H
+#define LOTTO_YEAR_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+
+// the file names have four digits
+#define LOTTO_SYNTHETIC_MAX_YEAR     (9999)
+// one draw a day at most, on distinct dates
+#define LOTTO_SYNTHETIC_MAX_DRAWS    (365)
+#define LOTTO_SYNTHETIC_DRAWS        (156)
+
+// the content of the year file
+void generate_year_text(uint32_t year, uint32_t draws, uint64_t seed, std::string& text);
+// write the year files from start_year to end_year in the current
+// directory, existing files are left untouched and reported as errors
+int32_t generate_year_files(uint32_t start_year, uint32_t end_year, uint32_t draws, uint64_t seed);
+
+#endif // LOTTO_YEAR_GENERATOR_H
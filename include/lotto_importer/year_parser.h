@@ -0,0 +1,36 @@
+// parsing of the ascii year files NNNN.txt into extractions
+
+#ifndef LOTTO_YEAR_PARSER_H
+#define LOTTO_YEAR_PARSER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "basic_types.h"
+
+// bytes of a history file parsed by one worker, up to the end of a line
+#define LOTTO_HISTORY_CHUNK_BYTES    (1 << 20)
+
+// append the extractions of the year file in the current directory
+int32_t process_file(std::vector<extraction_t>& extraction_vec, uint32_t year);
+// every year from start_year to end_year in order, with jobs > 1 the
+// years are parsed by that many threads; cached years come from the
+// parse cache when their file is unchanged
+int32_t parse_all_files(std::vector<extraction_t>& extraction_vec, uint32_t start_year, uint32_t end_year, uint32_t jobs, bool cached);
+int32_t process_all_files_parallel(std::vector<extraction_t>& extraction_vec, uint32_t start_year, uint32_t end_year, uint32_t jobs,
+		bool cached);
+
+// a history file holds the year files one after the other, each
+// section from its header "YYYY ruota ... YYYY" to the next one; it is
+// cut at line boundaries in chunks parsed by jobs threads and merged in
+// order, the years from start_year to end_year are kept and must all
+// be in the file
+int32_t parse_history_file(std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_history,
+		uint32_t start_year, uint32_t end_year, uint32_t jobs);
+
+std::string_view next_line(const char*& cursor, const char *end);
+void split_tokens(std::string_view line, std::vector<std::string_view>& tokens);
+bool parse_uint(std::string_view str, uint32_t& value);
+
+#endif // LOTTO_YEAR_PARSER_H
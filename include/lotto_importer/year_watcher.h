@@ -0,0 +1,27 @@
+// watch mode: the year files in the current directory are watched with
+// inotify and a year written again is parsed and spliced into the db
+//
+// a year is spliced through a temporary file: the records before the
+// year are copied, the new ones and those of the later years follow,
+// then the month index and trailer, and the file replaces the db whole
+// before the sidecar indexes are rebuilt
+
+#ifndef LOTTO_YEAR_WATCHER_H
+#define LOTTO_YEAR_WATCHER_H
+
+#include <cstdint>
+#include <boost/filesystem.hpp>
+
+// quiet time after the last change before the changed years are read,
+// files written in several steps are spliced once
+#define LOTTO_WATCH_SETTLE_MS    (50)
+
+// parse the year file again and replace the records of the year in a
+// current db, nothing is written when they are the same
+int32_t splice_year_file(const boost::filesystem::path& file_db, uint32_t year);
+
+// splice every year file from start_year to end_year written in the
+// current directory until SIGINT or SIGTERM
+int32_t watch_year_files(const boost::filesystem::path& file_db, uint32_t start_year, uint32_t end_year);
+
+#endif // LOTTO_YEAR_WATCHER_H
@@ -0,0 +1,499 @@
+/*
+ * benchmarks.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unistd.h>
+#include <boost/tokenizer.hpp>
+#include "basic_types.h"
+#include "utilities.h"
+#include "mapped_file.h"
+#include "record_scanner.h"
+#include "db_io.h"
+#include "db_file.h"
+#include "db_compressed.h"
+#include "year_parser.h"
+#include "query_daemon.h"
+#include "logger.h"
+#include "benchmarks.h"
+
+typedef boost::tokenizer<boost::char_separator<char>> tokenizer;
+
+// the record parsing of process_file before the scanner: a counting
+// walk and a parsing walk of boost::tokenizer with string temporaries
+static uint64_t legacy_number_non_zero(std::string number_str)
+{
+	if( number_str.size() != 2 )
+		return 0;
+
+	if( '0' == number_str[0] )
+	{
+		number_str.erase(number_str.begin());
+	}
+
+	char *end = NULL;
+	const char *start = number_str.c_str();
+	uint64_t number_conv = std::strtoul(start, &end, 10);
+    if( end == start || 0 == number_conv )
+    {
+		return 0;
+    }
+
+    return number_conv;
+}
+
+static bool legacy_parse_record(const std::string& record, size_t n_ruote, uint64_t& checksum)
+{
+    boost::char_separator<char> sep{" "};
+    tokenizer tok_record{record, sep};
+    size_t tok_size = 0;
+    for (const auto &t : tok_record)
+    {
+    	(void) t;
+    	tok_size++;
+    }
+    if( tok_size != 2 + (5*n_ruote) + 1 )
+    {
+    	return false;
+    }
+
+    size_t k = 0;
+    for (const auto &t : tok_record)
+    {
+    	if( 0 == k )
+    	{
+    		checksum += legacy_number_non_zero(std::string(t.c_str()));
+    	}
+    	else if( 1 == k )
+    	{
+    		checksum += (uint64_t) convert_string_to_mese(std::string(t.c_str()));
+    	}
+    	else if( k < 2 + (5*n_ruote) )
+    	{
+    		if( std::string("--") != std::string(t.c_str()) )
+    		{
+    			checksum += legacy_number_non_zero(std::string(t.c_str()));
+    		}
+    	}
+    	k++;
+    }
+
+	return true;
+}
+
+static bool scanner_parse_record(std::string_view record, size_t n_ruote, record_t& rec, uint64_t& checksum)
+{
+	if( scan_status_t::SCAN_OK != scan_record(record, n_ruote, rec) )
+	{
+		return false;
+	}
+
+	checksum += rec.day + (uint64_t) rec.month;
+	for( size_t k = 0; k < 5 * n_ruote; k++ )
+	{
+		checksum += rec.numbers[k];
+	}
+
+	return true;
+}
+
+int32_t bench_record_scanner(const boost::filesystem::path& year_file, uint32_t repeat)
+{
+	if( 0 == repeat )
+	{
+		repeat = LOTTO_BENCH_SCANNER_REPEAT;
+	}
+
+	mapped_file_t infile;
+	if( infile.open(year_file.c_str()) )
+	{
+		return -1;
+	}
+
+	// split the header and the well formed records
+	std::string_view content = infile.view();
+	size_t eol = content.find('\n');
+	std::string_view header = content.substr(0, eol);
+	size_t n_ruote = 0;
+	size_t pos = 0;
+	while( pos < header.size() )
+	{
+		size_t tok_end = header.find(' ', pos);
+		if( std::string_view::npos == tok_end )
+		{
+			tok_end = header.size();
+		}
+		if( tok_end > pos && ruota_t::UNKNOWN != convert_string_to_ruota(header.substr(pos, tok_end - pos)) )
+		{
+			n_ruote++;
+		}
+		pos = tok_end + 1;
+	}
+	if( n_ruote > LOTTO_MAX_RUOTE )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: too many ruote in header: " << n_ruote;
+		return -1;
+	}
+
+	std::vector<std::string_view> records;
+	record_t rec;
+	while( std::string_view::npos != eol && eol + 1 < content.size() )
+	{
+		size_t next = content.find('\n', eol + 1);
+		std::string_view line = content.substr(eol + 1, (std::string_view::npos == next) ? std::string_view::npos : next - eol - 1);
+		if( scan_status_t::SCAN_OK == scan_record(line, n_ruote, rec) )
+		{
+			records.push_back(line);
+		}
+		eol = next;
+	}
+	if( records.empty() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: no records to benchmark in " << year_file.c_str();
+		return -1;
+	}
+
+	// the legacy path read each line into a fresh string
+	uint64_t legacy_checksum = 0;
+	auto t0 = std::chrono::steady_clock::now();
+	for( uint32_t r = 0; r < repeat; r++ )
+	{
+		for( const auto& line : records )
+		{
+			std::string record(line);
+			legacy_parse_record(record, n_ruote, legacy_checksum);
+		}
+	}
+	auto t1 = std::chrono::steady_clock::now();
+
+	uint64_t scanner_checksum = 0;
+	for( uint32_t r = 0; r < repeat; r++ )
+	{
+		for( const auto& line : records )
+		{
+			scanner_parse_record(line, n_ruote, rec, scanner_checksum);
+		}
+	}
+	auto t2 = std::chrono::steady_clock::now();
+
+	if( legacy_checksum != scanner_checksum )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: checksum mismatch, tokenizer " << legacy_checksum << \
+				" scanner " << scanner_checksum;
+		return -1;
+	}
+
+	const double n_records = (double) records.size() * (double) repeat;
+	const double legacy_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / n_records;
+	const double scanner_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / n_records;
+
+	log_flush();
+	std::cout << "records:   " << records.size() << " x " << repeat << std::endl;
+	std::cout << "tokenizer: " << legacy_ns << " ns/record, " << (1e9 / legacy_ns) << " records/s" << std::endl;
+	std::cout << "scanner:   " << scanner_ns << " ns/record, " << (1e9 / scanner_ns) << " records/s" << std::endl;
+	std::cout << "speedup:   " << (legacy_ns / scanner_ns) << "x" << std::endl;
+
+	return 0;
+}
+
+int32_t bench_decode_compressed(const boost::filesystem::path& file_z, uint32_t repeat)
+{
+	if( 0 == repeat )
+	{
+		repeat = LOTTO_BENCH_DECODE_REPEAT;
+	}
+
+	mapped_file_t infile;
+	if( infile.open(file_z.c_str()) )
+	{
+		return -1;
+	}
+	const uint8_t *data = (const uint8_t *) infile.data();
+
+	uint64_t n_records = 0;
+	uint32_t records_crc = 0;
+	std::vector<compressed_block_t> blocks;
+	if( parse_compressed_directory(data, infile.size(), n_records, records_crc, blocks) )
+	{
+		return -1;
+	}
+	if( 0 == n_records )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: no records to benchmark in " << file_z.c_str();
+		return -1;
+	}
+
+	std::vector<extraction_t> decoded(n_records);
+	auto t0 = std::chrono::steady_clock::now();
+	for( uint32_t r = 0; r < repeat; r++ )
+	{
+		for( const auto& block : blocks )
+		{
+			if( decode_compressed_block(data + block.offset, block, decoded.data() + block.first_record) )
+			{
+				LOTTO_LOG(LOG_ERROR) << "Error: corrupted block at offset " << block.offset;
+				return -1;
+			}
+		}
+	}
+	auto t1 = std::chrono::steady_clock::now();
+
+	std::vector<uint8_t> encoded(n_records * LOTTO_RECORD_BYTES);
+	encode_records(decoded.data(), n_records, encoded.data());
+	std::vector<extraction_t> plain(n_records);
+	for( uint32_t r = 0; r < repeat; r++ )
+	{
+		decode_records(encoded.data(), n_records, plain.data());
+	}
+	auto t2 = std::chrono::steady_clock::now();
+
+	if( 0 != std::memcmp(decoded.data(), plain.data(), n_records * sizeof(extraction_t)) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: decoded records mismatch";
+		return -1;
+	}
+
+	// throughput in bytes of decoded records
+	const double bytes = (double) n_records * (double) LOTTO_RECORD_BYTES * (double) repeat;
+	const double blocks_s = std::chrono::duration<double>(t1 - t0).count();
+	const double plain_s = std::chrono::duration<double>(t2 - t1).count();
+
+	log_flush();
+	std::cout << "records:   " << n_records << " x " << repeat << ", " << blocks.size() << " blocks" << std::endl;
+	std::cout << "size:      " << infile.size() << " bytes compressed, " << encoded.size() << " bytes plain" << std::endl;
+	std::cout << "blocks:    " << (bytes / blocks_s / 1e6) << " MB/s, " << (blocks_s * 1e9 / ((double) n_records * repeat)) << " ns/record" << std::endl;
+	std::cout << "plain:     " << (bytes / plain_s / 1e6) << " MB/s, " << (plain_s * 1e9 / ((double) n_records * repeat)) << " ns/record" << std::endl;
+
+	return 0;
+}
+
+// the import functions log their progress, which is muted while they
+// are timed
+class log_mute_t
+{
+public:
+	log_mute_t() : saved_(log_get_level()) { log_set_level(log_level_t::LOG_SILENT); }
+	~log_mute_t() { log_set_level(saved_); }
+
+private:
+	log_level_t saved_;
+};
+
+typedef enum : uint32_t
+{
+	PHASE_PARSE = 0,
+	PHASE_ENCODE,
+	PHASE_WRITE,
+	PHASE_VERIFY,
+	PHASE_COUNT,
+} import_phase_t;
+
+static const char *import_phase_names[PHASE_COUNT] = { "parse", "encode", "write", "verify" };
+
+int32_t bench_import(uint32_t start_year, uint32_t end_year, uint32_t jobs, uint32_t repeat, bool cached)
+{
+	if( 0 == repeat )
+	{
+		repeat = LOTTO_BENCH_IMPORT_REPEAT;
+	}
+
+	// input size, the parse throughput is measured on the text
+	uint64_t text_bytes = 0;
+	for( uint32_t year = start_year; year <= end_year; year++ )
+	{
+		char year_cstr[256];
+		std::sprintf(year_cstr, "%04u.txt", year);
+		boost::system::error_code ec;
+		const uint64_t size = boost::filesystem::file_size(boost::filesystem::path(year_cstr), ec);
+		if(ec)
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: not found file: " << year_cstr;
+			return -1;
+		}
+		text_bytes += size;
+	}
+
+	const boost::filesystem::path file_db = boost::filesystem::temp_directory_path() / \
+			boost::filesystem::unique_path("lotto_bench_%%%%%%%%.db");
+	std::vector<double> seconds[PHASE_COUNT];
+	std::vector<extraction_t> extraction_vec;
+	std::vector<uint8_t> encoded;
+	uint64_t db_bytes = 0;
+	for( uint32_t r = 0; r < repeat; r++ )
+	{
+		extraction_vec.clear();
+		boost::filesystem::remove(file_db);
+
+		int32_t ret[PHASE_COUNT] = { 0, 0, 0, 0 };
+		std::chrono::steady_clock::time_point t[PHASE_COUNT + 1];
+		{
+			log_mute_t mute;
+			t[0] = std::chrono::steady_clock::now();
+			ret[PHASE_PARSE] = parse_all_files(extraction_vec, start_year, end_year, jobs, cached);
+			t[1] = std::chrono::steady_clock::now();
+			encoded.resize(extraction_vec.size() * LOTTO_RECORD_BYTES);
+			encode_records(extraction_vec.data(), extraction_vec.size(), encoded.data());
+			t[2] = std::chrono::steady_clock::now();
+			ret[PHASE_WRITE] = ret[PHASE_PARSE] ? -1 : save_file_db(extraction_vec, file_db);
+			t[3] = std::chrono::steady_clock::now();
+			ret[PHASE_VERIFY] = ret[PHASE_WRITE] ? -1 : verify_file_db(extraction_vec, file_db, 0);
+			t[4] = std::chrono::steady_clock::now();
+		}
+		for( uint32_t phase = 0; phase < PHASE_COUNT; phase++ )
+		{
+			if( ret[phase] )
+			{
+				LOTTO_LOG(LOG_ERROR) << "Error: " << import_phase_names[phase] << " failed, run the import for the details";
+				boost::filesystem::remove(file_db);
+				return -1;
+			}
+			seconds[phase].push_back(std::chrono::duration<double>(t[phase + 1] - t[phase]).count());
+		}
+		db_bytes = boost::filesystem::file_size(file_db);
+	}
+	boost::filesystem::remove(file_db);
+
+	const double n_records = (double) extraction_vec.size();
+	const double phase_bytes[PHASE_COUNT] = { (double) text_bytes, (double) encoded.size(), (double) db_bytes, (double) db_bytes };
+	log_flush();
+	std::cout << "years:   " << start_year << "-" << end_year << ", jobs " << jobs << ", runs " << repeat << ( cached ? ", cached" : "" ) << std::endl;
+	std::cout << "records: " << extraction_vec.size() << ", text " << text_bytes << " bytes, db " << db_bytes << " bytes" << std::endl;
+	for( uint32_t phase = 0; phase < PHASE_COUNT; phase++ )
+	{
+		std::vector<double>& runs = seconds[phase];
+		std::sort(runs.begin(), runs.end());
+		const double best = runs.front();
+		const double median = runs[runs.size() / 2];
+		std::cout << std::left << std::setw(8) << import_phase_names[phase] << std::right << \
+				" best " << (best * 1e3) << " ms, " << (uint64_t) (n_records / best) << " records/s, " << (phase_bytes[phase] / best / 1e6) << " MB/s;" << \
+				" median " << (median * 1e3) << " ms, " << (uint64_t) (n_records / median) << " records/s, " << (phase_bytes[phase] / median / 1e6) << " MB/s" << std::endl;
+	}
+
+	return 0;
+}
+
+// a request of the daemon benchmark, the date window in whole years
+static daemon_request_t random_request(uint64_t& state, uint32_t first_year, uint32_t last_year)
+{
+	// xorshift64, enough to spread the windows
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	uint32_t y1 = first_year + (uint32_t) ( state % ( last_year - first_year + 1 ) );
+	uint32_t y2 = first_year + (uint32_t) ( ( state >> 20 ) % ( last_year - first_year + 1 ) );
+	if( y1 > y2 )
+		std::swap(y1, y2);
+
+	daemon_request_t request;
+	request.op = (query_op_t) ( QUERY_FREQUENCY + ( state >> 40 ) % 3 );
+	request.ruota = (ruota_t) ( ( state >> 44 ) % ( QUERY_FREQUENCY == request.op ? ruota_t::UNKNOWN : ruota_t::TUTTE ) );
+	request.from_date = make_date(y1, 1, 1);
+	request.to_date = make_date(y2, 12, 31);
+	request.limit = 100;
+	return request;
+}
+
+int32_t bench_daemon(const boost::filesystem::path& socket_path, uint32_t repeat)
+{
+	if( 0 == repeat )
+	{
+		repeat = LOTTO_BENCH_DAEMON_REPEAT;
+	}
+
+	int fd = daemon_connect(socket_path);
+	if( fd < 0 )
+	{
+		return -1;
+	}
+
+	std::vector<uint32_t> statuses;
+	std::vector<size_t> offsets;
+	std::vector<uint8_t> payload;
+	daemon_request_t info = { QUERY_INFO, ruota_t::BARI, 0, 0, 0 };
+	if( daemon_query(fd, &info, 1, statuses, offsets, payload) || REPLY_OK != statuses[0] || payload.size() < 32 )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: no answer to the info request";
+		::close(fd);
+		return -1;
+	}
+	const uint64_t n_records = load_be(payload.data() + 8, 8);
+	const uint32_t first_year = (uint32_t) load_be(payload.data() + 20, 4) >> 9;
+	const uint32_t last_year = (uint32_t) load_be(payload.data() + 24, 4) >> 9;
+	if( 0 == n_records || first_year > last_year )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: the daemon serves no records";
+		::close(fd);
+		return -1;
+	}
+
+	uint64_t state = 0x9E3779B97F4A7C15ULL;
+	std::vector<double> latencies;
+	latencies.reserve(repeat);
+	uint64_t reply_bytes = 0;
+	for( uint32_t r = 0; r < repeat; r++ )
+	{
+		const daemon_request_t request = random_request(state, first_year, last_year);
+		statuses.clear();
+		offsets.clear();
+		payload.clear();
+		auto t0 = std::chrono::steady_clock::now();
+		if( daemon_query(fd, &request, 1, statuses, offsets, payload) )
+		{
+			::close(fd);
+			return -1;
+		}
+		auto t1 = std::chrono::steady_clock::now();
+		if( REPLY_OK != statuses[0] )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: request refused by the daemon";
+			::close(fd);
+			return -1;
+		}
+		latencies.push_back(std::chrono::duration<double>(t1 - t0).count());
+		reply_bytes += payload.size();
+	}
+
+	std::vector<daemon_request_t> batch(LOTTO_BENCH_DAEMON_BATCH);
+	auto t0 = std::chrono::steady_clock::now();
+	for( uint32_t r = 0; r < repeat; r += LOTTO_BENCH_DAEMON_BATCH )
+	{
+		const size_t n = std::min<size_t>(LOTTO_BENCH_DAEMON_BATCH, repeat - r);
+		for( size_t k = 0; k < n; k++ )
+		{
+			batch[k] = random_request(state, first_year, last_year);
+		}
+		statuses.clear();
+		offsets.clear();
+		payload.clear();
+		if( daemon_query(fd, batch.data(), n, statuses, offsets, payload) )
+		{
+			::close(fd);
+			return -1;
+		}
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	::close(fd);
+
+	std::sort(latencies.begin(), latencies.end());
+	const double pipelined_s = std::chrono::duration<double>(t1 - t0).count();
+	log_flush();
+	std::cout << "records:   " << n_records << ", years " << first_year << "-" << last_year << ", requests " << repeat << std::endl;
+	std::cout << "latency:   p50 " << (latencies[latencies.size() / 2] * 1e6) << " us, p99 " << \
+			(latencies[latencies.size() * 99 / 100] * 1e6) << " us, max " << (latencies.back() * 1e6) << " us, " << \
+			(reply_bytes / repeat) << " bytes/reply" << std::endl;
+	std::cout << "pipelined: " << (uint64_t) (repeat / pipelined_s) << " requests/s in batches of " << LOTTO_BENCH_DAEMON_BATCH << std::endl;
+
+	return 0;
+}
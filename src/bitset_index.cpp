@@ -0,0 +1,264 @@
+/*
+ * bitset_index.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include "db_io.h"
+#include "db_file.h"
+#include "mapped_file.h"
+#include "utilities.h"
+#include "logger.h"
+#include "bitset_index.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LOTTO_HAVE_X86_SIMD
+#endif
+
+draw_bits_t make_draw_bits(const extraction_t& e)
+{
+	draw_bits_t bits = { 0, 0 };
+	draw_bits_set(bits, e.a());
+	draw_bits_set(bits, e.b());
+	draw_bits_set(bits, e.c());
+	draw_bits_set(bits, e.d());
+	draw_bits_set(bits, e.e());
+	bits.hi |= (uint64_t) e.ruota() << LOTTO_BITSET_SHIFT_RUOTA;
+	bits.hi |= (uint64_t) extraction_date(e) << LOTTO_BITSET_SHIFT_DATE;
+	return bits;
+}
+
+// the entry matched the numbers, filter on the date and count it
+static inline void count_match(const uint8_t *entry, uint32_t from_date, uint32_t to_date, combo_result_t& result)
+{
+	const uint64_t hi = load_be(entry + 8, 8);
+	const uint32_t date = (uint32_t) (hi >> LOTTO_BITSET_SHIFT_DATE);
+	const uint32_t ruota = (uint32_t) (hi >> LOTTO_BITSET_SHIFT_RUOTA) & 0xF;
+	if( date < from_date || date > to_date || ruota >= ruota_t::TUTTE )
+	{
+		return;
+	}
+	result.counts[ruota]++;
+	result.last_date[ruota] = date;
+}
+
+// mask and wanted words are byte swapped once so that the entries are
+// compared as stored, without decoding them
+static uint64_t count_combo_scalar(const uint8_t *entries, uint64_t n_entries, uint64_t mask_lo, uint64_t mask_hi,
+		uint64_t want_lo, uint64_t want_hi, uint32_t from_date, uint32_t to_date, combo_result_t& result)
+{
+	for( uint64_t i = 0; i < n_entries; i++ )
+	{
+		const uint8_t *entry = entries + i * LOTTO_BITSET_ENTRY_BYTES;
+		uint64_t lo, hi;
+		std::memcpy(&lo, entry, 8);
+		std::memcpy(&hi, entry + 8, 8);
+		if( ( (lo & mask_lo) == want_lo ) & ( (hi & mask_hi) == want_hi ) )
+		{
+			count_match(entry, from_date, to_date, result);
+		}
+	}
+	return n_entries;
+}
+
+#ifdef LOTTO_HAVE_X86_SIMD
+
+// four entries per iteration, two per register; an entry matches when
+// both its words compare equal, the rare matches are counted in scalar
+__attribute__((target("avx2")))
+static uint64_t count_combo_avx2(const uint8_t *entries, uint64_t n_entries, uint64_t mask_lo, uint64_t mask_hi,
+		uint64_t want_lo, uint64_t want_hi, uint32_t from_date, uint32_t to_date, combo_result_t& result)
+{
+	const __m256i mask = _mm256_set_epi64x((long long) mask_hi, (long long) mask_lo, (long long) mask_hi, (long long) mask_lo);
+	const __m256i want = _mm256_set_epi64x((long long) want_hi, (long long) want_lo, (long long) want_hi, (long long) want_lo);
+
+	uint64_t i = 0;
+	for( ; i + 4 <= n_entries; i += 4 )
+	{
+		const uint8_t *entry = entries + i * LOTTO_BITSET_ENTRY_BYTES;
+		const __m256i v0 = _mm256_loadu_si256((const __m256i *) entry);
+		const __m256i v1 = _mm256_loadu_si256((const __m256i *) (entry + 32));
+		const __m256i eq0 = _mm256_cmpeq_epi64(_mm256_and_si256(v0, mask), want);
+		const __m256i eq1 = _mm256_cmpeq_epi64(_mm256_and_si256(v1, mask), want);
+		const uint32_t bits = (uint32_t) _mm256_movemask_pd(_mm256_castsi256_pd(eq0)) | \
+		                      ( (uint32_t) _mm256_movemask_pd(_mm256_castsi256_pd(eq1)) << 4 );
+		if( 0 == bits )
+		{
+			continue;
+		}
+		for( uint32_t k = 0; k < 4; k++ )
+		{
+			if( 3 == ( (bits >> (2 * k)) & 3 ) )
+			{
+				count_match(entry + k * LOTTO_BITSET_ENTRY_BYTES, from_date, to_date, result);
+			}
+		}
+	}
+	return i;
+}
+
+#endif // LOTTO_HAVE_X86_SIMD
+
+void count_combo(const uint8_t *entries, uint64_t n_entries, const uint32_t *numbers, size_t n_numbers,
+		ruota_t ruota, uint32_t from_date, uint32_t to_date, combo_result_t& result)
+{
+	std::memset(&result, 0, sizeof(result));
+
+	draw_bits_t want = { 0, 0 };
+	for( size_t k = 0; k < n_numbers; k++ )
+	{
+		draw_bits_set(want, numbers[k]);
+	}
+	draw_bits_t mask = { want.lo, want.hi };
+	if( ruota < ruota_t::TUTTE )
+	{
+		mask.hi |= 0xFULL << LOTTO_BITSET_SHIFT_RUOTA;
+		want.hi |= (uint64_t) ruota << LOTTO_BITSET_SHIFT_RUOTA;
+	}
+
+	// the same words as stored in the index
+	uint8_t be[4][8];
+	store_be(be[0], mask.lo, 8);
+	store_be(be[1], mask.hi, 8);
+	store_be(be[2], want.lo, 8);
+	store_be(be[3], want.hi, 8);
+	uint64_t words[4];
+	std::memcpy(words, be, sizeof(words));
+
+	uint64_t done = 0;
+#ifdef LOTTO_HAVE_X86_SIMD
+	static const bool has_avx2 = __builtin_cpu_supports("avx2");
+	if( has_avx2 )
+	{
+		done = count_combo_avx2(entries, n_entries, words[0], words[1], words[2], words[3], from_date, to_date, result);
+	}
+#endif
+	count_combo_scalar(entries + done * LOTTO_BITSET_ENTRY_BYTES, n_entries - done,
+			words[0], words[1], words[2], words[3], from_date, to_date, result);
+
+	for( uint32_t r = 0; r < ruota_t::TUTTE; r++ )
+	{
+		result.counts[ruota_t::TUTTE] += result.counts[r];
+		result.last_date[ruota_t::TUTTE] = std::max(result.last_date[ruota_t::TUTTE], result.last_date[r]);
+	}
+}
+
+boost::filesystem::path bitset_index_path(const boost::filesystem::path& file_db)
+{
+	boost::filesystem::path file_bits(file_db);
+	file_bits += LOTTO_BITSET_SUFFIX;
+	return file_bits;
+}
+
+int32_t build_bitset_index(const boost::filesystem::path& file_db)
+{
+	db_reader_t reader;
+	if( reader.open(file_db.c_str()) )
+	{
+		return -1;
+	}
+	const db_layout_t& layout = reader.layout();
+
+	uint8_t header[LOTTO_BITSET_HEADER_BYTES] = { 0 };
+	std::memcpy(header, LOTTO_BITSET_MAGIC, 8);
+	store_be(header + 8, LOTTO_BITSET_VERSION, 4);
+	store_be(header + 16, layout.n_records, 8);
+	store_be(header + 24, layout.crc, 4);
+
+	const boost::filesystem::path file_bits = bitset_index_path(file_db);
+	db_file_writer_t writer;
+	if( writer.open(file_bits.c_str(), LOTTO_BITSET_HEADER_BYTES + layout.n_records * LOTTO_BITSET_ENTRY_BYTES) || \
+		writer.write_bytes(header, sizeof(header)) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_bits.c_str();
+		writer.abort();
+		return -1;
+	}
+
+	// decode and convert in chunks to keep the buffers in cache
+	const db_range_t range = reader.records();
+	const size_t chunk = 16 * 1024;
+	std::vector<extraction_t> records(chunk);
+	std::vector<uint8_t> entries(chunk * LOTTO_BITSET_ENTRY_BYTES);
+	for( uint64_t i = 0; i < range.size(); i += chunk )
+	{
+		const size_t n = (size_t) std::min<uint64_t>(chunk, range.size() - i);
+		range.decode(i, n, records.data());
+		for( size_t k = 0; k < n; k++ )
+		{
+			const draw_bits_t bits = make_draw_bits(records[k]);
+			store_be(entries.data() + k * LOTTO_BITSET_ENTRY_BYTES, bits.lo, 8);
+			store_be(entries.data() + k * LOTTO_BITSET_ENTRY_BYTES + 8, bits.hi, 8);
+		}
+		if( writer.write_bytes(entries.data(), n * LOTTO_BITSET_ENTRY_BYTES) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_bits.c_str();
+			writer.abort();
+			return -1;
+		}
+	}
+	if( writer.commit() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_bits.c_str();
+		return -1;
+	}
+
+	return 0;
+}
+
+// -1 when the index is missing or was not built from this db
+static int32_t check_bitset_index(const mapped_file_t& index, const db_layout_t& layout)
+{
+	const uint8_t *data = (const uint8_t *) index.data();
+	if( !layout.has_trailer || \
+		index.size() < LOTTO_BITSET_HEADER_BYTES || \
+		0 != std::memcmp(data, LOTTO_BITSET_MAGIC, 8) || \
+		LOTTO_BITSET_VERSION != load_be(data + 8, 4) || \
+		layout.n_records != load_be(data + 16, 8) || \
+		layout.crc != load_be(data + 24, 4) || \
+		index.size() != LOTTO_BITSET_HEADER_BYTES + layout.n_records * LOTTO_BITSET_ENTRY_BYTES )
+	{
+		return -1;
+	}
+	return 0;
+}
+
+int32_t query_combo(const boost::filesystem::path& file_db, const uint32_t *numbers, size_t n_numbers,
+		ruota_t ruota, uint32_t from_date, uint32_t to_date, combo_result_t& result)
+{
+	db_reader_t reader;
+	if( reader.open(file_db.c_str()) )
+	{
+		return -1;
+	}
+	const db_layout_t& layout = reader.layout();
+
+	const boost::filesystem::path file_bits = bitset_index_path(file_db);
+	mapped_file_t index;
+	if( !boost::filesystem::exists(file_bits) || index.open(file_bits.c_str()) || check_bitset_index(index, layout) )
+	{
+		LOTTO_LOG(LOG_INFO) << "bitset index missing or out of date, rebuilding it";
+		index.close();
+		if( build_bitset_index(file_db) || index.open(file_bits.c_str()) )
+		{
+			return -1;
+		}
+		if( index.size() != LOTTO_BITSET_HEADER_BYTES + layout.n_records * LOTTO_BITSET_ENTRY_BYTES )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: " << file_bits.c_str() << " does not match " << file_db.c_str();
+			return -1;
+		}
+	}
+
+	// the entries follow the records of the db, only the months of the range are scanned
+	const db_range_t range = reader.range(from_date, to_date);
+	count_combo((const uint8_t *) index.data() + LOTTO_BITSET_HEADER_BYTES + range.first_record() * LOTTO_BITSET_ENTRY_BYTES, range.size(),
+			numbers, n_numbers, ruota, from_date, to_date, result);
+
+	return 0;
+}
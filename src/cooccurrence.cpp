@@ -0,0 +1,247 @@
+/*
+ * cooccurrence.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include "db_io.h"
+#include "db_file.h"
+#include "utilities.h"
+#include "logger.h"
+#include "cooccurrence.h"
+
+// records handed to a worker at a time, and bucketed by ruota so that
+// one ruota tile of each window stays hot while its records are counted
+#define LOTTO_COOC_BLOCK    (4096)
+
+// per thread upper triangles, index a * 91 + b with a <= b, one tile
+// per window and ruota
+#define LOTTO_COOC_TILE     (91 * 91)
+
+static void count_block(const extraction_t *records, size_t n, const std::vector<date_window_t>& windows,
+		uint32_t *tiles)
+{
+	// counting sort of the block by ruota
+	uint32_t starts[ruota_t::TUTTE + 1] = { 0 };
+	for( size_t i = 0; i < n; i++ )
+	{
+		if( records[i].ruota() < ruota_t::TUTTE )
+		{
+			starts[records[i].ruota() + 1]++;
+		}
+	}
+	for( uint32_t r = 0; r < ruota_t::TUTTE; r++ )
+	{
+		starts[r + 1] += starts[r];
+	}
+	uint32_t order[LOTTO_COOC_BLOCK];
+	uint32_t fill[ruota_t::TUTTE];
+	std::memcpy(fill, starts, sizeof(fill));
+	for( size_t i = 0; i < n; i++ )
+	{
+		if( records[i].ruota() < ruota_t::TUTTE )
+		{
+			order[fill[records[i].ruota()]++] = (uint32_t) i;
+		}
+	}
+
+	for( uint32_t r = 0; r < ruota_t::TUTTE; r++ )
+	{
+		for( uint32_t k = starts[r]; k < starts[r + 1]; k++ )
+		{
+			const extraction_t& e = records[order[k]];
+			const uint32_t date = extraction_date(e);
+
+			// present numbers in ascending order, 0 is a missing number
+			uint32_t numbers[5];
+			uint32_t m = 0;
+			const uint64_t drawn[5] = { e.a(), e.b(), e.c(), e.d(), e.e() };
+			for( uint64_t number : drawn )
+			{
+				if( number < 1 || number > 90 )
+				{
+					continue;
+				}
+				uint32_t x = m++;
+				for( ; x > 0 && numbers[x - 1] > number; x-- )
+				{
+					numbers[x] = numbers[x - 1];
+				}
+				numbers[x] = (uint32_t) number;
+			}
+
+			for( size_t w = 0; w < windows.size(); w++ )
+			{
+				if( date < windows[w].from_date || date > windows[w].to_date )
+				{
+					continue;
+				}
+				uint32_t *tile = tiles + (w * ruota_t::TUTTE + r) * LOTTO_COOC_TILE;
+				for( uint32_t x = 0; x < m; x++ )
+				{
+					for( uint32_t y = x; y < m; y++ )
+					{
+						tile[numbers[x] * 91 + numbers[y]]++;
+					}
+				}
+			}
+		}
+	}
+}
+
+// fetch(first, n, buffer) returns n records from first, workers take
+// blocks in turn and count them in their own tiles, merged at the end
+template <typename FETCH>
+static int32_t compute_cooccurrence_blocks(uint64_t n_records, FETCH fetch, const std::vector<date_window_t>& windows,
+		uint32_t jobs, std::vector<cooccurrence_matrix_t>& matrices)
+{
+	const uint64_t n_blocks = (n_records + LOTTO_COOC_BLOCK - 1) / LOTTO_COOC_BLOCK;
+	const uint32_t n_workers = (uint32_t) std::max<uint64_t>(1, std::min<uint64_t>(std::max(jobs, 1u), n_blocks));
+	const size_t tiles_size = windows.size() * ruota_t::TUTTE * LOTTO_COOC_TILE;
+	std::vector<std::vector<uint32_t>> tiles(n_workers);
+	std::atomic<uint64_t> next_block(0);
+
+	auto worker = [&](uint32_t j)
+	{
+		tiles[j].assign(tiles_size, 0);
+		std::vector<extraction_t> buffer(LOTTO_COOC_BLOCK);
+		while(true)
+		{
+			const uint64_t b = next_block++;
+			if( b >= n_blocks )
+			{
+				break;
+			}
+			const uint64_t first = b * LOTTO_COOC_BLOCK;
+			const size_t n = (size_t) std::min<uint64_t>(LOTTO_COOC_BLOCK, n_records - first);
+			count_block(fetch(first, n, buffer.data()), n, windows, tiles[j].data());
+		}
+	};
+
+	if( 1 == n_workers )
+	{
+		worker(0);
+	}
+	else
+	{
+		std::vector<std::thread> workers;
+		for(uint32_t j = 0; j < n_workers; j++)
+		{
+			workers.emplace_back(worker, j);
+		}
+		for(auto& t : workers)
+		{
+			t.join();
+		}
+	}
+
+	// merge the tiles, mirror the triangles and sum the ruote into TUTTE
+	matrices.assign(windows.size(), cooccurrence_matrix_t());
+	for( size_t w = 0; w < windows.size(); w++ )
+	{
+		cooccurrence_matrix_t& matrix = matrices[w];
+		for( uint32_t r = 0; r < ruota_t::TUTTE; r++ )
+		{
+			const size_t base = (w * ruota_t::TUTTE + r) * LOTTO_COOC_TILE;
+			for( uint32_t a = 1; a <= 90; a++ )
+			{
+				for( uint32_t b = a; b <= 90; b++ )
+				{
+					uint32_t count = 0;
+					for( uint32_t j = 0; j < n_workers; j++ )
+					{
+						count += tiles[j][base + a * 91 + b];
+					}
+					matrix.counts[r][a][b] = count;
+					matrix.counts[r][b][a] = count;
+					matrix.counts[ruota_t::TUTTE][a][b] += count;
+					if( a != b )
+					{
+						matrix.counts[ruota_t::TUTTE][b][a] += count;
+					}
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+int32_t compute_cooccurrence(const std::vector<extraction_t>& extraction_vec, const std::vector<date_window_t>& windows,
+		uint32_t jobs, std::vector<cooccurrence_matrix_t>& matrices)
+{
+	const extraction_t *records = extraction_vec.data();
+	return compute_cooccurrence_blocks(extraction_vec.size(),
+			[records](uint64_t first, size_t, extraction_t *) { return records + first; },
+			windows, jobs, matrices);
+}
+
+int32_t query_cooccurrence(const boost::filesystem::path& file_db, const std::vector<date_window_t>& windows,
+		uint32_t jobs, std::vector<cooccurrence_matrix_t>& matrices)
+{
+	db_reader_t reader;
+	if( reader.open(file_db.c_str()) )
+	{
+		return -1;
+	}
+
+	// only the months covered by some window are read
+	uint32_t from_date = 0xFFFFFFFF, to_date = 0;
+	for( const date_window_t& window : windows )
+	{
+		from_date = std::min(from_date, window.from_date);
+		to_date = std::max(to_date, window.to_date);
+	}
+	const db_range_t range = reader.range(from_date, to_date);
+
+	return compute_cooccurrence_blocks(range.size(),
+			[&range](uint64_t first, size_t n, extraction_t *buffer)
+			{
+				range.decode(first, n, buffer);
+				return (const extraction_t *) buffer;
+			},
+			windows, jobs, matrices);
+}
+
+int32_t save_cooccurrence_csv(const std::vector<cooccurrence_matrix_t>& matrices, const boost::filesystem::path& file_csv)
+{
+	std::ofstream out(file_csv.c_str());
+	if( !out )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not open file " << file_csv.c_str();
+		return -1;
+	}
+
+	out << "window,ruota,a,b,count" << '\n';
+	for( size_t w = 0; w < matrices.size(); w++ )
+	{
+		for( uint32_t r = 0; r < ruota_t::UNKNOWN; r++ )
+		{
+			const std::string_view ruota = convert_ruota_to_string((ruota_t) r);
+			for( uint32_t a = 1; a <= 90; a++ )
+			{
+				for( uint32_t b = a + 1; b <= 90; b++ )
+				{
+					if( matrices[w].counts[r][a][b] )
+					{
+						out << w << ',' << ruota << ',' << a << ',' << b << ',' << matrices[w].counts[r][a][b] << '\n';
+					}
+				}
+			}
+		}
+	}
+	out.flush();
+	if( !out )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_csv.c_str();
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * crc32c.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <array>
+#include <cstring>
+#include "crc32c.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define LOTTO_HAVE_X86_CRC32
+#endif
+
+// reflected polynomial of CRC-32C
+#define LOTTO_CRC32C_POLY    (0x82F63B78u)
+
+static std::array<uint32_t, 256> make_crc32c_table()
+{
+	std::array<uint32_t, 256> table;
+	for( uint32_t i = 0; i < 256; i++ )
+	{
+		uint32_t crc = i;
+		for( int k = 0; k < 8; k++ )
+		{
+			crc = (crc >> 1) ^ ( (crc & 1) ? LOTTO_CRC32C_POLY : 0 );
+		}
+		table[i] = crc;
+	}
+	return table;
+}
+
+static uint32_t crc32c_scalar(uint32_t crc, const uint8_t *data, size_t n)
+{
+	static const std::array<uint32_t, 256> table = make_crc32c_table();
+
+	for( size_t i = 0; i < n; i++ )
+	{
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	}
+	return crc;
+}
+
+#ifdef LOTTO_HAVE_X86_CRC32
+
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const uint8_t *data, size_t n)
+{
+	uint64_t crc64 = crc;
+	size_t i = 0;
+	for( ; i + 8 <= n; i += 8 )
+	{
+		uint64_t word;
+		std::memcpy(&word, data + i, sizeof(word));
+		crc64 = _mm_crc32_u64(crc64, word);
+	}
+	uint32_t crc32 = (uint32_t) crc64;
+	for( ; i < n; i++ )
+	{
+		crc32 = _mm_crc32_u8(crc32, data[i]);
+	}
+	return crc32;
+}
+
+#endif // LOTTO_HAVE_X86_CRC32
+
+uint32_t crc32c_update(uint32_t crc, const uint8_t *data, size_t n)
+{
+	crc = ~crc;
+#ifdef LOTTO_HAVE_X86_CRC32
+	static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+	if( has_sse42 )
+	{
+		return ~crc32c_sse42(crc, data, n);
+	}
+#endif
+	return ~crc32c_scalar(crc, data, n);
+}
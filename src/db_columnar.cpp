@@ -0,0 +1,186 @@
+/*
+ * db_columnar.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstring>
+#include "db_io.h"
+#include "mapped_file.h"
+#include "logger.h"
+#include "db_columnar.h"
+
+#define LOTTO_COLUMNAR_HEADER_BYTES    (24)
+#define LOTTO_COLUMNAR_ENTRY_BYTES     (24)
+
+static uint64_t align_up(uint64_t offset)
+{
+	return (offset + LOTTO_COLUMNAR_ALIGN - 1) & ~((uint64_t) LOTTO_COLUMNAR_ALIGN - 1);
+}
+
+static uint32_t column_element_bytes(uint32_t id)
+{
+	return ( column_t::COL_YEAR == id ) ? 2 : 1;
+}
+
+static uint64_t column_value(const extraction_t& e, uint32_t id)
+{
+	switch (id)
+	{
+		case column_t::COL_YEAR:  return e.year();
+		case column_t::COL_MONTH: return e.month();
+		case column_t::COL_DAY:   return e.day();
+		case column_t::COL_RUOTA: return e.ruota();
+		case column_t::COL_A:     return e.a();
+		case column_t::COL_B:     return e.b();
+		case column_t::COL_C:     return e.c();
+		case column_t::COL_D:     return e.d();
+		case column_t::COL_E:     return e.e();
+		default:                  return 0;
+	}
+}
+
+int32_t parse_columnar_directory(const uint8_t *data, uint64_t size, columnar_directory_t& directory)
+{
+	if( size < LOTTO_COLUMNAR_HEADER_BYTES || 0 != std::memcmp(data, LOTTO_COLUMNAR_MAGIC, 8) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: not a columnar file";
+		return -1;
+	}
+	directory.version = (uint32_t) load_be(data + 8, 4);
+	const uint32_t n_columns = (uint32_t) load_be(data + 12, 4);
+	directory.n_records = load_be(data + 16, 8);
+	if( LOTTO_COLUMNAR_VERSION != directory.version || column_t::COL_COUNT != n_columns || \
+		size < LOTTO_COLUMNAR_HEADER_BYTES + (uint64_t) n_columns * LOTTO_COLUMNAR_ENTRY_BYTES )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: unsupported columnar file version " << directory.version << \
+				" with " << n_columns << " columns";
+		return -1;
+	}
+
+	const uint8_t *entry = data + LOTTO_COLUMNAR_HEADER_BYTES;
+	for( uint32_t k = 0; k < n_columns; k++, entry += LOTTO_COLUMNAR_ENTRY_BYTES )
+	{
+		column_entry_t column;
+		column.id = (uint32_t) load_be(entry, 4);
+		column.element_bytes = (uint32_t) load_be(entry + 4, 4);
+		column.offset = load_be(entry + 8, 8);
+		column.bytes = load_be(entry + 16, 8);
+		if( column.id >= column_t::COL_COUNT || \
+			column.element_bytes != column_element_bytes(column.id) || \
+			column.bytes != directory.n_records * column.element_bytes || \
+			column.offset > size || column.bytes > size - column.offset )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: invalid directory entry for column " << column.id;
+			return -1;
+		}
+		directory.columns[column.id] = column;
+	}
+
+	return 0;
+}
+
+int32_t save_file_columnar(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_col)
+{
+	const uint64_t n_records = extraction_vec.size();
+
+	// directory, then the columns in column_t order
+	uint8_t header[LOTTO_COLUMNAR_HEADER_BYTES + column_t::COL_COUNT * LOTTO_COLUMNAR_ENTRY_BYTES] = { 0 };
+	std::memcpy(header, LOTTO_COLUMNAR_MAGIC, 8);
+	store_be(header + 8, LOTTO_COLUMNAR_VERSION, 4);
+	store_be(header + 12, column_t::COL_COUNT, 4);
+	store_be(header + 16, n_records, 8);
+
+	uint64_t offset = align_up(sizeof(header));
+	uint8_t *entry = header + LOTTO_COLUMNAR_HEADER_BYTES;
+	for( uint32_t id = 0; id < column_t::COL_COUNT; id++, entry += LOTTO_COLUMNAR_ENTRY_BYTES )
+	{
+		const uint64_t bytes = n_records * column_element_bytes(id);
+		store_be(entry, id, 4);
+		store_be(entry + 4, column_element_bytes(id), 4);
+		store_be(entry + 8, offset, 8);
+		store_be(entry + 16, bytes, 8);
+		offset = align_up(offset + bytes);
+	}
+
+	db_file_writer_t writer;
+	if( writer.open(file_col.c_str(), offset) || writer.write_bytes(header, sizeof(header)) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_col.c_str();
+		writer.abort();
+		return -1;
+	}
+
+	const uint8_t padding[LOTTO_COLUMNAR_ALIGN] = { 0 };
+	std::vector<uint8_t> column(n_records * 2);
+	for( uint32_t id = 0; id < column_t::COL_COUNT; id++ )
+	{
+		if( writer.write_bytes(padding, align_up(writer.offset()) - writer.offset()) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_col.c_str();
+			writer.abort();
+			return -1;
+		}
+
+		const uint32_t element_bytes = column_element_bytes(id);
+		for( size_t i = 0; i < n_records; i++ )
+		{
+			store_be(column.data() + i * element_bytes, column_value(extraction_vec[i], id), element_bytes);
+		}
+		if( writer.write_bytes(column.data(), n_records * element_bytes) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_col.c_str();
+			writer.abort();
+			return -1;
+		}
+	}
+	if( writer.write_bytes(padding, align_up(writer.offset()) - writer.offset()) || writer.commit() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_col.c_str();
+		return -1;
+	}
+
+	return 0;
+}
+
+int32_t verify_file_columnar(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_col)
+{
+	mapped_file_t infile;
+	if( infile.open(file_col.c_str()) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not open file " << file_col.c_str();
+		return -1;
+	}
+	const uint8_t *data = (const uint8_t *) infile.data();
+
+	columnar_directory_t directory;
+	if( parse_columnar_directory(data, infile.size(), directory) )
+	{
+		return -1;
+	}
+	if( directory.n_records != extraction_vec.size() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! inconsistent read. abort.";
+		LOTTO_LOG(LOG_ERROR) << "Expected records: " << extraction_vec.size();
+		LOTTO_LOG(LOG_ERROR) << "Found    records: " << directory.n_records;
+		return -1;
+	}
+
+	for( uint32_t id = 0; id < column_t::COL_COUNT; id++ )
+	{
+		const column_entry_t& column = directory.columns[id];
+		const uint8_t *values = data + column.offset;
+		for( size_t i = 0; i < extraction_vec.size(); i++ )
+		{
+			if( load_be(values + i * column.element_bytes, column.element_bytes) != column_value(extraction_vec[i], id) )
+			{
+				LOTTO_LOG(LOG_ERROR) << "Error! inconsistent extraction found from file " << file_col.c_str();
+				LOTTO_LOG(LOG_ERROR) << "Extraction number " << (i + 1) << " column " << id;
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,553 @@
+/*
+ * db_compressed.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstring>
+#include <algorithm>
+#include "crc32c.h"
+#include "db_io.h"
+#include "mapped_file.h"
+#include "utilities.h"
+#include "logger.h"
+#include "db_compressed.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LOTTO_HAVE_X86_SIMD
+#endif
+
+#define LOTTO_BLOCK_PACKED    (0)
+#define LOTTO_BLOCK_RAW       (1)
+#define LOTTO_PACKED_HEADER_BYTES    (20)
+#define LOTTO_RAW_HEADER_BYTES       (4)
+
+// field k of the stream starts at bit 7k, in the 16 bit little endian
+// word at byte 7k / 8
+static inline uint8_t unpack_one(const uint8_t *src, size_t src_bytes, size_t k)
+{
+	const size_t bit = 7 * k;
+	const size_t byte = bit >> 3;
+	uint32_t word = src[byte];
+	if( byte + 1 < src_bytes )
+	{
+		word |= (uint32_t) src[byte + 1] << 8;
+	}
+	return (uint8_t) ( (word >> (bit & 7)) & 0x7F );
+}
+
+#ifdef LOTTO_HAVE_X86_SIMD
+
+// 32 fields from 28 bytes per iteration: each 128 bit lane takes a group
+// of 7 bytes, gathers for every field the 16 bit word holding it and
+// shifts it into place with a multiply, as AVX2 has no 16 bit variable
+// shift; returns the fields done
+__attribute__((target("avx2")))
+static size_t unpack_numbers_avx2(const uint8_t *src, size_t src_bytes, size_t n, uint8_t *dst)
+{
+	const __m256i gather = _mm256_setr_epi8(
+			0, 1, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7,
+			0, 1, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7);
+	// field i of a group sits at bit 7i % 8 of its word, moved to bit 8
+	const __m256i shift = _mm256_setr_epi16(256, 2, 4, 8, 16, 32, 64, 128, 256, 2, 4, 8, 16, 32, 64, 128);
+	const __m256i mask = _mm256_set1_epi16(0x7F);
+
+	size_t k = 0;
+	// the last group is read with 8 bytes
+	for( ; k + 32 <= n && (7 * k) / 8 + 29 <= src_bytes; k += 32 )
+	{
+		const uint8_t *p = src + (7 * k) / 8;
+		__m256i g01 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadl_epi64((const __m128i *) p)),
+				_mm_loadl_epi64((const __m128i *) (p + 7)), 1);
+		__m256i g23 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadl_epi64((const __m128i *) (p + 14))),
+				_mm_loadl_epi64((const __m128i *) (p + 21)), 1);
+		g01 = _mm256_and_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_shuffle_epi8(g01, gather), shift), 8), mask);
+		g23 = _mm256_and_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_shuffle_epi8(g23, gather), shift), 8), mask);
+		// packing interleaves the lanes, groups 0 2 1 3 back in order
+		__m256i out = _mm256_permute4x64_epi64(_mm256_packus_epi16(g01, g23), 0xD8);
+		_mm256_storeu_si256((__m256i *) (dst + k), out);
+	}
+	return k;
+}
+
+#endif // LOTTO_HAVE_X86_SIMD
+
+void unpack_numbers(const uint8_t *src, size_t src_bytes, size_t n, uint8_t *dst)
+{
+	size_t done = 0;
+#ifdef LOTTO_HAVE_X86_SIMD
+	static const bool has_avx2 = __builtin_cpu_supports("avx2");
+	if( has_avx2 )
+	{
+		done = unpack_numbers_avx2(src, src_bytes, n, dst);
+	}
+#endif
+	for( size_t k = done; k < n; k++ )
+	{
+		dst[k] = unpack_one(src, src_bytes, k);
+	}
+}
+
+static void put_varint(std::vector<uint8_t>& out, uint32_t value)
+{
+	while( value >= 0x80 )
+	{
+		out.push_back((uint8_t) (value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((uint8_t) value);
+}
+
+static bool get_varint(const uint8_t *& p, const uint8_t *end, uint32_t& value)
+{
+	value = 0;
+	for( uint32_t shift = 0; shift < 35; shift += 7 )
+	{
+		if( p >= end )
+			return false;
+		const uint8_t byte = *p++;
+		value |= (uint32_t) (byte & 0x7F) << shift;
+		if( 0 == (byte & 0x80) )
+			return true;
+	}
+	return false;
+}
+
+// little endian stream of 7 bit fields
+typedef struct BIT_PACKER
+{
+	std::vector<uint8_t> bytes;
+	uint64_t             acc;
+	uint32_t             bits;
+} bit_packer_t;
+
+static void pack_number(bit_packer_t& packer, uint64_t number)
+{
+	packer.acc |= (number & 0x7F) << packer.bits;
+	packer.bits += 7;
+	while( packer.bits >= 8 )
+	{
+		packer.bytes.push_back((uint8_t) packer.acc);
+		packer.acc >>= 8;
+		packer.bits -= 8;
+	}
+}
+
+static void pack_flush(bit_packer_t& packer)
+{
+	if( packer.bits )
+	{
+		packer.bytes.push_back((uint8_t) packer.acc);
+	}
+	packer.acc = 0;
+	packer.bits = 0;
+}
+
+// a draw packs if each ruota is known and appears once
+static bool draw_packs(const extraction_t *draw, size_t n)
+{
+	uint32_t seen = 0;
+	for( size_t i = 0; i < n; i++ )
+	{
+		if( draw[i].ruota() >= ruota_t::TUTTE || ( seen & (1u << draw[i].ruota()) ) )
+			return false;
+		seen |= 1u << draw[i].ruota();
+	}
+	return true;
+}
+
+// block writer state: ranks of the ruote in the order of the block
+typedef struct BLOCK_BUILDER
+{
+	uint8_t              rank[ruota_t::TUTTE];
+	uint64_t             order;
+	uint32_t             n_draws;
+	uint32_t             n_records;
+	uint32_t             first_date;
+	uint32_t             last_date;
+	std::vector<uint8_t> draws;
+	bit_packer_t         numbers;
+} block_builder_t;
+
+static void block_start(block_builder_t& block, const extraction_t *draw, size_t n)
+{
+	// the order of the first draw, then the ruote it lacks
+	uint32_t used = 0;
+	uint32_t next_rank = 0;
+	block.order = 0;
+	for( size_t i = 0; i < n; i++ )
+	{
+		block.rank[draw[i].ruota()] = (uint8_t) next_rank;
+		block.order |= (uint64_t) draw[i].ruota() << (4 * next_rank++);
+		used |= 1u << draw[i].ruota();
+	}
+	for( uint32_t r = 0; r < ruota_t::TUTTE; r++ )
+	{
+		if( 0 == ( used & (1u << r) ) )
+		{
+			block.rank[r] = (uint8_t) next_rank;
+			block.order |= (uint64_t) r << (4 * next_rank++);
+		}
+	}
+	block.n_draws = 0;
+	block.n_records = 0;
+	block.first_date = extraction_date(draw[0]);
+	block.last_date = block.first_date;
+	block.draws.clear();
+	block.numbers.bytes.clear();
+	block.numbers.acc = 0;
+	block.numbers.bits = 0;
+}
+
+// false when the draw does not follow the ruota order of the block
+static bool block_add(block_builder_t& block, const extraction_t *draw, size_t n)
+{
+	uint16_t mask = 0;
+	int32_t prev_rank = -1;
+	for( size_t i = 0; i < n; i++ )
+	{
+		const int32_t rank = block.rank[draw[i].ruota()];
+		if( rank <= prev_rank )
+			return false;
+		prev_rank = rank;
+		mask |= (uint16_t) (1u << rank);
+	}
+
+	const uint32_t date = extraction_date(draw[0]);
+	put_varint(block.draws, date - block.last_date);
+	block.draws.push_back((uint8_t) mask);
+	block.draws.push_back((uint8_t) (mask >> 8));
+	for( size_t i = 0; i < n; i++ )
+	{
+		pack_number(block.numbers, draw[i].a());
+		pack_number(block.numbers, draw[i].b());
+		pack_number(block.numbers, draw[i].c());
+		pack_number(block.numbers, draw[i].d());
+		pack_number(block.numbers, draw[i].e());
+	}
+	block.last_date = date;
+	block.n_draws++;
+	block.n_records += (uint32_t) n;
+	return true;
+}
+
+static void block_finish(block_builder_t& block, std::vector<uint8_t>& out)
+{
+	pack_flush(block.numbers);
+	uint8_t header[LOTTO_PACKED_HEADER_BYTES] = { 0 };
+	header[0] = LOTTO_BLOCK_PACKED;
+	store_be(header + 2, block.n_draws, 2);
+	store_be(header + 4, block.n_records, 2);
+	store_be(header + 8, block.first_date, 4);
+	store_be(header + 12, block.order, 8);
+	out.assign(header, header + sizeof(header));
+	out.insert(out.end(), block.draws.begin(), block.draws.end());
+	out.insert(out.end(), block.numbers.bytes.begin(), block.numbers.bytes.end());
+}
+
+static void raw_block(const extraction_t *records, size_t n, std::vector<uint8_t>& out)
+{
+	out.assign(LOTTO_RAW_HEADER_BYTES + n * LOTTO_RECORD_BYTES, 0);
+	out[0] = LOTTO_BLOCK_RAW;
+	store_be(out.data() + 2, n, 2);
+	encode_records(records, n, out.data() + LOTTO_RAW_HEADER_BYTES);
+}
+
+int32_t decode_compressed_block(const uint8_t *block, const compressed_block_t& entry, extraction_t *dst)
+{
+	const uint8_t *end = block + entry.bytes;
+	if( entry.bytes < LOTTO_RAW_HEADER_BYTES )
+		return -1;
+
+	if( LOTTO_BLOCK_RAW == block[0] )
+	{
+		if( load_be(block + 2, 2) != entry.n_records || \
+			entry.bytes != LOTTO_RAW_HEADER_BYTES + (uint64_t) entry.n_records * LOTTO_RECORD_BYTES )
+			return -1;
+		decode_records(block + LOTTO_RAW_HEADER_BYTES, entry.n_records, dst);
+		return 0;
+	}
+
+	if( LOTTO_BLOCK_PACKED != block[0] || entry.bytes < LOTTO_PACKED_HEADER_BYTES )
+		return -1;
+	const uint32_t n_draws = (uint32_t) load_be(block + 2, 2);
+	const uint32_t n_records = (uint32_t) load_be(block + 4, 2);
+	uint32_t date = (uint32_t) load_be(block + 8, 4);
+	const uint64_t order = load_be(block + 12, 8);
+	if( n_records != entry.n_records )
+		return -1;
+
+	// the draw headers are walked first to find where the numbers start
+	const uint8_t *p = block + LOTTO_PACKED_HEADER_BYTES;
+	uint32_t dates[LOTTO_COMPRESSED_BLOCK_RECORDS];
+	uint16_t masks[LOTTO_COMPRESSED_BLOCK_RECORDS];
+	uint32_t total = 0;
+	for( uint32_t d = 0; d < n_draws; d++ )
+	{
+		uint32_t delta = 0;
+		if( !get_varint(p, end, delta) || p + 2 > end || d >= LOTTO_COMPRESSED_BLOCK_RECORDS )
+			return -1;
+		date += delta;
+		dates[d] = date;
+		masks[d] = (uint16_t) (p[0] | (p[1] << 8));
+		p += 2;
+		total += (uint32_t) __builtin_popcount(masks[d]);
+	}
+	if( total != n_records || (uint64_t) (end - p) != (5ULL * n_records * 7 + 7) / 8 )
+		return -1;
+
+	uint8_t numbers[5 * LOTTO_COMPRESSED_BLOCK_RECORDS];
+	unpack_numbers(p, (size_t) (end - p), 5 * (size_t) n_records, numbers);
+
+	const uint8_t *number = numbers;
+	for( uint32_t d = 0; d < n_draws; d++ )
+	{
+		// the fields are composed in place, the date sits above the numbers
+		const uint64_t date_bits = (uint64_t) dates[d] << LOTTO_SHIFT_DATE;
+		for( uint32_t mask = masks[d]; mask; mask &= mask - 1 )
+		{
+			const uint32_t rank = (uint32_t) __builtin_ctz(mask);
+			dst->raw = date_bits | ( ( (order >> (4 * rank)) & LOTTO_MASK_RUOTA ) << LOTTO_SHIFT_RUOTA ) | \
+					( (uint64_t) number[0] << LOTTO_SHIFT_A ) | ( (uint64_t) number[1] << LOTTO_SHIFT_B ) | \
+					( (uint64_t) number[2] << LOTTO_SHIFT_C ) | ( (uint64_t) number[3] << LOTTO_SHIFT_D ) | \
+					( (uint64_t) number[4] << LOTTO_SHIFT_E );
+			number += 5;
+			dst++;
+		}
+	}
+
+	return 0;
+}
+
+int32_t parse_compressed_directory(const uint8_t *data, uint64_t size, uint64_t& n_records, uint32_t& records_crc,
+		std::vector<compressed_block_t>& blocks)
+{
+	if( size < LOTTO_COMPRESSED_HEADER_BYTES || 0 != std::memcmp(data, LOTTO_COMPRESSED_MAGIC, 8) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: not a compressed db";
+		return -1;
+	}
+	const uint32_t version = (uint32_t) load_be(data + 8, 4);
+	if( LOTTO_COMPRESSED_VERSION != version || LOTTO_DB_BYTE_ORDER != load_be(data + 12, 4) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: unsupported compressed db version " << version;
+		return -1;
+	}
+	n_records = load_be(data + 16, 8);
+	const uint32_t n_blocks = (uint32_t) load_be(data + 24, 4);
+	records_crc = (uint32_t) load_be(data + 28, 4);
+	if( size < LOTTO_COMPRESSED_HEADER_BYTES + (uint64_t) n_blocks * LOTTO_COMPRESSED_ENTRY_BYTES )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: compressed db directory of " << n_blocks << " blocks exceeds the file";
+		return -1;
+	}
+
+	blocks.resize(n_blocks);
+	uint64_t expected_first = 0;
+	const uint8_t *entry = data + LOTTO_COMPRESSED_HEADER_BYTES;
+	for( uint32_t k = 0; k < n_blocks; k++, entry += LOTTO_COMPRESSED_ENTRY_BYTES )
+	{
+		compressed_block_t& block = blocks[k];
+		block.first_record = load_be(entry, 8);
+		block.offset = load_be(entry + 8, 8);
+		block.bytes = (uint32_t) load_be(entry + 16, 4);
+		block.n_records = (uint32_t) load_be(entry + 20, 4);
+		block.first_date = (uint32_t) load_be(entry + 24, 4);
+		block.last_date = (uint32_t) load_be(entry + 28, 4);
+		block.crc = (uint32_t) load_be(entry + 32, 4);
+		if( block.first_record != expected_first || block.n_records > LOTTO_COMPRESSED_BLOCK_RECORDS || \
+			block.offset > size || block.bytes > size - block.offset )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: invalid directory entry for block " << k;
+			return -1;
+		}
+		expected_first += block.n_records;
+	}
+	if( expected_first != n_records )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: compressed db blocks hold " << expected_first << " records instead of " << n_records;
+		return -1;
+	}
+
+	return 0;
+}
+
+int32_t save_file_compressed(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_z)
+{
+	// blocks are built first, the directory precedes them
+	std::vector<std::vector<uint8_t>> block_bytes;
+	std::vector<compressed_block_t> blocks;
+	block_builder_t builder;
+	bool building = false;
+	uint64_t block_first = 0;
+
+	auto close_block = [&](uint64_t next_first)
+	{
+		if( !building )
+			return;
+		block_bytes.emplace_back();
+		block_finish(builder, block_bytes.back());
+		blocks.push_back({ block_first, 0, 0, builder.n_records, builder.first_date, builder.last_date, 0 });
+		building = false;
+		block_first = next_first;
+	};
+
+	const extraction_t *records = extraction_vec.data();
+	const size_t n_records = extraction_vec.size();
+	for( size_t i = 0; i < n_records; )
+	{
+		// a draw: the run of records sharing a date
+		const uint32_t date = extraction_date(records[i]);
+		size_t n = 1;
+		while( i + n < n_records && extraction_date(records[i + n]) == date )
+			n++;
+
+		if( n > ruota_t::TUTTE || !draw_packs(records + i, n) )
+		{
+			close_block(i);
+			for( size_t done = 0; done < n; done += LOTTO_COMPRESSED_BLOCK_RECORDS )
+			{
+				const size_t chunk = std::min<size_t>(n - done, LOTTO_COMPRESSED_BLOCK_RECORDS);
+				block_bytes.emplace_back();
+				raw_block(records + i + done, chunk, block_bytes.back());
+				blocks.push_back({ i + done, 0, 0, (uint32_t) chunk, date, date, 0 });
+			}
+			block_first = i + n;
+		}
+		else if( !building || date < builder.last_date || \
+				 builder.n_records + n > LOTTO_COMPRESSED_BLOCK_RECORDS || !block_add(builder, records + i, n) )
+		{
+			close_block(i);
+			block_start(builder, records + i, n);
+			block_add(builder, records + i, n);
+			building = true;
+		}
+		i += n;
+	}
+	close_block(n_records);
+
+	uint8_t header[LOTTO_COMPRESSED_HEADER_BYTES] = { 0 };
+	std::memcpy(header, LOTTO_COMPRESSED_MAGIC, 8);
+	store_be(header + 8, LOTTO_COMPRESSED_VERSION, 4);
+	store_be(header + 12, LOTTO_DB_BYTE_ORDER, 4);
+	store_be(header + 16, n_records, 8);
+	store_be(header + 24, blocks.size(), 4);
+	std::vector<uint8_t> encoded(n_records * LOTTO_RECORD_BYTES);
+	encode_records(records, n_records, encoded.data());
+	store_be(header + 28, crc32c_update(0, encoded.data(), encoded.size()), 4);
+
+	std::vector<uint8_t> directory(blocks.size() * LOTTO_COMPRESSED_ENTRY_BYTES, 0);
+	uint64_t offset = LOTTO_COMPRESSED_HEADER_BYTES + directory.size();
+	for( size_t k = 0; k < blocks.size(); k++ )
+	{
+		blocks[k].offset = offset;
+		blocks[k].bytes = (uint32_t) block_bytes[k].size();
+		blocks[k].crc = crc32c_update(0, block_bytes[k].data(), block_bytes[k].size());
+		uint8_t *entry = directory.data() + k * LOTTO_COMPRESSED_ENTRY_BYTES;
+		store_be(entry, blocks[k].first_record, 8);
+		store_be(entry + 8, blocks[k].offset, 8);
+		store_be(entry + 16, blocks[k].bytes, 4);
+		store_be(entry + 20, blocks[k].n_records, 4);
+		store_be(entry + 24, blocks[k].first_date, 4);
+		store_be(entry + 28, blocks[k].last_date, 4);
+		store_be(entry + 32, blocks[k].crc, 4);
+		offset += blocks[k].bytes;
+	}
+
+	db_file_writer_t writer;
+	if( writer.open(file_z.c_str(), offset) || \
+		writer.write_bytes(header, sizeof(header)) || \
+		writer.write_bytes(directory.data(), directory.size()) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_z.c_str();
+		writer.abort();
+		return -1;
+	}
+	for( const auto& bytes : block_bytes )
+	{
+		if( writer.write_bytes(bytes.data(), bytes.size()) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_z.c_str();
+			writer.abort();
+			return -1;
+		}
+	}
+	if( writer.commit() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_z.c_str();
+		return -1;
+	}
+
+	return 0;
+}
+
+int32_t load_file_compressed(const boost::filesystem::path& file_z, std::vector<extraction_t>& extraction_vec)
+{
+	mapped_file_t infile;
+	if( infile.open(file_z.c_str()) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not open file " << file_z.c_str();
+		return -1;
+	}
+	const uint8_t *data = (const uint8_t *) infile.data();
+
+	uint64_t n_records = 0;
+	uint32_t records_crc = 0;
+	std::vector<compressed_block_t> blocks;
+	if( parse_compressed_directory(data, infile.size(), n_records, records_crc, blocks) )
+	{
+		return -1;
+	}
+
+	extraction_vec.resize(n_records);
+	for( size_t k = 0; k < blocks.size(); k++ )
+	{
+		const uint8_t *block = data + blocks[k].offset;
+		if( crc32c_update(0, block, blocks[k].bytes) != blocks[k].crc || \
+			decode_compressed_block(block, blocks[k], extraction_vec.data() + blocks[k].first_record) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: corrupted block " << k << " in file " << file_z.c_str();
+			return -1;
+		}
+	}
+
+	// the records as a db would store them
+	std::vector<uint8_t> encoded(n_records * LOTTO_RECORD_BYTES);
+	encode_records(extraction_vec.data(), n_records, encoded.data());
+	if( crc32c_update(0, encoded.data(), encoded.size()) != records_crc )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! checksum mismatch in file " << file_z.c_str();
+		return -1;
+	}
+
+	return 0;
+}
+
+int32_t verify_file_compressed(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_z)
+{
+	std::vector<extraction_t> loaded;
+	if( load_file_compressed(file_z, loaded) )
+	{
+		return -1;
+	}
+	if( loaded.size() != extraction_vec.size() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! inconsistent read. abort.";
+		LOTTO_LOG(LOG_ERROR) << "Expected records: " << extraction_vec.size();
+		LOTTO_LOG(LOG_ERROR) << "Found    records: " << loaded.size();
+		return -1;
+	}
+	for( size_t i = 0; i < loaded.size(); i++ )
+	{
+		if( loaded[i].raw != extraction_vec[i].raw )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error! inconsistent extraction found from file " << file_z.c_str();
+			LOTTO_LOG(LOG_ERROR) << "Extraction number " << (i + 1);
+			return -1;
+		}
+	}
+
+	return 0;
+}
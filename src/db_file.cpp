@@ -0,0 +1,285 @@
+/*
+ * db_file.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <boost/system/error_code.hpp>
+#include "crc32c.h"
+#include "utilities.h"
+#include "logger.h"
+#include "db_file.h"
+
+db_reader_t::db_reader_t()
+{
+	std::memset(&layout_, 0, sizeof(layout_));
+}
+
+int32_t db_reader_t::open(const char *filename)
+{
+	close();
+	filename_ = filename;
+	if( file_.open(filename) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not open file " << filename;
+		return -1;
+	}
+	if( parse_db_layout(data(), file_.size(), layout_) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! file " << filename << " is not a valid db.";
+		close();
+		return -1;
+	}
+
+	return 0;
+}
+
+void db_reader_t::close()
+{
+	file_.close();
+	std::memset(&layout_, 0, sizeof(layout_));
+}
+
+db_range_t db_reader_t::range(uint32_t from_date, uint32_t to_date) const
+{
+	uint64_t first = 0, end = 0;
+	locate_date_range(data(), layout_, from_date, to_date, first, end);
+	return records().subrange(first, end - first);
+}
+
+int32_t db_reader_t::verify(uint32_t& crc) const
+{
+	crc = 0;
+	if( !layout_.has_trailer )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! file " << filename_ << " has no checksum trailer, " << \
+				layout_.n_records << " records can not be verified.";
+		return -1;
+	}
+
+	crc = crc32c_update(0, data() + layout_.records_offset, layout_.n_records * LOTTO_RECORD_BYTES);
+	if( crc != layout_.crc )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! checksum mismatch in file " << filename_;
+		LOTTO_LOG(LOG_ERROR) << "Expected crc32c: " << layout_.crc;
+		LOTTO_LOG(LOG_ERROR) << "Found    crc32c: " << crc;
+		return -1;
+	}
+
+	return 0;
+}
+
+int32_t save_file_db(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_db)
+{
+	db_file_writer_t writer;
+
+	if( writer.open_db(file_db.c_str(), extraction_vec.size()) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not open file " << file_db.c_str();
+		return -1;
+	}
+
+	if( writer.write_records(extraction_vec.data(), extraction_vec.size()) || \
+		writer.write_trailer() || \
+		writer.commit() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_db.c_str();
+		return -1;
+	}
+
+    return 0;
+}
+
+int32_t read_last_draw(const boost::filesystem::path& file_db, std::vector<extraction_t>& last_draw, uint64_t& n_records, uint32_t& version)
+{
+	last_draw.clear();
+	n_records = 0;
+	version = 0;
+
+	db_reader_t reader;
+	if( reader.open(file_db.c_str()) )
+	{
+		return -1;
+	}
+	n_records = reader.size();
+	version = reader.layout().version;
+	// the last records are the last draw only in date order
+	if( !reader.date_ordered() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! file " << file_db.c_str() << " has no month index, its records are not " << \
+				"in date order: a full import writes the db again";
+		return -1;
+	}
+
+	// a draw has at most one record per ruota
+	const db_range_t tail = reader.records().subrange(n_records - std::min(n_records, (uint64_t) ruota_t::UNKNOWN),
+			std::min(n_records, (uint64_t) ruota_t::UNKNOWN));
+	if( !tail.empty() )
+	{
+		const uint32_t last_date = extraction_date(tail.back());
+		auto first = tail.end();
+		while( first != tail.begin() && extraction_date(*(first - 1)) == last_date )
+		{
+			first--;
+		}
+		last_draw.assign(first, tail.end());
+	}
+
+	return 0;
+}
+
+int32_t read_file_db(const boost::filesystem::path& file_db, std::vector<extraction_t>& extraction_vec, uint64_t n_records)
+{
+	db_reader_t reader;
+	if( reader.open(file_db.c_str()) )
+	{
+		return -1;
+	}
+	if( n_records > reader.size() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! file " << file_db.c_str() << " is not a valid db.";
+		return -1;
+	}
+	extraction_vec.resize(n_records);
+	reader.records().decode(0, n_records, extraction_vec.data());
+
+	return 0;
+}
+
+int32_t verify_file_db(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_db, uint64_t first_record)
+{
+    if(! (boost::filesystem::exists(file_db) && boost::filesystem::is_regular_file(file_db)) )
+    {
+		LOTTO_LOG(LOG_ERROR) << "Error! file " << file_db.c_str() << \
+				" does not exist or is not a regular file.";
+		return -1;
+    }
+
+    // map the file
+	db_reader_t reader;
+	if( reader.open(file_db.c_str()) )
+	{
+		return -1;
+	}
+	if( !reader.layout().has_trailer )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! file " << file_db.c_str() << " has no valid trailer.";
+		return -1;
+	}
+	if( reader.size() != first_record + extraction_vec.size() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! inconsistent read. abort.";
+		LOTTO_LOG(LOG_ERROR) << "Expected records: " << (first_record + extraction_vec.size());
+		LOTTO_LOG(LOG_ERROR) << "Found    records: " << reader.size();
+		return -1;
+	}
+
+	// the records before first_record are not in extraction_vec,
+	// the others are encoded in chunks and compared to the mapping
+	const db_range_t records = reader.records().subrange(first_record, extraction_vec.size());
+	const size_t chunk_records = 1 << 16;
+	std::vector<uint8_t> encoded(std::min(extraction_vec.size(), chunk_records) * LOTTO_RECORD_BYTES);
+	for( size_t i = 0; i < extraction_vec.size(); i += chunk_records )
+	{
+		const size_t n = std::min(extraction_vec.size() - i, chunk_records);
+		encode_records(extraction_vec.data() + i, n, encoded.data());
+		if( 0 == std::memcmp(encoded.data(), records.bytes() + i * LOTTO_RECORD_BYTES, n * LOTTO_RECORD_BYTES) )
+		{
+			continue;
+		}
+
+		for( size_t k = 0; k < n; k++ )
+		{
+			const extraction_t ex_found = records[i + k];
+			if( ex_found.raw != extraction_vec[i + k].raw )
+			{
+				LOTTO_LOG(LOG_ERROR) << "Error! inconsistent extraction found from file " << file_db.c_str();
+				LOTTO_LOG(LOG_ERROR) << "Extraction number " << (first_record + i + k + 1);
+				print_extraction("Expected:", extraction_vec[i + k]);
+				print_extraction("Found:", ex_found);
+				return -1;
+			}
+		}
+	}
+
+	uint32_t crc = 0;
+	return reader.verify(crc);
+}
+
+int32_t verify_file_db_checksum(const boost::filesystem::path& file_db, uint64_t& n_records, uint32_t& crc)
+{
+	n_records = 0;
+	crc = 0;
+
+	db_reader_t reader;
+	if( reader.open(file_db.c_str()) || reader.verify(crc) )
+	{
+		return -1;
+	}
+	n_records = reader.size();
+
+	return 0;
+}
+
+void print_extraction(const char *title, const extraction_t& e)
+{
+	// one line of the log, the fields are not split by other lines
+	LOTTO_LOG(LOG_ERROR) << title << "\n" << \
+			"   year:  " << e.year() << "\n" << \
+			"   month: " << e.month() << "\n" << \
+			"   day:   " << e.day() << "\n" << \
+			"   a:     " << e.a() << "\n" << \
+			"   b:     " << e.b() << "\n" << \
+			"   c:     " << e.c() << "\n" << \
+			"   d:     " << e.d() << "\n" << \
+			"   e:     " << e.e() << "\n" << \
+			"   ruota: " << e.ruota();
+}
+
+int32_t convert_file_db(const boost::filesystem::path& file_from, const boost::filesystem::path& file_to)
+{
+	// the records are all in memory before the db is written, so the
+	// source itself may be rewritten in place, never another db
+	boost::system::error_code ec;
+	if( boost::filesystem::exists(file_to) && !boost::filesystem::equivalent(file_from, file_to, ec) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! file " << file_to.c_str() << " already exists.";
+		return -1;
+	}
+
+	std::vector<extraction_t> extraction_vec;
+	uint32_t version = 0;
+	{
+		db_reader_t reader;
+		if( reader.open(file_from.c_str()) )
+		{
+			return -1;
+		}
+		version = reader.layout().version;
+		extraction_vec.resize(reader.size());
+		reader.records().decode(0, reader.size(), extraction_vec.data());
+	}
+
+	// the legacy records of a draw follow the ruote of the year file,
+	// the current ones the order of their raw words
+	std::stable_sort(extraction_vec.begin(), extraction_vec.end(),
+			[](const extraction_t& a, const extraction_t& b){ return a.raw < b.raw; });
+
+	if( save_file_db(extraction_vec, file_to) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from save_file_db." << " abort.";
+		return -1;
+	}
+	if( verify_file_db(extraction_vec, file_to, 0) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from verify_file_db." << " abort.";
+		return -1;
+	}
+	LOTTO_LOG(LOG_INFO) << "converted " << extraction_vec.size() << " records from a version " << version << \
+			" db to version " << LOTTO_DB_VERSION;
+
+	return 0;
+}
@@ -0,0 +1,753 @@
+/*
+ * db_io.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include "crc32c.h"
+#include "import_stats.h"
+#include "utilities.h"
+#include "logger.h"
+#include "db_io.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LOTTO_HAVE_X86_SIMD
+#endif
+
+// write buffer, a multiple of the record size and of the page size
+#define LOTTO_WRITE_BUFFER_BYTES    (1 << 20)
+#define LOTTO_WRITE_BUFFER_ALIGN    (4096)
+
+static_assert(sizeof(extraction_t) == LOTTO_RECORD_BYTES, "extraction_t is not 64 bit");
+static_assert(LOTTO_WRITE_BUFFER_BYTES % LOTTO_RECORD_BYTES == 0, "write buffer not a multiple of a record");
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+
+// the host already matches the file order
+void encode_records(const extraction_t *src, size_t n, uint8_t *dst)
+{
+	std::memcpy(dst, src, n * LOTTO_RECORD_BYTES);
+}
+
+void decode_records(const uint8_t *src, size_t n, extraction_t *dst)
+{
+	std::memcpy(dst, src, n * LOTTO_RECORD_BYTES);
+}
+
+#else
+
+static void bswap_records_scalar(const uint8_t *src, size_t n, uint8_t *dst)
+{
+	for( size_t i = 0; i < n; i++ )
+	{
+		uint64_t value;
+		std::memcpy(&value, src + i * LOTTO_RECORD_BYTES, sizeof(value));
+		value = __builtin_bswap64(value);
+		std::memcpy(dst + i * LOTTO_RECORD_BYTES, &value, sizeof(value));
+	}
+}
+
+#ifdef LOTTO_HAVE_X86_SIMD
+
+// four records per shuffle
+__attribute__((target("avx2")))
+static void bswap_records_avx2(const uint8_t *src, size_t n, uint8_t *dst)
+{
+	const __m256i mask = _mm256_set_epi8(
+			 8,  9, 10, 11, 12, 13, 14, 15,  0,  1,  2,  3,  4,  5,  6,  7,
+			 8,  9, 10, 11, 12, 13, 14, 15,  0,  1,  2,  3,  4,  5,  6,  7);
+	size_t i = 0;
+	for( ; i + 4 <= n; i += 4 )
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i *) (src + i * LOTTO_RECORD_BYTES));
+		_mm256_storeu_si256((__m256i *) (dst + i * LOTTO_RECORD_BYTES), _mm256_shuffle_epi8(v, mask));
+	}
+	bswap_records_scalar(src + i * LOTTO_RECORD_BYTES, n - i, dst + i * LOTTO_RECORD_BYTES);
+}
+
+#endif // LOTTO_HAVE_X86_SIMD
+
+static void bswap_records(const uint8_t *src, size_t n, uint8_t *dst)
+{
+#ifdef LOTTO_HAVE_X86_SIMD
+	static const bool has_avx2 = __builtin_cpu_supports("avx2");
+	if( has_avx2 )
+	{
+		bswap_records_avx2(src, n, dst);
+		return;
+	}
+#endif
+	bswap_records_scalar(src, n, dst);
+}
+
+void encode_records(const extraction_t *src, size_t n, uint8_t *dst)
+{
+	bswap_records((const uint8_t *) src, n, dst);
+}
+
+void decode_records(const uint8_t *src, size_t n, extraction_t *dst)
+{
+	bswap_records(src, n, (uint8_t *) dst);
+}
+
+#endif // __BYTE_ORDER__
+
+void decode_legacy_records(const uint8_t *src, size_t n, extraction_t *dst)
+{
+	decode_records(src, n, dst);
+	for( size_t i = 0; i < n; i++ )
+	{
+		dst[i] = extraction_from_legacy(dst[i].raw);
+	}
+}
+
+void encode_trailer(const db_trailer_t& trailer, uint8_t *dst)
+{
+	store_be(dst, trailer.n_records, 8);
+	store_be(dst + 8, trailer.crc, 4);
+	std::memcpy(dst + 12, LOTTO_TRAILER_MAGIC, 4);
+}
+
+bool decode_trailer(const uint8_t *src, db_trailer_t& trailer)
+{
+	if( 0 != std::memcmp(src + 12, LOTTO_TRAILER_MAGIC, 4) )
+	{
+		return false;
+	}
+	trailer.n_records = load_be(src, 8);
+	trailer.crc = (uint32_t) load_be(src + 8, 4);
+	return true;
+}
+
+void encode_header(const db_header_t& header, uint8_t *dst)
+{
+	std::memset(dst, 0, LOTTO_HEADER_BYTES);
+	std::memcpy(dst, LOTTO_DB_MAGIC, 8);
+	store_be(dst + 8, header.version, 4);
+	store_be(dst + 12, LOTTO_DB_BYTE_ORDER, 4);
+	store_be(dst + 16, LOTTO_HEADER_BYTES, 4);
+	store_be(dst + 20, LOTTO_RECORD_BYTES, 4);
+	store_be(dst + 24, header.n_records, 8);
+	store_be(dst + 32, header.first_date, 4);
+	store_be(dst + 36, header.last_date, 4);
+	store_be(dst + 40, header.index_offset, 8);
+	store_be(dst + 48, header.n_months, 4);
+	store_be(dst + 52, header.index_crc, 4);
+	store_be(dst + 56, crc32c_update(0, dst, 56), 4);
+}
+
+int32_t decode_header(const uint8_t *src, db_header_t& header)
+{
+	if( 0 != std::memcmp(src, LOTTO_DB_MAGIC, 8) )
+	{
+		return -1;
+	}
+	// the mark reads back as written only in the byte order of the format
+	if( LOTTO_DB_BYTE_ORDER != load_be(src + 12, 4) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: db byte order mark " << std::hex << load_be(src + 12, 4) << std::dec << \
+				" does not match";
+		return -1;
+	}
+	header.version = (uint32_t) load_be(src + 8, 4);
+	// version 2 has the same header, with legacy records
+	if( header.version < 2 || header.version > LOTTO_DB_VERSION || \
+		LOTTO_HEADER_BYTES != load_be(src + 16, 4) || \
+		LOTTO_RECORD_BYTES != load_be(src + 20, 4) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: unsupported db version " << header.version;
+		return -1;
+	}
+	if( crc32c_update(0, src, 56) != load_be(src + 56, 4) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: db header checksum mismatch";
+		return -1;
+	}
+	header.n_records = load_be(src + 24, 8);
+	header.first_date = (uint32_t) load_be(src + 32, 4);
+	header.last_date = (uint32_t) load_be(src + 36, 4);
+	header.index_offset = load_be(src + 40, 8);
+	header.n_months = (uint32_t) load_be(src + 48, 4);
+	header.index_crc = (uint32_t) load_be(src + 52, 4);
+
+	return 0;
+}
+
+int32_t parse_db_layout(const uint8_t *data, uint64_t size, db_layout_t& layout)
+{
+	layout.version = 0;
+	layout.records_offset = 0;
+	layout.n_records = 0;
+	layout.has_trailer = false;
+	layout.crc = 0;
+	layout.first_date = 0;
+	layout.last_date = 0;
+	layout.months = NULL;
+	layout.n_months = 0;
+
+	db_trailer_t trailer;
+	const bool has_trailer = ( size >= LOTTO_TRAILER_BYTES && decode_trailer(data + size - LOTTO_TRAILER_BYTES, trailer) );
+
+	if( size >= LOTTO_HEADER_BYTES + LOTTO_TRAILER_BYTES && 0 == std::memcmp(data, LOTTO_DB_MAGIC, 8) )
+	{
+		db_header_t header;
+		if( decode_header(data, header) )
+		{
+			return -1;
+		}
+		// header, records, index and trailer must tile the file exactly
+		const uint64_t max_records = (size - LOTTO_HEADER_BYTES - LOTTO_TRAILER_BYTES) / LOTTO_RECORD_BYTES;
+		if( !has_trailer || \
+			trailer.n_records != header.n_records || \
+			header.n_records > max_records || \
+			header.index_offset != LOTTO_HEADER_BYTES + header.n_records * LOTTO_RECORD_BYTES || \
+			(uint64_t) header.n_months * LOTTO_MONTH_BYTES != size - LOTTO_TRAILER_BYTES - header.index_offset )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: db header of " << header.n_records << " records and " << header.n_months << \
+					" months inconsistent with file size " << size;
+			return -1;
+		}
+		const uint8_t *months = data + header.index_offset;
+		if( crc32c_update(0, months, (size_t) header.n_months * LOTTO_MONTH_BYTES) != header.index_crc )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: db month index checksum mismatch";
+			return -1;
+		}
+		layout.version = header.version;
+		layout.records_offset = LOTTO_HEADER_BYTES;
+		layout.n_records = header.n_records;
+		layout.has_trailer = true;
+		layout.crc = trailer.crc;
+		layout.first_date = header.first_date;
+		layout.last_date = header.last_date;
+		layout.months = header.n_months ? months : NULL;
+		layout.n_months = header.n_months;
+		return 0;
+	}
+
+	if( has_trailer )
+	{
+		if( trailer.n_records != (size - LOTTO_TRAILER_BYTES) / LOTTO_RECORD_BYTES || \
+			0 != (size - LOTTO_TRAILER_BYTES) % LOTTO_RECORD_BYTES )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: trailer records " << trailer.n_records << \
+					" inconsistent with file size " << size;
+			return -1;
+		}
+		layout.version = 1;
+		layout.n_records = trailer.n_records;
+		layout.has_trailer = true;
+		layout.crc = trailer.crc;
+		return 0;
+	}
+
+	if( 0 != size % LOTTO_RECORD_BYTES )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: file size " << size << " is not a multiple of the record size";
+		return -1;
+	}
+	layout.n_records = size / LOTTO_RECORD_BYTES;
+
+	return 0;
+}
+
+static db_month_t load_month(const uint8_t *months, uint32_t k)
+{
+	const uint8_t *entry = months + (size_t) k * LOTTO_MONTH_BYTES;
+	db_month_t month;
+	month.key = (uint32_t) load_be(entry, 4);
+	month.n_records = (uint32_t) load_be(entry + 4, 4);
+	month.first_record = load_be(entry + 8, 8);
+	return month;
+}
+
+void locate_date_range(const uint8_t *data, const db_layout_t& layout, uint32_t from_date, uint32_t to_date,
+		uint64_t& first, uint64_t& end)
+{
+	// no date is in an inverted range, with or without an index
+	first = 0;
+	end = 0;
+	if( from_date > to_date )
+	{
+		return;
+	}
+	end = layout.n_records;
+	if( NULL == layout.months )
+	{
+		return;
+	}
+
+	// first month not before from_date and first month after to_date
+	const uint32_t from_key = make_month_key(from_date);
+	const uint32_t to_key = make_month_key(to_date);
+	uint32_t lo = 0, hi = layout.n_months;
+	while( lo < hi )
+	{
+		const uint32_t mid = lo + (hi - lo) / 2;
+		if( load_month(layout.months, mid).key < from_key )
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	first = ( lo < layout.n_months ) ? load_month(layout.months, lo).first_record : layout.n_records;
+	hi = layout.n_months;
+	while( lo < hi )
+	{
+		const uint32_t mid = lo + (hi - lo) / 2;
+		if( load_month(layout.months, mid).key <= to_key )
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	end = ( lo < layout.n_months ) ? load_month(layout.months, lo).first_record : layout.n_records;
+
+	// trim the days of the boundary months out of the range
+	const uint8_t *records = data + layout.records_offset;
+	while( first < end && stored_record_date(records + first * LOTTO_RECORD_BYTES) < from_date )
+	{
+		first++;
+	}
+	while( end > first && stored_record_date(records + (end - 1) * LOTTO_RECORD_BYTES) > to_date )
+	{
+		end--;
+	}
+}
+
+db_file_writer_t::db_file_writer_t() : fd_(-1), buffer_(NULL), buffer_used_(0), bytes_written_(0),
+		crc_(0), db_(false), n_records_(0), first_date_(0), last_date_(0),
+		months_sorted_(true), header_pending_(false)
+{
+}
+
+db_file_writer_t::~db_file_writer_t()
+{
+	abort();
+}
+
+int32_t db_file_writer_t::open(const char *filename, uint64_t expected_bytes)
+{
+	abort();
+
+	filename_ = filename;
+	tmp_filename_ = filename_ + ".tmp";
+
+	void *buffer = NULL;
+	if( 0 != posix_memalign(&buffer, LOTTO_WRITE_BUFFER_ALIGN, LOTTO_WRITE_BUFFER_BYTES) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not allocate write buffer";
+		return -1;
+	}
+	buffer_ = (uint8_t *) buffer;
+	buffer_used_ = 0;
+	bytes_written_ = 0;
+	crc_ = 0;
+
+	fd_ = ::open(tmp_filename_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if( fd_ < 0 )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not open file " << tmp_filename_;
+		abort();
+		return -1;
+	}
+
+	// reserve the blocks up front, a file system not supporting it is no error
+	if( expected_bytes > 0 )
+	{
+		int ret = posix_fallocate(fd_, 0, (off_t) expected_bytes);
+		if( 0 != ret && EOPNOTSUPP != ret && EINVAL != ret )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: could not allocate " << expected_bytes << \
+					" bytes for file " << tmp_filename_;
+			abort();
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int32_t db_file_writer_t::open_append(const char *filename, uint64_t offset)
+{
+	if( open(filename, 0) )
+	{
+		return -1;
+	}
+	// the checksum goes on from the bytes kept before offset
+	return copy_prefix(offset, 0, false);
+}
+
+int32_t db_file_writer_t::open_db(const char *filename, uint64_t expected_records)
+{
+	const uint64_t expected_bytes = expected_records ? \
+			LOTTO_HEADER_BYTES + expected_records * LOTTO_RECORD_BYTES + LOTTO_TRAILER_BYTES : 0;
+	if( open(filename, expected_bytes) )
+	{
+		return -1;
+	}
+
+	// the header is filled in on commit
+	const uint8_t header[LOTTO_HEADER_BYTES] = { 0 };
+	if( buffer_bytes(header, sizeof(header)) )
+	{
+		abort();
+		return -1;
+	}
+	db_ = true;
+	n_records_ = 0;
+	first_date_ = 0;
+	last_date_ = 0;
+	months_sorted_ = true;
+	months_.clear();
+
+	return 0;
+}
+
+int32_t db_file_writer_t::open_db_append(const char *filename, uint64_t first_record)
+{
+	abort();
+
+	// the header is rewritten on commit, the one there tells the records kept
+	uint8_t head[LOTTO_HEADER_BYTES];
+	db_header_t header;
+	int fd = ::open(filename, O_RDONLY);
+	const bool valid = fd >= 0 && \
+		LOTTO_HEADER_BYTES == ::pread(fd, head, LOTTO_HEADER_BYTES, 0) && \
+		0 == decode_header(head, header) && \
+		LOTTO_DB_VERSION == header.version && \
+		first_record <= header.n_records;
+	if( fd >= 0 )
+		::close(fd);
+	if( !valid )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: " << filename << " is not a version " << LOTTO_DB_VERSION << \
+				" db with at least " << first_record << " records";
+		return -1;
+	}
+
+	if( open(filename, 0) )
+	{
+		return -1;
+	}
+	// checksum and month index of the records kept
+	db_ = true;
+	n_records_ = 0;
+	first_date_ = 0;
+	last_date_ = 0;
+	months_sorted_ = true;
+	months_.clear();
+	return copy_prefix(LOTTO_HEADER_BYTES + first_record * LOTTO_RECORD_BYTES, LOTTO_HEADER_BYTES, true);
+}
+
+// the temporary file starts with a copy of the first offset bytes of the
+// destination; the bytes from checksum_from on are checksummed and with
+// records set their dates go into the month index
+int32_t db_file_writer_t::copy_prefix(uint64_t offset, uint64_t checksum_from, bool records)
+{
+	int src_fd = ::open(filename_.c_str(), O_RDONLY);
+	off_t end = ( src_fd >= 0 ) ? ::lseek(src_fd, 0, SEEK_END) : -1;
+	if( end < 0 || offset > (uint64_t) end )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not read " << offset << " bytes of file " << filename_;
+		if( src_fd >= 0 )
+			::close(src_fd);
+		abort();
+		return -1;
+	}
+
+	// record aligned chunks, the buffer is a multiple of a record
+	for( uint64_t pos = 0; pos < offset; )
+	{
+		const size_t chunk = (size_t) std::min<uint64_t>(offset - pos, LOTTO_WRITE_BUFFER_BYTES);
+		size_t done = 0;
+		while( done < chunk )
+		{
+			ssize_t ret = ::pread(src_fd, buffer_ + done, chunk - done, (off_t) (pos + done));
+			if( ret <= 0 )
+			{
+				if( ret < 0 && EINTR == errno )
+					continue;
+				LOTTO_LOG(LOG_ERROR) << "Error: could not read file " << filename_;
+				::close(src_fd);
+				abort();
+				return -1;
+			}
+			done += (size_t) ret;
+		}
+
+		const size_t skip = ( pos < checksum_from ) ? (size_t) std::min<uint64_t>(checksum_from - pos, chunk) : 0;
+		crc_ = crc32c_update(crc_, buffer_ + skip, chunk - skip);
+		if(records)
+		{
+			for( size_t k = skip; k + LOTTO_RECORD_BYTES <= chunk; k += LOTTO_RECORD_BYTES )
+			{
+				add_record_date(stored_record_date(buffer_ + k));
+			}
+		}
+		buffer_used_ = chunk;
+		if( flush() )
+		{
+			::close(src_fd);
+			abort();
+			return -1;
+		}
+		pos += chunk;
+	}
+	::close(src_fd);
+
+	return 0;
+}
+
+// one more record in the db, months are entered as they start; a
+// month out of order makes the index unusable and it is left empty
+void db_file_writer_t::add_record_date(uint32_t date)
+{
+	const uint32_t key = make_month_key(date);
+	if( months_.empty() || key != months_.back().key )
+	{
+		if( !months_.empty() && key < months_.back().key )
+		{
+			months_sorted_ = false;
+		}
+		months_.push_back({ key, 0, n_records_ });
+	}
+	months_.back().n_records++;
+	if( 0 == n_records_ || date < first_date_ )
+	{
+		first_date_ = date;
+	}
+	if( date > last_date_ )
+	{
+		last_date_ = date;
+	}
+	n_records_++;
+}
+
+int32_t db_file_writer_t::write_records(const extraction_t *records, size_t n)
+{
+	if( fd_ < 0 )
+		return -1;
+
+	while( n > 0 )
+	{
+		// buffer_used_ might not be record aligned after write_bytes
+		size_t room = (LOTTO_WRITE_BUFFER_BYTES - buffer_used_) / LOTTO_RECORD_BYTES;
+		if( 0 == room )
+		{
+			if( flush() )
+				return -1;
+			continue;
+		}
+		size_t chunk = (n < room) ? n : room;
+		encode_records(records, chunk, buffer_ + buffer_used_);
+		crc_ = crc32c_update(crc_, buffer_ + buffer_used_, chunk * LOTTO_RECORD_BYTES);
+		if(db_)
+		{
+			for( size_t k = 0; k < chunk; k++ )
+			{
+				add_record_date(extraction_date(records[k]));
+			}
+		}
+		buffer_used_ += chunk * LOTTO_RECORD_BYTES;
+		records += chunk;
+		n -= chunk;
+	}
+
+	return 0;
+}
+
+int32_t db_file_writer_t::write_encoded_records(const uint8_t *bytes, size_t n)
+{
+	if( fd_ < 0 )
+		return -1;
+
+	if(db_)
+	{
+		for( size_t k = 0; k < n; k++ )
+		{
+			add_record_date(stored_record_date(bytes + k * LOTTO_RECORD_BYTES));
+		}
+	}
+	crc_ = crc32c_update(crc_, bytes, n * LOTTO_RECORD_BYTES);
+	return buffer_bytes(bytes, n * LOTTO_RECORD_BYTES);
+}
+
+int32_t db_file_writer_t::write_bytes(const void *data, size_t n)
+{
+	if( fd_ < 0 )
+		return -1;
+
+	crc_ = crc32c_update(crc_, (const uint8_t *) data, n);
+	return buffer_bytes(data, n);
+}
+
+int32_t db_file_writer_t::write_trailer()
+{
+	if( fd_ < 0 || !db_ )
+		return -1;
+
+	const uint64_t index_offset = LOTTO_HEADER_BYTES + n_records_ * LOTTO_RECORD_BYTES;
+	if( offset() != index_offset )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: records not aligned in file " << filename_;
+		return -1;
+	}
+
+	// neither the index nor the trailer are part of the checksum
+	if( !months_sorted_ )
+	{
+		LOTTO_LOG(LOG_WARN) << "Warning: records not in date order, no month index in file " << filename_;
+		months_.clear();
+	}
+	std::vector<uint8_t> months(months_.size() * LOTTO_MONTH_BYTES);
+	for( size_t k = 0; k < months_.size(); k++ )
+	{
+		uint8_t *entry = months.data() + k * LOTTO_MONTH_BYTES;
+		store_be(entry, months_[k].key, 4);
+		store_be(entry + 4, months_[k].n_records, 4);
+		store_be(entry + 8, months_[k].first_record, 8);
+	}
+
+	db_header_t header;
+	header.version = LOTTO_DB_VERSION;
+	header.n_records = n_records_;
+	header.first_date = first_date_;
+	header.last_date = last_date_;
+	header.index_offset = index_offset;
+	header.n_months = (uint32_t) months_.size();
+	header.index_crc = crc32c_update(0, months.data(), months.size());
+	encode_header(header, header_);
+	header_pending_ = true;
+
+	db_trailer_t trailer;
+	trailer.n_records = n_records_;
+	trailer.crc = crc_;
+	uint8_t trailer_bytes[LOTTO_TRAILER_BYTES];
+	encode_trailer(trailer, trailer_bytes);
+
+	if( buffer_bytes(months.data(), months.size()) )
+	{
+		return -1;
+	}
+	return buffer_bytes(trailer_bytes, sizeof(trailer_bytes));
+}
+
+int32_t db_file_writer_t::buffer_bytes(const void *data, size_t n)
+{
+	const uint8_t *src = (const uint8_t *) data;
+	while( n > 0 )
+	{
+		size_t room = LOTTO_WRITE_BUFFER_BYTES - buffer_used_;
+		if( 0 == room )
+		{
+			if( flush() )
+				return -1;
+			continue;
+		}
+		size_t chunk = (n < room) ? n : room;
+		std::memcpy(buffer_ + buffer_used_, src, chunk);
+		buffer_used_ += chunk;
+		src += chunk;
+		n -= chunk;
+	}
+
+	return 0;
+}
+
+int32_t db_file_writer_t::flush()
+{
+	size_t done = 0;
+	while( done < buffer_used_ )
+	{
+		ssize_t ret = ::write(fd_, buffer_ + done, buffer_used_ - done);
+		if( ret < 0 )
+		{
+			if( EINTR == errno )
+				continue;
+			LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << tmp_filename_ << \
+					": " << std::strerror(errno);
+			return -1;
+		}
+		done += (size_t) ret;
+	}
+	bytes_written_ += buffer_used_;
+	stats_add_bytes_written(buffer_used_);
+	buffer_used_ = 0;
+
+	return 0;
+}
+
+int32_t db_file_writer_t::commit()
+{
+	if( fd_ < 0 )
+		return -1;
+
+	if( flush() )
+	{
+		abort();
+		return -1;
+	}
+
+	// the header goes in last, once the records and index are known
+	if( header_pending_ && LOTTO_HEADER_BYTES != ::pwrite(fd_, header_, LOTTO_HEADER_BYTES, 0) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not write header of file " << tmp_filename_;
+		abort();
+		return -1;
+	}
+
+	// drop whatever was preallocated beyond the written data
+	if( 0 != ::ftruncate(fd_, (off_t) bytes_written_) || 0 != ::fsync(fd_) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not sync file " << tmp_filename_;
+		abort();
+		return -1;
+	}
+	::close(fd_);
+	fd_ = -1;
+
+	if( 0 != std::rename(tmp_filename_.c_str(), filename_.c_str()) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not rename " << tmp_filename_ << " to " << filename_;
+		abort();
+		return -1;
+	}
+
+	std::free(buffer_);
+	buffer_ = NULL;
+	buffer_used_ = 0;
+	tmp_filename_.clear();
+	db_ = false;
+	header_pending_ = false;
+	months_.clear();
+
+	return 0;
+}
+
+void db_file_writer_t::abort()
+{
+	db_ = false;
+	header_pending_ = false;
+	months_.clear();
+	if( fd_ >= 0 )
+	{
+		::close(fd_);
+		fd_ = -1;
+	}
+	if( !tmp_filename_.empty() )
+	{
+		::unlink(tmp_filename_.c_str());
+		tmp_filename_.clear();
+	}
+	std::free(buffer_);
+	buffer_ = NULL;
+	buffer_used_ = 0;
+}
@@ -0,0 +1,298 @@
+/*
+ * db_merge.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <boost/system/error_code.hpp>
+#include "basic_types.h"
+#include "db_io.h"
+#include "db_file.h"
+#include "mapped_file.h"
+#include "ritardo_index.h"
+#include "bitset_index.h"
+#include "logger.h"
+#include "db_merge.h"
+
+// an input of the merge, a db in key order or a sorted run of one,
+// decoded a buffer at a time
+typedef struct MERGE_CURSOR
+{
+	uint32_t                  input;   // index of the db in files_in
+	db_range_t                records;
+	uint64_t                  next;    // first record of the range not decoded yet
+	std::vector<extraction_t> buffer;
+	size_t                    pos;
+	size_t                    size;
+} merge_cursor_t;
+
+// decode the next records of the cursor, false when there are no more
+static bool cursor_fill(merge_cursor_t& cursor)
+{
+	cursor.pos = 0;
+	cursor.size = (size_t) std::min<uint64_t>(LOTTO_MERGE_BUFFER_RECORDS, cursor.records.size() - cursor.next);
+	cursor.records.decode(cursor.next, cursor.size, cursor.buffer.data());
+	cursor.next += cursor.size;
+	return cursor.size > 0;
+}
+
+static void add_cursor(std::vector<merge_cursor_t>& cursors, uint32_t input, const db_range_t& records)
+{
+	merge_cursor_t cursor;
+	cursor.input = input;
+	cursor.records = records;
+	cursor.next = 0;
+	cursor.buffer.resize(LOTTO_MERGE_BUFFER_RECORDS);
+	cursor.pos = 0;
+	cursor.size = 0;
+	cursors.push_back(std::move(cursor));
+}
+
+// true when the records are in key order, the same key side by side
+static bool range_sorted(const db_range_t& range)
+{
+	std::vector<extraction_t> buffer(LOTTO_MERGE_BUFFER_RECORDS);
+	uint64_t last_key = 0;
+	for( uint64_t i = 0; i < range.size(); i += LOTTO_MERGE_BUFFER_RECORDS )
+	{
+		const size_t n = (size_t) std::min<uint64_t>(LOTTO_MERGE_BUFFER_RECORDS, range.size() - i);
+		range.decode(i, n, buffer.data());
+		for( size_t k = 0; k < n; k++ )
+		{
+			if( buffer[k].key() < last_key )
+			{
+				return false;
+			}
+			last_key = buffer[k].key();
+		}
+	}
+	return true;
+}
+
+// cut the records of an unsorted db in runs sorted by key, written next
+// to the output and mapped as cursors; a run file is removed as soon as
+// it is mapped, the mapping stays
+static int32_t sort_runs(const db_range_t& range, uint32_t input, const boost::filesystem::path& file_out, uint32_t& n_runs,
+		std::vector<std::unique_ptr<mapped_file_t>>& runs, std::vector<merge_cursor_t>& cursors)
+{
+	std::vector<extraction_t> run;
+	for( uint64_t first = 0; first < range.size(); first += LOTTO_MERGE_RUN_RECORDS )
+	{
+		const size_t n = (size_t) std::min<uint64_t>(LOTTO_MERGE_RUN_RECORDS, range.size() - first);
+		run.resize(n);
+		range.decode(first, n, run.data());
+		// records with the same key keep the order of the db
+		std::stable_sort(run.begin(), run.end(), [](const extraction_t& a, const extraction_t& b){ return a.key() < b.key(); });
+
+		boost::filesystem::path file_run(file_out);
+		file_run += LOTTO_MERGE_RUN_SUFFIX + std::to_string(n_runs++);
+		db_file_writer_t writer;
+		if( writer.open(file_run.c_str(), n * LOTTO_RECORD_BYTES) || \
+			writer.write_records(run.data(), n) || \
+			writer.commit() )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: could not write the sorted run " << file_run.c_str();
+			return -1;
+		}
+		std::unique_ptr<mapped_file_t> mapped(new mapped_file_t());
+		const int32_t ret = mapped->open(file_run.c_str());
+		boost::system::error_code ec;
+		boost::filesystem::remove(file_run, ec);
+		if(ret)
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: could not map the sorted run " << file_run.c_str();
+			return -1;
+		}
+		add_cursor(cursors, input, db_range_t((const uint8_t *) mapped->data(), 0, n, false));
+		runs.push_back(std::move(mapped));
+	}
+	return 0;
+}
+
+int32_t merge_file_dbs(const std::vector<boost::filesystem::path>& files_in, const boost::filesystem::path& file_out,
+		merge_policy_t policy, import_stats_t& stats)
+{
+	// the output is written anew, it is never one of the inputs nor any
+	// other file already there
+	boost::system::error_code ec;
+	for( const auto& file_in : files_in )
+	{
+		if( boost::filesystem::equivalent(file_in, file_out, ec) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error! file " << file_out.c_str() << " is also an input of the merge.";
+			return -1;
+		}
+	}
+	if( boost::filesystem::exists(file_out) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! file " << file_out.c_str() << " already exists.";
+		return -1;
+	}
+
+	// inputs in the order given, the cursors of a db follow each other
+	// so that the order of the cursors is the one of the records
+	std::vector<std::unique_ptr<db_reader_t>> readers;
+	std::vector<std::unique_ptr<mapped_file_t>> runs;
+	std::vector<merge_cursor_t> cursors;
+	uint64_t n_records = 0;
+	uint32_t n_runs = 0;
+	stats.begin("sort");
+	for( uint32_t i = 0; i < files_in.size(); i++ )
+	{
+		std::unique_ptr<db_reader_t> reader(new db_reader_t());
+		if( reader->open(files_in[i].c_str()) )
+		{
+			return -1;
+		}
+		const db_range_t records = reader->records();
+		n_records += records.size();
+		if( range_sorted(records) )
+		{
+			add_cursor(cursors, i, records);
+		}
+		else
+		{
+			LOTTO_LOG(LOG_INFO) << files_in[i].c_str() << ": " << records.size() << " records not in key order, sorting them in runs";
+			if( sort_runs(records, i, file_out, n_runs, runs, cursors) )
+			{
+				return -1;
+			}
+		}
+		readers.push_back(std::move(reader));
+	}
+	stats.end(n_records);
+
+	// min-heap of the cursors on their next record, ties to the earlier cursor
+	auto after = [&cursors](uint32_t a, uint32_t b)
+	{
+		const uint64_t key_a = cursors[a].buffer[cursors[a].pos].key();
+		const uint64_t key_b = cursors[b].buffer[cursors[b].pos].key();
+		return key_a > key_b || ( key_a == key_b && a > b );
+	};
+	std::vector<uint32_t> heap;
+	for( uint32_t c = 0; c < cursors.size(); c++ )
+	{
+		if( cursor_fill(cursors[c]) )
+		{
+			heap.push_back(c);
+		}
+	}
+	std::make_heap(heap.begin(), heap.end(), after);
+
+	stats.begin("merge");
+	db_file_writer_t writer;
+	if( writer.open_db(file_out.c_str(), n_records) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not open file " << file_out.c_str();
+		return -1;
+	}
+	std::vector<extraction_t> out;
+	out.reserve(LOTTO_MERGE_BUFFER_RECORDS);
+	uint64_t n_written = 0;
+	uint64_t n_same = 0;
+	uint64_t n_conflicts = 0;
+	bool have = false;
+	extraction_t chosen = { 0 };
+	uint32_t chosen_input = 0;
+	while( !heap.empty() )
+	{
+		std::pop_heap(heap.begin(), heap.end(), after);
+		merge_cursor_t& cursor = cursors[heap.back()];
+		const extraction_t ex = cursor.buffer[cursor.pos++];
+		const uint32_t input = cursor.input;
+		if( cursor.pos < cursor.size || cursor_fill(cursor) )
+			std::push_heap(heap.begin(), heap.end(), after);
+		else
+			heap.pop_back();
+
+		if( have && ex.key() == chosen.key() )
+		{
+			if( ex.raw == chosen.raw )
+			{
+				n_same++;
+				continue;
+			}
+			n_conflicts++;
+			if( MERGE_FAIL == policy )
+			{
+				LOTTO_LOG(LOG_ERROR) << "Error: " << files_in[chosen_input].c_str() << " and " << files_in[input].c_str() << \
+						" hold different records of the same draw and ruota, choose one with --duplicates first|last";
+				print_extraction("First:", chosen);
+				print_extraction("Then:", ex);
+				return -1;
+			}
+			if( MERGE_KEEP_LAST == policy )
+			{
+				chosen = ex;
+				chosen_input = input;
+			}
+			continue;
+		}
+
+		if(have)
+		{
+			out.push_back(chosen);
+			if( out.size() == LOTTO_MERGE_BUFFER_RECORDS )
+			{
+				if( writer.write_records(out.data(), out.size()) )
+				{
+					LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_out.c_str();
+					return -1;
+				}
+				n_written += out.size();
+				out.clear();
+			}
+		}
+		chosen = ex;
+		chosen_input = input;
+		have = true;
+	}
+	if(have)
+	{
+		out.push_back(chosen);
+	}
+	if( writer.write_records(out.data(), out.size()) || \
+		writer.write_trailer() || \
+		writer.commit() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_out.c_str();
+		return -1;
+	}
+	n_written += out.size();
+	stats.end(n_written);
+
+	LOTTO_LOG(LOG_INFO) << "merged " << files_in.size() << " dbs, " << n_records << " records in " << \
+			n_runs << " sorted runs and " << (cursors.size() - n_runs) << " sorted dbs";
+	LOTTO_LOG(LOG_INFO) << "records written: " << n_written << ", the same record again: " << n_same << \
+			", different records of one draw and ruota: " << n_conflicts;
+
+	stats.begin("verify");
+	uint64_t file_records = 0;
+	uint32_t file_crc = 0;
+	if( verify_file_db_checksum(file_out, file_records, file_crc) || file_records != n_written )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from verify_file_db." << " abort.";
+		return -1;
+	}
+	stats.end(n_written);
+
+	stats.begin("indexes");
+	ritardo_index_t index;
+	if( build_ritardo_index(file_out, index) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from build_ritardo_index." << " abort.";
+		return -1;
+	}
+	if( build_bitset_index(file_out) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from build_bitset_index." << " abort.";
+		return -1;
+	}
+	stats.end(n_written);
+
+	return 0;
+}
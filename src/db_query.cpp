@@ -0,0 +1,159 @@
+/*
+ * db_query.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstring>
+#include <iostream>
+#include "db_io.h"
+#include "db_file.h"
+#include "utilities.h"
+#include "db_query.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LOTTO_HAVE_X86_SIMD
+#endif
+
+// positions of the ruota and of the five numbers in a stored word, the
+// date is at LOTTO_SHIFT_DATE in both layouts
+typedef struct RECORD_SHIFTS
+{
+	uint32_t ruota;
+	uint32_t numbers[5];
+} record_shifts_t;
+
+static const record_shifts_t current_shifts = { LOTTO_SHIFT_RUOTA,
+		{ LOTTO_SHIFT_A, LOTTO_SHIFT_B, LOTTO_SHIFT_C, LOTTO_SHIFT_D, LOTTO_SHIFT_E } };
+static const record_shifts_t legacy_shifts = { LOTTO_LEGACY_SHIFT_RUOTA,
+		{ LOTTO_LEGACY_SHIFT_A, LOTTO_LEGACY_SHIFT_B, LOTTO_LEGACY_SHIFT_C, LOTTO_LEGACY_SHIFT_D, LOTTO_LEGACY_SHIFT_E } };
+
+// histogram bins: ruota << 7 | number, plus a bin for the records
+// out of the date range, replicated per lane to avoid store conflicts
+#define LOTTO_BINS           (16 << 7)
+#define LOTTO_DISCARD_BIN    (LOTTO_BINS - 1)
+#define LOTTO_LANES          (4)
+
+static void count_scalar(const uint8_t *records, uint64_t n_records, const record_shifts_t& shifts,
+		uint64_t from_key, uint64_t to_key, uint32_t *bins, uint64_t& in_range)
+{
+	for( uint64_t i = 0; i < n_records; i++ )
+	{
+		const uint64_t word = load_be(records + i * LOTTO_RECORD_BYTES, LOTTO_RECORD_BYTES);
+		const uint64_t key = word >> LOTTO_SHIFT_DATE;
+		if( key < from_key || key > to_key )
+			continue;
+		const uint32_t base = (uint32_t) ( (word >> shifts.ruota) & LOTTO_MASK_RUOTA ) << 7;
+		for( int k = 0; k < 5; k++ )
+		{
+			bins[base | ( (word >> shifts.numbers[k]) & LOTTO_MASK_NUMBER )]++;
+		}
+		in_range++;
+	}
+}
+
+#ifdef LOTTO_HAVE_X86_SIMD
+
+// four records per iteration: byte swap, date filter and the five bin
+// indexes are computed in vector registers, only the increments are scalar
+__attribute__((target("avx2,popcnt")))
+static uint64_t count_avx2(const uint8_t *records, uint64_t n_records, const record_shifts_t& shifts,
+		uint64_t from_key, uint64_t to_key, uint32_t *bins)
+{
+	const __m256i bswap = _mm256_set_epi8(
+			 8,  9, 10, 11, 12, 13, 14, 15,  0,  1,  2,  3,  4,  5,  6,  7,
+			 8,  9, 10, 11, 12, 13, 14, 15,  0,  1,  2,  3,  4,  5,  6,  7);
+	const __m256i from = _mm256_set1_epi64x((long long) from_key - 1);
+	const __m256i to = _mm256_set1_epi64x((long long) to_key + 1);
+	const __m256i mask_ruota = _mm256_set1_epi64x(LOTTO_MASK_RUOTA);
+	const __m256i mask_number = _mm256_set1_epi64x(LOTTO_MASK_NUMBER);
+	const __m128i shift_ruota = _mm_cvtsi32_si128((int) shifts.ruota);
+	const __m256i discard = _mm256_set1_epi64x(LOTTO_DISCARD_BIN);
+	const __m256i lane_offset = _mm256_set_epi64x(3 * LOTTO_BINS, 2 * LOTTO_BINS, 1 * LOTTO_BINS, 0);
+
+	uint64_t in_range = 0;
+	alignas(32) uint64_t idx[5][4];
+	for( uint64_t i = 0; i + 4 <= n_records; i += 4 )
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i *) (records + i * LOTTO_RECORD_BYTES));
+		v = _mm256_shuffle_epi8(v, bswap);
+
+		const __m256i key = _mm256_srli_epi64(v, LOTTO_SHIFT_DATE);
+		const __m256i inside = _mm256_and_si256(_mm256_cmpgt_epi64(key, from), _mm256_cmpgt_epi64(to, key));
+		in_range += (uint64_t) __builtin_popcount((unsigned) _mm256_movemask_pd(_mm256_castsi256_pd(inside)));
+
+		const __m256i base = _mm256_slli_epi64(_mm256_and_si256(_mm256_srl_epi64(v, shift_ruota), mask_ruota), 7);
+		for( int k = 0; k < 5; k++ )
+		{
+			__m256i number = _mm256_and_si256(_mm256_srl_epi64(v, _mm_cvtsi32_si128((int) shifts.numbers[k])), mask_number);
+			__m256i bin = _mm256_blendv_epi8(discard, _mm256_or_si256(base, number), inside);
+			_mm256_store_si256((__m256i *) idx[k], _mm256_add_epi64(bin, lane_offset));
+		}
+		for( int k = 0; k < 5; k++ )
+		{
+			bins[idx[k][0]]++;
+			bins[idx[k][1]]++;
+			bins[idx[k][2]]++;
+			bins[idx[k][3]]++;
+		}
+	}
+
+	return in_range;
+}
+
+#endif // LOTTO_HAVE_X86_SIMD
+
+void compute_frequencies(const db_range_t& range, uint32_t from_date, uint32_t to_date, frequency_table_t& table)
+{
+	const uint8_t *records = range.bytes();
+	const uint64_t n_records = range.size();
+	const record_shifts_t& shifts = range.legacy() ? legacy_shifts : current_shifts;
+
+	std::memset(&table, 0, sizeof(table));
+	std::vector<uint32_t> bins(LOTTO_LANES * LOTTO_BINS, 0);
+
+	uint64_t in_range = 0;
+	uint64_t done = 0;
+#ifdef LOTTO_HAVE_X86_SIMD
+	static const bool has_avx2 = __builtin_cpu_supports("avx2");
+	if( has_avx2 )
+	{
+		done = n_records & ~(uint64_t) 3;
+		in_range = count_avx2(records, done, shifts, from_date, to_date, bins.data());
+	}
+#endif
+	count_scalar(records + done * LOTTO_RECORD_BYTES, n_records - done, shifts, from_date, to_date, bins.data(), in_range);
+
+	// fold the lanes, number 0 is a missing number and ruota TUTTE sums all
+	for( uint32_t r = 0; r < ruota_t::TUTTE; r++ )
+	{
+		for( uint32_t number = 1; number <= 90; number++ )
+		{
+			uint32_t count = 0;
+			for( uint32_t lane = 0; lane < LOTTO_LANES; lane++ )
+			{
+				count += bins[lane * LOTTO_BINS + (r << 7) + number];
+			}
+			table.counts[r][number] = count;
+			table.counts[ruota_t::TUTTE][number] += count;
+		}
+	}
+	table.n_records = in_range;
+}
+
+int32_t query_frequencies(const boost::filesystem::path& file_db, uint32_t from_date, uint32_t to_date, frequency_table_t& table)
+{
+	db_reader_t reader;
+	if( reader.open(file_db.c_str()) )
+	{
+		return -1;
+	}
+
+	// only the months of the range are read
+	const db_range_t range = reader.range(from_date, to_date);
+	compute_frequencies(range, from_date, to_date, table);
+
+	return 0;
+}
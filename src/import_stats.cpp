@@ -0,0 +1,177 @@
+/*
+ * import_stats.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <time.h>
+#include <sys/resource.h>
+#include <cstdlib>
+#include <atomic>
+#include <new>
+#include "import_stats.h"
+
+static std::atomic<uint64_t> counted_bytes_read(0);
+static std::atomic<uint64_t> counted_bytes_written(0);
+static std::atomic<uint64_t> counted_allocations(0);
+static std::atomic<uint64_t> counted_allocated_bytes(0);
+
+// every allocation of the program goes through here to be counted
+static inline void *counted_malloc(std::size_t size)
+{
+	counted_allocations.fetch_add(1, std::memory_order_relaxed);
+	counted_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+	return std::malloc(size ? size : 1);
+}
+
+void *operator new(std::size_t size)
+{
+	void *p = counted_malloc(size);
+	if( NULL == p )
+		throw std::bad_alloc();
+	return p;
+}
+
+void *operator new[](std::size_t size)
+{
+	void *p = counted_malloc(size);
+	if( NULL == p )
+		throw std::bad_alloc();
+	return p;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return counted_malloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return counted_malloc(size);
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void stats_add_bytes_read(uint64_t n)
+{
+	counted_bytes_read.fetch_add(n, std::memory_order_relaxed);
+}
+
+void stats_add_bytes_written(uint64_t n)
+{
+	counted_bytes_written.fetch_add(n, std::memory_order_relaxed);
+}
+
+static uint64_t clock_ns(clockid_t clock)
+{
+	struct timespec ts;
+	::clock_gettime(clock, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+stats_sample_t stats_sample()
+{
+	stats_sample_t sample;
+	sample.wall_ns = clock_ns(CLOCK_MONOTONIC);
+	sample.cpu_ns = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+	sample.bytes_read = counted_bytes_read.load(std::memory_order_relaxed);
+	sample.bytes_written = counted_bytes_written.load(std::memory_order_relaxed);
+	sample.allocations = counted_allocations.load(std::memory_order_relaxed);
+	sample.allocated_bytes = counted_allocated_bytes.load(std::memory_order_relaxed);
+	return sample;
+}
+
+uint64_t stats_peak_rss_kb()
+{
+	struct rusage usage;
+	if( ::getrusage(RUSAGE_SELF, &usage) )
+		return 0;
+	return (uint64_t) usage.ru_maxrss;
+}
+
+import_stats_t::import_stats_t() : start_(stats_sample()), phase_start_(start_)
+{
+}
+
+void import_stats_t::begin(const char *name)
+{
+	phase_name_ = name;
+	phase_start_ = stats_sample();
+}
+
+void import_stats_t::end(uint64_t records)
+{
+	const stats_sample_t now = stats_sample();
+	phase_stats_t phase;
+	phase.name = phase_name_;
+	phase.wall_ns = now.wall_ns - phase_start_.wall_ns;
+	phase.cpu_ns = now.cpu_ns - phase_start_.cpu_ns;
+	phase.records = records;
+	phase.bytes_read = now.bytes_read - phase_start_.bytes_read;
+	phase.bytes_written = now.bytes_written - phase_start_.bytes_written;
+	phase.allocations = now.allocations - phase_start_.allocations;
+	phase.allocated_bytes = now.allocated_bytes - phase_start_.allocated_bytes;
+	phase.peak_rss_kb = stats_peak_rss_kb();
+	phases_.push_back(phase);
+}
+
+static double records_per_second(uint64_t records, uint64_t wall_ns)
+{
+	return wall_ns ? (double) records * 1e9 / (double) wall_ns : 0.0;
+}
+
+void import_stats_t::print(stats_format_t format, std::ostream& out) const
+{
+	const stats_sample_t now = stats_sample();
+	if( STATS_JSON == format )
+	{
+		// one line, the phase names are plain identifiers
+		out << "{\"phases\":[";
+		for( size_t i = 0; i < phases_.size(); i++ )
+		{
+			const phase_stats_t& p = phases_[i];
+			out << ( i ? "," : "" ) << "{\"name\":\"" << p.name << "\"" << \
+					",\"wall_ns\":" << p.wall_ns << ",\"cpu_ns\":" << p.cpu_ns << \
+					",\"records\":" << p.records << ",\"records_per_s\":" << (uint64_t) records_per_second(p.records, p.wall_ns) << \
+					",\"bytes_read\":" << p.bytes_read << ",\"bytes_written\":" << p.bytes_written << \
+					",\"allocations\":" << p.allocations << ",\"allocated_bytes\":" << p.allocated_bytes << \
+					",\"peak_rss_kb\":" << p.peak_rss_kb << "}";
+		}
+		out << "],\"wall_ns\":" << (now.wall_ns - start_.wall_ns) << ",\"cpu_ns\":" << (now.cpu_ns - start_.cpu_ns) << \
+				",\"allocations\":" << (now.allocations - start_.allocations) << \
+				",\"peak_rss_kb\":" << stats_peak_rss_kb() << "}" << std::endl;
+		return;
+	}
+
+	if( STATS_TEXT == format )
+	{
+		for( const phase_stats_t& p : phases_ )
+		{
+			out << "stats " << p.name << ": wall " << (p.wall_ns / 1000) << " us, cpu " << (p.cpu_ns / 1000) << " us, " << \
+					p.records << " records, " << (uint64_t) records_per_second(p.records, p.wall_ns) << " records/s, read " << \
+					p.bytes_read << " bytes, written " << p.bytes_written << " bytes, " << p.allocations << " allocations (" << \
+					p.allocated_bytes << " bytes), peak rss " << p.peak_rss_kb << " kB" << std::endl;
+		}
+		out << "stats total: wall " << ((now.wall_ns - start_.wall_ns) / 1000) << " us, cpu " << \
+				((now.cpu_ns - start_.cpu_ns) / 1000) << " us, peak rss " << stats_peak_rss_kb() << " kB" << std::endl;
+	}
+}
@@ -0,0 +1,167 @@
+/*
+ * logger.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "logger.h"
+
+// bytes gathered by the writer thread before a write
+#define LOTTO_LOG_BATCH_BYTES    (64 * 1024)
+// longest sleep of the writer thread when there is nothing to write
+#define LOTTO_LOG_IDLE_US        (20000)
+
+std::atomic<int32_t> log_threshold(LOG_INFO);
+
+// bounded ring in the manner of D. Vyukov: the sequence of a slot tells
+// whether it is free for the ticket of a producer or holds a line for
+// the consumer, producers claim tickets with a compare and swap
+typedef struct LOG_SLOT
+{
+	std::atomic<uint64_t> sequence;
+	uint32_t              size;
+	char                  text[LOTTO_LOG_LINE_BYTES];
+} log_slot_t;
+
+class log_ring_t
+{
+public:
+	log_ring_t() : head_(0), tail_(0), written_(0), stop_(false)
+	{
+		for( uint64_t i = 0; i < LOTTO_LOG_RING_SLOTS; i++ )
+		{
+			slots_[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		writer_ = std::thread([this](){ run(); });
+	}
+
+	// the lines still queued are written at exit
+	~log_ring_t()
+	{
+		stop_ = true;
+		writer_.join();
+	}
+
+	void push(const char *text, size_t size)
+	{
+		uint64_t ticket = head_.load(std::memory_order_relaxed);
+		log_slot_t *slot;
+		while( true )
+		{
+			slot = &slots_[ticket & (LOTTO_LOG_RING_SLOTS - 1)];
+			const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+			const int64_t diff = (int64_t) sequence - (int64_t) ticket;
+			if( 0 == diff )
+			{
+				if( head_.compare_exchange_weak(ticket, ticket + 1, std::memory_order_relaxed) )
+					break;
+			}
+			else if( diff < 0 )
+			{
+				// full, the writer is behind
+				std::this_thread::yield();
+				ticket = head_.load(std::memory_order_relaxed);
+			}
+			else
+			{
+				ticket = head_.load(std::memory_order_relaxed);
+			}
+		}
+		std::memcpy(slot->text, text, size);
+		slot->size = (uint32_t) size;
+		slot->sequence.store(ticket + 1, std::memory_order_release);
+	}
+
+	void flush()
+	{
+		const uint64_t target = head_.load(std::memory_order_acquire);
+		while( written_.load(std::memory_order_acquire) < target )
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+	}
+
+private:
+	// write what is queued, false when there was nothing
+	bool drain(char *batch)
+	{
+		size_t used = 0;
+		while( used + LOTTO_LOG_LINE_BYTES <= LOTTO_LOG_BATCH_BYTES )
+		{
+			log_slot_t& slot = slots_[tail_ & (LOTTO_LOG_RING_SLOTS - 1)];
+			if( slot.sequence.load(std::memory_order_acquire) != tail_ + 1 )
+				break;
+			std::memcpy(batch + used, slot.text, slot.size);
+			used += slot.size;
+			slot.sequence.store(tail_ + LOTTO_LOG_RING_SLOTS, std::memory_order_release);
+			tail_++;
+		}
+		if( 0 == used )
+			return false;
+		std::fwrite(batch, 1, used, stdout);
+		std::fflush(stdout);
+		written_.store(tail_, std::memory_order_release);
+		return true;
+	}
+
+	void run()
+	{
+		static char batch[LOTTO_LOG_BATCH_BYTES];
+		uint32_t idle_us = 50;
+		while( true )
+		{
+			const bool stopping = stop_;
+			if( drain(batch) )
+			{
+				idle_us = 50;
+				continue;
+			}
+			if(stopping)
+				break;
+			std::this_thread::sleep_for(std::chrono::microseconds(idle_us));
+			idle_us = std::min<uint32_t>(idle_us * 2, LOTTO_LOG_IDLE_US);
+		}
+	}
+
+	log_slot_t            slots_[LOTTO_LOG_RING_SLOTS];
+	std::atomic<uint64_t> head_;     // next ticket of a producer
+	uint64_t              tail_;     // next slot of the writer
+	std::atomic<uint64_t> written_;  // lines written so far
+	std::atomic<bool>     stop_;
+	std::thread           writer_;
+};
+
+// started with the first line, stopped after main returns
+static log_ring_t& log_ring()
+{
+	static log_ring_t ring;
+	return ring;
+}
+
+void log_set_level(log_level_t threshold)
+{
+	log_threshold.store((int32_t) threshold, std::memory_order_relaxed);
+}
+
+log_level_t log_get_level()
+{
+	return (log_level_t) log_threshold.load(std::memory_order_relaxed);
+}
+
+void log_flush()
+{
+	log_ring().flush();
+	std::fflush(stdout);
+}
+
+log_line_t::~log_line_t()
+{
+	const size_t size = buf_.end_line();
+	log_ring().push(buf_.text(), size);
+}
@@ -8,50 +8,320 @@
 
 #include <stdio.h>
 #include <iostream>
-#include <fstream>
+#include <iomanip>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <errno.h>
 #include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include <boost/filesystem.hpp>
-#include <boost/tokenizer.hpp>
 #include "basic_types.h"
 #include "utilities.h"
+#include "benchmarks.h"
+#include "db_io.h"
+#include "db_file.h"
+#include "year_parser.h"
+#include "year_generator.h"
+#include "crc32c.h"
+#include "db_columnar.h"
+#include "db_compressed.h"
+#include "bounded_queue.h"
+#include "db_query.h"
+#include "ritardo_index.h"
+#include "bitset_index.h"
+#include "cooccurrence.h"
+#include "import_stats.h"
+#include "query_daemon.h"
+#include "year_watcher.h"
+#include "parse_cache.h"
+#include "db_merge.h"
+#include "logger.h"
 
 #define LOTTO_START_YEAR   (1871)
 #define LOTTO_END_YEAR     (2020)
 
+// years waiting between two stages of the streaming import
+#define LOTTO_STREAM_QUEUE_DEPTH    (4)
+
+typedef struct OPTIONS
+{
+	uint32_t    jobs;           // number of worker threads parsing year files, 1 = serial
+	bool        stream;         // parse, encode and write years through bounded queues
+	bool        append;         // append the draws newer than the last one in an existing db
+	bool        watch;          // after the import splice the year files written again
+	bool        cache;          // keep the parsed years in the parse cache
+	std::string bulk;           // history file holding every year, instead of the year files
+	uint32_t    repeat;         // benchmark repetitions, 0 for the benchmark default
+	bool        generate;       // write synthetic year files start_year to end_year
+	uint32_t    draws;          // draws per synthetic year
+	uint64_t    seed;           // of the synthetic years
+	bool        bench_import;   // time the import phases of start_year to end_year
+	std::string bench_scanner;  // year file for the record scanner benchmark
+	std::string verify;         // db file to verify against its checksum
+	std::string info;           // db file to describe from its header
+	std::string columnar;       // columnar export written next to the db
+	std::string compressed;     // compressed block export written next to the db
+	std::string compress;       // db file to write in the compressed block format
+	std::string decompress;     // compressed file to write back as a db
+	std::string convert;        // db file of any version to rewrite as a current one
+	std::string merge;          // db file written with the records of the dbs given
+	merge_policy_t duplicates;  // how the merge settles different records of one draw and ruota
+	std::string bench_decode;   // compressed file for the block decode benchmark
+	std::string serve;          // db file to serve to the query daemon clients
+	std::string socket;         // socket of the query daemon
+	std::string bench_daemon;   // socket of the daemon to benchmark
+	std::string frequency;      // db file to count the drawn numbers of
+	std::string ritardo;        // db file to report the delays of
+	std::string combo;          // db file to count the draws holding all the numbers in
+	std::vector<uint32_t> numbers;  // numbers of the combination
+	ruota_t     ruota;          // ruota of the combination, UNKNOWN for all
+	std::string cooccurrence;   // db file to build the pair co-occurrence matrices of
+	std::string csv;            // co-occurrence matrices output, also written by an import
+	std::vector<date_window_t> windows;  // date windows of the co-occurrence matrices
+	uint32_t    from_date;      // first date of the query, as make_date()
+	uint32_t    to_date;        // last date of the query, as make_date()
+	stats_format_t stats;       // per-phase statistics of the import
+	log_level_t log_level;      // diagnostics written, lowered by --quiet and raised by --verbose
+} options_t;
+
+typedef struct YEAR_BLOCK
+{
+	uint32_t                  year;
+	std::vector<extraction_t> records;
+} year_block_t;
+
+typedef struct ENCODED_BLOCK
+{
+	uint32_t             year;
+	std::vector<uint8_t> bytes;
+} encoded_block_t;
+
 std::vector<std::string> parse_arguments(int argc, char *argv[]);
+int32_t parse_options(std::vector<std::string>& arguments, options_t& options);
+int32_t parse_option_value(const std::vector<std::string>& arguments, size_t& i, std::string& value);
+int32_t parse_option_uint(const std::vector<std::string>& arguments, size_t& i, uint32_t& value);
+int32_t parse_option_numbers(const std::vector<std::string>& arguments, size_t& i, std::vector<uint32_t>& numbers);
+bool parse_date(const std::string& str, bool last, uint32_t& date);
+int32_t parse_option_date(const std::vector<std::string>& arguments, size_t& i, bool last, uint32_t& date);
+int32_t parse_option_window(const std::vector<std::string>& arguments, size_t& i, date_window_t& window);
 void print_usage(int argc, char *argv[]);
-int32_t process_all_files(const boost::filesystem::path& file_db, uint32_t start_year, uint32_t end_year);
-int32_t process_file(std::vector<extraction_t>& extraction_vec, uint32_t year);
-uint64_t convert_number_non_zero(std::string number_str);
-int32_t save_file_db(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_db);
-int32_t verify_file_db(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_db);
+int32_t process_all_files(const boost::filesystem::path& file_db, uint32_t start_year, uint32_t end_year, const options_t& options,
+		import_stats_t& stats);
+int32_t append_all_files(const boost::filesystem::path& file_db, uint32_t start_year, uint32_t end_year, const options_t& options,
+		import_stats_t& stats);
+int32_t process_all_files_streaming(const boost::filesystem::path& file_db, uint32_t start_year, uint32_t end_year, uint32_t jobs,
+		bool cached, import_stats_t& stats);
+int32_t print_file_db_info(const boost::filesystem::path& file_db);
+int32_t compress_file_db(const boost::filesystem::path& file_db);
+int32_t decompress_file_db(const boost::filesystem::path& file_z);
+void print_frequencies(const frequency_table_t& table);
+void print_ritardo(const ritardo_index_t& index);
+void print_combo(const options_t& options, const combo_result_t& result);
+void print_cooccurrence(const std::vector<date_window_t>& windows, const std::vector<cooccurrence_matrix_t>& matrices);
 
 int main(int argc, char *argv[])
 {
-	std::cout << "!!! this is lotto_importer !!!" << std::endl;
+    std::vector<std::string> arguments = parse_arguments(argc, argv);
+
+    // strip options, leave positional arguments
+    options_t options;
+    if( parse_options(arguments, options) )
+    {
+		print_usage(argc, argv);
+		return -1;
+    }
+    log_set_level(options.log_level);
+	LOTTO_LOG(LOG_INFO) << "!!! this is lotto_importer !!!";
+
+    if( !options.verify.empty() )
+    {
+    	uint64_t n_records = 0;
+    	uint32_t crc = 0;
+    	int32_t ret = verify_file_db_checksum(boost::filesystem::path(options.verify), n_records, crc);
+    	if( 0 == ret )
+    	{
+    		log_flush();
+    		std::cout << options.verify << ": " << n_records << " records, crc32c " << crc << " ok" << std::endl;
+    	}
+    	return ret;
+    }
+
+    if( !options.info.empty() )
+    {
+    	return print_file_db_info(boost::filesystem::path(options.info));
+    }
+
+    if( !options.frequency.empty() )
+    {
+    	frequency_table_t table;
+    	auto t_start = std::chrono::steady_clock::now();
+    	int32_t ret = query_frequencies(boost::filesystem::path(options.frequency), options.from_date, options.to_date, table);
+    	auto t_end = std::chrono::steady_clock::now();
+    	if( 0 == ret )
+    	{
+    		print_frequencies(table);
+    		std::cout << "query time: " << std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start).count() << " us" << std::endl;
+    	}
+    	return ret;
+    }
+
+    if( !options.ritardo.empty() )
+    {
+    	const boost::filesystem::path file_db(options.ritardo);
+    	ritardo_index_t index;
+    	auto t_start = std::chrono::steady_clock::now();
+    	int32_t ret = load_current_ritardo_index(file_db, index);
+    	if(ret)
+    	{
+    		LOTTO_LOG(LOG_INFO) << "ritardo index missing or out of date, rebuilding it";
+    		ret = build_ritardo_index(file_db, index);
+    	}
+    	auto t_end = std::chrono::steady_clock::now();
+    	if( 0 == ret )
+    	{
+    		print_ritardo(index);
+    		std::cout << "query time: " << std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start).count() << " us" << std::endl;
+    	}
+    	return ret;
+    }
+
+    if( !options.combo.empty() )
+    {
+    	combo_result_t result;
+    	auto t_start = std::chrono::steady_clock::now();
+    	int32_t ret = query_combo(boost::filesystem::path(options.combo), options.numbers.data(), options.numbers.size(),
+    			options.ruota, options.from_date, options.to_date, result);
+    	auto t_end = std::chrono::steady_clock::now();
+    	if( 0 == ret )
+    	{
+    		print_combo(options, result);
+    		std::cout << "query time: " << std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start).count() << " us" << std::endl;
+    	}
+    	return ret;
+    }
+
+    if( !options.cooccurrence.empty() )
+    {
+    	std::vector<cooccurrence_matrix_t> matrices;
+    	auto t_start = std::chrono::steady_clock::now();
+    	int32_t ret = query_cooccurrence(boost::filesystem::path(options.cooccurrence), options.windows, options.jobs, matrices);
+    	auto t_end = std::chrono::steady_clock::now();
+    	if( 0 == ret )
+    	{
+    		print_cooccurrence(options.windows, matrices);
+    		std::cout << "query time: " << std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start).count() << " us" << std::endl;
+    		if( !options.csv.empty() )
+    		{
+    			ret = save_cooccurrence_csv(matrices, boost::filesystem::path(options.csv));
+    		}
+    	}
+    	return ret;
+    }
+
+    if( !options.compress.empty() )
+    {
+    	return compress_file_db(boost::filesystem::path(options.compress));
+    }
+
+    if( !options.decompress.empty() )
+    {
+    	return decompress_file_db(boost::filesystem::path(options.decompress));
+    }
+
+    if( !options.convert.empty() )
+    {
+    	if( 2 != arguments.size() )
+    	{
+    		print_usage(argc, argv);
+    		return -1;
+    	}
+    	return convert_file_db(boost::filesystem::path(options.convert), boost::filesystem::path(arguments[1]));
+    }
+
+    if( !options.merge.empty() )
+    {
+    	if( arguments.size() < 2 )
+    	{
+    		print_usage(argc, argv);
+    		return -1;
+    	}
+    	std::vector<boost::filesystem::path> files_in(arguments.begin() + 1, arguments.end());
+    	import_stats_t stats;
+    	int32_t ret = merge_file_dbs(files_in, boost::filesystem::path(options.merge), options.duplicates, stats);
+    	log_flush();
+    	stats.print(options.stats, std::cout);
+    	return ret;
+    }
+
+    if( !options.bench_scanner.empty() )
+    {
+    	return bench_record_scanner(boost::filesystem::path(options.bench_scanner), options.repeat);
+    }
+
+    if( !options.bench_decode.empty() )
+    {
+    	return bench_decode_compressed(boost::filesystem::path(options.bench_decode), options.repeat);
+    }
+
+    if( !options.serve.empty() )
+    {
+    	boost::filesystem::path socket_path(options.socket);
+    	if( socket_path.empty() )
+    	{
+    		socket_path = boost::filesystem::path(options.serve + LOTTO_DAEMON_SOCKET_SUFFIX);
+    	}
+    	return serve_db(boost::filesystem::path(options.serve), socket_path);
+    }
+
+    if( !options.bench_daemon.empty() )
+    {
+    	return bench_daemon(boost::filesystem::path(options.bench_daemon), options.repeat);
+    }
+
+    // synthetic years are not bound to the history
+    if( options.generate || options.bench_import )
+    {
+    	uint32_t start_year = 0;
+    	uint32_t end_year = 0;
+    	if( 3 != arguments.size() || !parse_uint(arguments[1], start_year) || !parse_uint(arguments[2], end_year) || \
+    		0 == start_year || start_year > end_year || end_year > LOTTO_SYNTHETIC_MAX_YEAR )
+    	{
+    		LOTTO_LOG(LOG_ERROR) << "Error! years must be 1 to " << LOTTO_SYNTHETIC_MAX_YEAR << ", start year first.";
+    		print_usage(argc, argv);
+    		return -1;
+    	}
+    	if( options.generate )
+    	{
+    		return generate_year_files(start_year, end_year, options.draws, options.seed);
+    	}
+    	return bench_import(start_year, end_year, options.jobs, options.repeat, options.cache);
+    }
 
 	// check arguments
-	if( 4 != argc )
+	if( 4 != arguments.size() )
 	{
 		print_usage(argc, argv);
 		return -1;
 	}
 
-    std::vector<std::string> arguments = parse_arguments(argc, argv);
-
 	char *end = NULL;
-    uint32_t start_year = std::strtoul(argv[1], &end, 10);
-    if( end == argv[1] )
+    uint32_t start_year = std::strtoul(arguments[1].c_str(), &end, 10);
+    if( end == arguments[1].c_str() )
     {
 		print_usage(argc, argv);
 		return -1;
     }
 	end = NULL;
-    uint32_t end_year = std::strtoul(argv[2], &end, 10);
-    if( end == argv[2] )
+    uint32_t end_year = std::strtoul(arguments[2].c_str(), &end, 10);
+    if( end == arguments[2].c_str() )
     {
 		print_usage(argc, argv);
 		return -1;
@@ -60,17 +330,17 @@ int main(int argc, char *argv[])
     // check valid years
     if( start_year < LOTTO_START_YEAR || start_year > LOTTO_END_YEAR )
     {
-		std::cout << "Error! start year out of bounds, start year = " << start_year << \
+		LOTTO_LOG(LOG_ERROR) << "Error! start year out of bounds, start year = " << start_year << \
 				" lower bound = " << LOTTO_START_YEAR << \
-				" upper bound = " << LOTTO_END_YEAR   << "." << std::endl;
+				" upper bound = " << LOTTO_END_YEAR   << ".";
 		print_usage(argc, argv);
 		return -1;
     }
     if( end_year < LOTTO_START_YEAR || end_year > LOTTO_END_YEAR )
     {
-		std::cout << "Error! start year out of bounds, end year = " << end_year << \
+		LOTTO_LOG(LOG_ERROR) << "Error! start year out of bounds, end year = " << end_year << \
 				" lower bound = " << LOTTO_START_YEAR << \
-				" upper bound = " << LOTTO_END_YEAR   << "." << std::endl;
+				" upper bound = " << LOTTO_END_YEAR   << ".";
 		print_usage(argc, argv);
 		return -1;
     }
@@ -78,33 +348,62 @@ int main(int argc, char *argv[])
     // check valid path
     boost::filesystem::path p(boost::filesystem::current_path());
     p /= boost::filesystem::path(arguments[3]);
-    if(boost::filesystem::exists(p))
+    // a watched db that exists is brought up to date first
+    const bool append = options.append || ( options.watch && boost::filesystem::exists(p) );
+    if(append)
+    {
+    	if( !boost::filesystem::exists(p) || !boost::filesystem::is_regular_file(p) )
+    	{
+    		LOTTO_LOG(LOG_ERROR) << "Error! file " << arguments[3] << \
+    				" does not exist or is not a regular file, nothing to append to.";
+    		print_usage(argc, argv);
+    		return -1;
+    	}
+    }
+    else if(boost::filesystem::exists(p))
     {
     	if(!boost::filesystem::is_regular_file(p))
     	{
-    		std::cout << "Error! file " << arguments[3] << \
-    				" does exist and is not a regular file." << std::endl;
+    		LOTTO_LOG(LOG_ERROR) << "Error! file " << arguments[3] << \
+    				" does exist and is not a regular file.";
     		print_usage(argc, argv);
     		return -1;
     	}
     	else
     	{
-    		std::cout << "Error! file " << arguments[3] << \
-    				" does exist and is a regular file." << std::endl;
+    		LOTTO_LOG(LOG_ERROR) << "Error! file " << arguments[3] << \
+    				" does exist and is a regular file.";
     		print_usage(argc, argv);
     		return -1;
     	}
     }
 
-    std::cout << "Processing with following info:" << std::endl;
-    std::cout << "path to db: " << p.c_str() << std::endl;
-    std::cout << "start year: " << start_year << std::endl;
-    std::cout << "end   year: " << end_year << std::endl;
+    LOTTO_LOG(LOG_INFO) << "Processing with following info:";
+    LOTTO_LOG(LOG_INFO) << "path to db: " << p.c_str();
+    LOTTO_LOG(LOG_INFO) << "start year: " << start_year;
+    LOTTO_LOG(LOG_INFO) << "end   year: " << end_year;
+    LOTTO_LOG(LOG_INFO) << "jobs:       " << options.jobs;
 
-    int32_t ret = process_all_files(p, start_year, end_year);
+    int32_t ret = 0;
+    import_stats_t stats;
+    if(append)
+    {
+    	ret = append_all_files(p, start_year, end_year, options, stats);
+    }
+    else
+    {
+    	ret = process_all_files(p, start_year, end_year, options, stats);
+    }
     if(ret)
     {
-		std::cout << "Error! from file processing, abort." << std::endl;
+		LOTTO_LOG(LOG_ERROR) << "Error! from file processing, abort.";
+    }
+    log_flush();
+    stats.print(options.stats, std::cout);
+
+    if( 0 == ret && options.watch )
+    {
+    	ret = watch_year_files(p, start_year, end_year);
     }
 
     return ret;
@@ -122,408 +421,1217 @@ std::vector<std::string> parse_arguments(int argc, char *argv[])
     return arguments;
 }
 
-void print_usage(int argc, char *argv[])
-{
-	std::cout << "Usage: " << std::string(argv[0]) << \
-			" start_year (" << LOTTO_START_YEAR << "-" << LOTTO_END_YEAR << ") " << \
-			"end_year   (" << LOTTO_START_YEAR << "-" << LOTTO_END_YEAR << ") file_output.db" << std::endl;
-}
-
-int32_t process_all_files(const boost::filesystem::path& file_db, uint32_t start_year, uint32_t end_year)
+int32_t parse_options(std::vector<std::string>& arguments, options_t& options)
 {
-	std::vector<extraction_t> extraction_vec;
+	options.jobs = 1;
+	options.stream = false;
+	options.append = false;
+	options.watch = false;
+	options.cache = false;
+	options.log_level = log_level_t::LOG_INFO;
+	options.bulk.clear();
+	options.repeat = 0;
+	options.stats = stats_format_t::STATS_NONE;
+	options.generate = false;
+	options.draws = LOTTO_SYNTHETIC_DRAWS;
+	options.seed = 1;
+	options.bench_import = false;
+	options.bench_scanner.clear();
+	options.verify.clear();
+	options.info.clear();
+	options.columnar.clear();
+	options.compressed.clear();
+	options.compress.clear();
+	options.decompress.clear();
+	options.convert.clear();
+	options.merge.clear();
+	options.duplicates = merge_policy_t::MERGE_FAIL;
+	options.bench_decode.clear();
+	options.serve.clear();
+	options.socket.clear();
+	options.bench_daemon.clear();
+	options.frequency.clear();
+	options.ritardo.clear();
+	options.combo.clear();
+	options.numbers.clear();
+	options.ruota = ruota_t::UNKNOWN;
+	options.cooccurrence.clear();
+	options.csv.clear();
+	options.windows.clear();
+	options.from_date = 0;
+	options.to_date = make_date(0xFFFF, 0xF, 0x1F);
 
-	for(uint32_t i = start_year; i <= end_year; i++)
+	std::vector<std::string> positional;
+	for(size_t i = 0; i < arguments.size(); i++)
 	{
-		std::cout << "... processing year: " << i << std::endl;
-		int32_t ret = process_file(extraction_vec, i);
-		if(ret)
+		if( std::string("--jobs") == arguments[i] )
 		{
-			std::cout << "Error from year: " << i << " abort." << std::endl;
-			return ret;
+			uint32_t jobs = 0;
+			if( parse_option_uint(arguments, i, jobs) )
+			{
+				return -1;
+			}
+			// 0 means one job per hardware thread
+			if( 0 == jobs )
+			{
+				jobs = std::thread::hardware_concurrency();
+			}
+			options.jobs = (jobs > 0) ? jobs : 1;
 		}
-	}
-
-	// save file db
-	int32_t ret = save_file_db(extraction_vec, file_db);
-	if(ret)
-	{
-		std::cout << "Error from save_file_db." << " abort." << std::endl;
-		return ret;
-	}
-
-	// verify file db
-	ret = verify_file_db(extraction_vec, file_db);
-	if(ret)
-	{
-		std::cout << "Error from verify_file_db." << " abort." << std::endl;
-		return ret;
-	}
-
-	return ret;
-}
-
-int32_t process_file(std::vector<extraction_t>& extraction_vec, uint32_t year)
-{
-	char year_cstr[256];
-	std::sprintf(year_cstr,"%04u.txt",year);
-	std::string filename = std::string(year_cstr);
-
-	// check valid file exists
-    boost::filesystem::path p(boost::filesystem::current_path());
-    p /= boost::filesystem::path(filename);
-    if(boost::filesystem::exists(p) && boost::filesystem::is_regular_file(p))
-    {
-		std::cout << "... found file: " << filename << std::endl;
-    }
-    else
-    {
-		std::cout << "Error: not found file: " << filename << std::endl;
-    	return -1;
-    }
-
-    // open the file
-    std::ifstream infile;
-    infile.open(p.c_str());
-
-    // read header
-    std::string header;
-    if(infile.is_open())
-    {
-    	std::getline(infile,header);
-    }
-    else
-    {
-		std::cout << "Error: could not open file: " << filename << std::endl;
-		infile.close();
-    	return -1;
-    }
-
-    // parse the header
-    std::vector<ruota_t> current_ruote;
-    typedef boost::tokenizer<boost::char_separator<char>> tokenizer;
-    boost::char_separator<char> sep{" "};
-    tokenizer tok{header, sep};
-    bool is_first = true;
-    for (const auto &t : tok)
-    {
-    	// first the year
-    	if(is_first)
-    	{
-			char *end = NULL;
-		    uint32_t current_year = std::strtoul(t.c_str(), &end, 10);
-		    if( end == t.c_str() )
-		    {
-		    	std::cout << "Error: not a valid current year: " << t.c_str() << std::endl;
-		    	infile.close();
-		    	return -1;
-		    }
-		    if( current_year != year )
-		    {
-		    	std::cout << "Error: current year: " << current_year << std::endl;
-		    	std::cout << "Error: asked   year: " << year << std::endl;
-		    	infile.close();
-		    	return -1;
-		    }
-		    is_first = false;
-    	}
-    	else
-    	{
-    		ruota_t ruota = convert_string_to_ruota(std::string(t.c_str()));
-    		if( ruota_t::UNKNOWN != ruota )
-    		{
-    			current_ruote.push_back(ruota);
-    		}
-    		else
-    		{
-    			char *end = NULL;
-    		    uint32_t current_year = std::strtoul(t.c_str(), &end, 10);
-    		    if( end == t.c_str() )
-    		    {
-    		    	std::cout << "Error: not a valid current year: " << t.c_str() << std::endl;
-    		    	infile.close();
-    		    	return -1;
-    		    }
-    		    if( current_year != year )
-    		    {
-    		    	std::cout << "Error: current year: " << current_year << std::endl;
-    		    	std::cout << "Error: asked   year: " << year << std::endl;
-    		    	infile.close();
-    		    	return -1;
-    		    }
-    		}
-    	}
-    }
-
-    // parse all the records
-    uint32_t line_counter = 0;
-    bool do_exit = false;
-	while(!infile.eof())
-	{
-		line_counter++;
-		std::string record;
-    	std::getline(infile,record);
-	    boost::char_separator<char> sep{" "};
-	    tokenizer tok_record{record, sep};
-	    bool is_first_record = true;
-	    bool is_second_record = false;
-	    uint64_t current_day = 0;
-	    mese_t   current_month = mese_t::NULL_MESE;
-	    std::vector<ruota_t>::const_iterator current_r_iter = current_ruote.begin();
-	    uint64_t a_num = 0, b_num = 0, c_num = 0, d_num = 0, e_num = 0;
-	    uint32_t current_number_iter = 1;
-	    size_t tok_size = 0;
-	    for (const auto &t : tok_record)
-	    {
-	    	(void) t;
-	    	tok_size++;
-	    }
-	    // check record well formed
-		if( tok_size == 1 && std::string("END") == std::string(*(tok_record.begin())) )
-		{
-			std::cout << "End of file at line " << line_counter << std::endl;
-			break;
+		else if( std::string("--stream") == arguments[i] )
+		{
+			options.stream = true;
 		}
-	    if( tok_size != 2 + (5*current_ruote.size()) + 1 )
-	    {
-			std::cout << "Error: ill formed record at line " << line_counter << std::endl;
-			std::cout << "tok_size " << tok_size << " requested " << (2 + (5*current_ruote.size()) + 1) << std::endl;
-			break;
-	    }
-	    for (const auto &t : tok_record)
-	    {
-	    	if(is_first_record)
-	    	{
-	    		if( std::string("END") == std::string(t.c_str()) )
-	    		{
-	    			std::cout << "End of file at line " << line_counter << std::endl;
-	    			do_exit = true;
-	    			break;
-	    		}
-	    		current_day = convert_number_non_zero(std::string(t.c_str()));
-	    		if( 0 == current_day || ( current_day < 1 || current_day > 31 ) )
-	    		{
-	    			std::cout << "Error at line: " << line_counter << " current_day " << current_day << std::endl;
-	    			infile.close();
-	    			return -1;
-	    		}
-	    		is_first_record = false;
-	    		is_second_record = true;
-	    		continue;
-	    	}
-	    	if(is_second_record)
-	    	{
-	    		current_month = convert_string_to_mese(std::string(t.c_str()));
-	    		if( mese_t::NULL_MESE == current_month )
-	    		{
-	    			std::cout << "Error: invalid month " << t.c_str() << std::endl;
-	    			std::cout << "Error at line: " << line_counter << std::endl;
-	    			infile.close();
-	    			return -1;
-	    		}
-	    		is_second_record = false;
-	    		continue;
-	    	}
-	    	// parse the ruote numbers
-	    	uint64_t c_number = 0;
-	    	if( std::string("--") != std::string(t.c_str()) )
-	    	{
-		    	c_number = convert_number_non_zero(std::string(t.c_str()));
-	    		if( 0 == c_number || ( c_number < 1 || c_number > 90 ) )
-	    		{
-	    			std::cout << "Error at line: " << line_counter << " c_number " << c_number << std::endl;
-	    			infile.close();
-	    			return -1;
-	    		}
-	    	}
-	    	switch (current_number_iter)
-	    	{
-				case 1:
-					a_num = c_number;
-					break;
-				case 2:
-					b_num = c_number;
-					break;
-				case 3:
-					c_num = c_number;
-					break;
-				case 4:
-					d_num = c_number;
-					break;
-				case 5:
-					e_num = c_number;
-					break;
-			}
-	    	current_number_iter++;
-	    	if( current_number_iter > 5 )
-	    	{
-	    		// add ruota extraction
-	    		if( a_num != 0 )
-	    		{
-	    			extraction_t ex;
-	    			ex.bits.a = a_num;
-	    			ex.bits.b = b_num;
-	    			ex.bits.c = c_num;
-	    			ex.bits.d = d_num;
-	    			ex.bits.e = e_num;
-	    			ex.bits.ruota = *current_r_iter;
-	    			ex.bits.year = (uint64_t) year;
-	    			ex.bits.month = (uint64_t) current_month;
-	    			ex.bits.day = current_day;
-	    			extraction_vec.push_back(ex);
-	    		}
-	    		current_number_iter = 1;
-	    		current_r_iter++;
-	    		if( current_r_iter == current_ruote.end() )
-	    		{
-	    			break;
-	    		}
-	    	}
-	    } // for (const auto &t : tok_record)
-	    if(do_exit)
-	    	break;
-	}
-	infile.close();
-
-    return 0;
-}
-
-uint64_t convert_number_non_zero(std::string number_str)
-{
-	if( number_str.size() != 2 )
-		return 0;
-
-	if( '0' == number_str[0] )
-	{
-		number_str.erase(number_str.begin());
-		// std::cout << "info number with leading 0: " << number_str << std::endl;
-	}
-
-	char *end = NULL;
-	const char *start = number_str.c_str();
-	uint64_t number_conv = std::strtoul(start, &end, 10);
-    if( end == start || 0 == number_conv )
-    {
-		std::cout << "Error: invalid number: " << number_str << std::endl;
-		return 0;
-    }
-
-    return number_conv;
-}
-
-int32_t save_file_db(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_db)
-{
-    // open the file
-	std::FILE *write_ptr = std::fopen(file_db.c_str(),"wb");
-
-	if( NULL != write_ptr )
-	{
-		uint8_t value_64bit[8] = { 0 };
-    	for( const auto& e : extraction_vec )
-    	{
-    		std::memset(value_64bit, 0, sizeof(value_64bit));
-
-    		value_64bit[0] = (uint8_t) ((e.raw >> 56) & 0xFF);
-    		value_64bit[1] = (uint8_t) ((e.raw >> 48) & 0xFF);
-    		value_64bit[2] = (uint8_t) ((e.raw >> 40) & 0xFF);
-    		value_64bit[3] = (uint8_t) ((e.raw >> 32) & 0xFF);
-    		value_64bit[4] = (uint8_t) ((e.raw >> 24) & 0xFF);
-    		value_64bit[5] = (uint8_t) ((e.raw >> 16) & 0xFF);
-    		value_64bit[6] = (uint8_t) ((e.raw >>  8) & 0xFF);
-    		value_64bit[7] = (uint8_t) ((e.raw >>  0) & 0xFF);
-
-    		std::fwrite(value_64bit,sizeof(value_64bit),1,write_ptr);
-    	}
-    	std::fclose(write_ptr);
-	}
-	else
-	{
-		std::cout << "Error: could not open file " << file_db.c_str() << std::endl;
-		return -1;
-	}
-
-    return 0;
-}
-
-int32_t verify_file_db(const std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_db)
-{
-    if(! (boost::filesystem::exists(file_db) && boost::filesystem::is_regular_file(file_db)) )
-    {
-		std::cout << "Error! file " << file_db.c_str() << \
-				" does not exist or is not a regular file." << std::endl;
-		return -1;
-    }
-
-    // open the file
-	std::FILE *read_ptr = std::fopen(file_db.c_str(),"rb");
-
-	if( NULL != read_ptr )
-	{
-    	uint64_t current_ex = 0;
-    	size_t current_ex_kounter = 0;
-		uint8_t value_64bit[8] = { 0 };
-    	for( const auto& e : extraction_vec )
-    	{
-    		current_ex = 0;
-    		current_ex_kounter++;
-
-    		std::memset(value_64bit, 0, sizeof(value_64bit));
-    		size_t ret = std::fread(value_64bit,sizeof(value_64bit),1,read_ptr);
-    		if( ret < 1 )
-    		{
-				std::cout << "Error! inconsistent read. abort." << std::endl;
-				std::fclose(read_ptr);
+		else if( std::string("--append") == arguments[i] || std::string("--update") == arguments[i] )
+		{
+			options.append = true;
+		}
+		else if( std::string("--watch") == arguments[i] )
+		{
+			options.watch = true;
+		}
+		else if( std::string("--quiet") == arguments[i] )
+		{
+			options.log_level = log_level_t::LOG_WARN;
+		}
+		else if( std::string("--verbose") == arguments[i] )
+		{
+			options.log_level = log_level_t::LOG_DEBUG;
+		}
+		else if( std::string("--cache") == arguments[i] )
+		{
+			options.cache = true;
+		}
+		else if( std::string("--bulk") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.bulk) )
+			{
 				return -1;
-    		}
-
-    		current_ex  = (uint64_t) ( (((uint64_t) value_64bit[0]) << 56) | \
-    				                   (((uint64_t) value_64bit[1]) << 48) | \
-    						           (((uint64_t) value_64bit[2]) << 40) | \
-    								   (((uint64_t) value_64bit[3]) << 32) | \
-    								   (((uint64_t) value_64bit[4]) << 24) | \
-    								   (((uint64_t) value_64bit[5]) << 16) | \
-    								   (((uint64_t) value_64bit[6]) <<  8) | \
-    								   (((uint64_t) value_64bit[7]) <<  0) );
-
-			if( current_ex != e.raw )
-			{
-				std::cout << "Error! inconsistent extraction found from file " << file_db.c_str() << std::endl;
-				std::cout << "Extraction number " << current_ex_kounter << std::endl;
-				std::cout << "Expected:" << std::endl;
-				std::cout << "   e.bits.year:  " << e.bits.year << std::endl;
-				std::cout << "   e.bits.month: " << e.bits.month << std::endl;
-				std::cout << "   e.bits.day:   " << e.bits.day << std::endl;
-				std::cout << "   e.bits.a:     " << e.bits.a << std::endl;
-				std::cout << "   e.bits.b:     " << e.bits.b << std::endl;
-				std::cout << "   e.bits.c:     " << e.bits.c << std::endl;
-				std::cout << "   e.bits.d:     " << e.bits.d << std::endl;
-				std::cout << "   e.bits.e:     " << e.bits.e << std::endl;
-				std::cout << "   e.bits.ruota: " << e.bits.ruota << std::endl;
-
-				extraction_t ex_found;
-				ex_found.raw = current_ex;
-				std::cout << "Found:" << std::endl;
-				std::cout << "   e.bits.year:  " << ex_found.bits.year << std::endl;
-				std::cout << "   e.bits.month: " << ex_found.bits.month << std::endl;
-				std::cout << "   e.bits.day:   " << ex_found.bits.day << std::endl;
-				std::cout << "   e.bits.a:     " << ex_found.bits.a << std::endl;
-				std::cout << "   e.bits.b:     " << ex_found.bits.b << std::endl;
-				std::cout << "   e.bits.c:     " << ex_found.bits.c << std::endl;
-				std::cout << "   e.bits.d:     " << ex_found.bits.d << std::endl;
-				std::cout << "   e.bits.e:     " << ex_found.bits.e << std::endl;
-				std::cout << "   e.bits.ruota: " << ex_found.bits.ruota << std::endl;
-
-				std::fclose(read_ptr);
+			}
+		}
+		else if( std::string("--repeat") == arguments[i] )
+		{
+			if( parse_option_uint(arguments, i, options.repeat) )
+			{
 				return -1;
 			}
-    	}
-    	std::fclose(read_ptr);
-	}
-	else
-	{
-		std::cout << "Error: could not open file " << file_db.c_str() << std::endl;
-		return -1;
-	}
-
-	return 0;
+		}
+		else if( std::string("--columnar") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.columnar) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--verify") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.verify) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--frequency") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.frequency) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--ritardo") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.ritardo) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--combo") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.combo) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--numbers") == arguments[i] )
+		{
+			if( parse_option_numbers(arguments, i, options.numbers) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--ruota") == arguments[i] )
+		{
+			std::string name;
+			if( parse_option_value(arguments, i, name) )
+			{
+				return -1;
+			}
+			options.ruota = convert_string_to_ruota(name);
+			if( ruota_t::UNKNOWN == options.ruota )
+			{
+				LOTTO_LOG(LOG_ERROR) << "Error! unknown ruota: " << name;
+				return -1;
+			}
+			if( ruota_t::TUTTE == options.ruota )
+			{
+				options.ruota = ruota_t::UNKNOWN;
+			}
+		}
+		else if( std::string("--cooccurrence") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.cooccurrence) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--csv") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.csv) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--window") == arguments[i] )
+		{
+			date_window_t window;
+			if( parse_option_window(arguments, i, window) )
+			{
+				return -1;
+			}
+			options.windows.push_back(window);
+		}
+		else if( std::string("--from") == arguments[i] )
+		{
+			if( parse_option_date(arguments, i, false, options.from_date) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--to") == arguments[i] )
+		{
+			if( parse_option_date(arguments, i, true, options.to_date) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--info") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.info) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--bench-scanner") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.bench_scanner) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--stats") == arguments[i] || std::string("--stats=text") == arguments[i] )
+		{
+			options.stats = stats_format_t::STATS_TEXT;
+		}
+		else if( std::string("--stats=json") == arguments[i] )
+		{
+			options.stats = stats_format_t::STATS_JSON;
+		}
+		else if( std::string("--generate") == arguments[i] )
+		{
+			options.generate = true;
+		}
+		else if( std::string("--draws") == arguments[i] )
+		{
+			if( parse_option_uint(arguments, i, options.draws) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--seed") == arguments[i] )
+		{
+			uint32_t seed = 0;
+			if( parse_option_uint(arguments, i, seed) )
+			{
+				return -1;
+			}
+			options.seed = seed;
+		}
+		else if( std::string("--bench-import") == arguments[i] )
+		{
+			options.bench_import = true;
+		}
+		else if( std::string("--bench-decode") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.bench_decode) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--serve") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.serve) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--socket") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.socket) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--bench-daemon") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.bench_daemon) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--compressed") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.compressed) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--compress") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.compress) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--decompress") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.decompress) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--convert") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.convert) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--merge") == arguments[i] )
+		{
+			if( parse_option_value(arguments, i, options.merge) )
+			{
+				return -1;
+			}
+		}
+		else if( std::string("--duplicates") == arguments[i] )
+		{
+			std::string policy;
+			if( parse_option_value(arguments, i, policy) )
+			{
+				return -1;
+			}
+			if( "first" == policy )
+				options.duplicates = merge_policy_t::MERGE_KEEP_FIRST;
+			else if( "last" == policy )
+				options.duplicates = merge_policy_t::MERGE_KEEP_LAST;
+			else if( "error" == policy )
+				options.duplicates = merge_policy_t::MERGE_FAIL;
+			else
+			{
+				LOTTO_LOG(LOG_ERROR) << "Error! --duplicates must be first, last or error: " << policy;
+				return -1;
+			}
+		}
+		else
+		{
+			positional.push_back(arguments[i]);
+		}
+	}
+	arguments.swap(positional);
+
+	if( !options.combo.empty() && ( options.numbers.empty() || options.numbers.size() > 5 ) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! --combo needs --numbers with 1 to 5 numbers";
+		return -1;
+	}
+	// without windows the matrices cover --from to --to
+	if( options.windows.empty() )
+	{
+		options.windows.push_back({ options.from_date, options.to_date });
+	}
+	if( !options.csv.empty() && options.cooccurrence.empty() && ( options.append || options.stream ) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! --csv needs the whole history, it can not be combined with --append or --stream";
+		return -1;
+	}
+	if( options.append && options.stream )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! --append can not be combined with --stream";
+		return -1;
+	}
+	if( !options.columnar.empty() && ( options.append || options.stream ) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! --columnar needs the whole history, it can not be combined with --append or --stream";
+		return -1;
+	}
+	if( !options.compressed.empty() && ( options.append || options.stream ) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! --compressed needs the whole history, it can not be combined with --append or --stream";
+		return -1;
+	}
+	if( !options.bulk.empty() && ( options.stream || options.cache || options.watch ) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! --bulk reads one history file, it can not be combined with --stream, --cache or --watch";
+		return -1;
+	}
+	if( options.watch && ( !options.csv.empty() || !options.columnar.empty() || !options.compressed.empty() ) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! --watch keeps only the db and its indexes up to date, not --csv, --columnar or --compressed";
+		return -1;
+	}
+
+	return 0;
+}
+
+int32_t parse_option_value(const std::vector<std::string>& arguments, size_t& i, std::string& value)
+{
+	if( i + 1 >= arguments.size() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! missing value for " << arguments[i];
+		return -1;
+	}
+	i++;
+	value = arguments[i];
+
+	return 0;
+}
+
+int32_t parse_option_uint(const std::vector<std::string>& arguments, size_t& i, uint32_t& value)
+{
+	std::string value_str;
+	if( parse_option_value(arguments, i, value_str) )
+	{
+		return -1;
+	}
+
+	char *end = NULL;
+	const char *start = value_str.c_str();
+	value = std::strtoul(start, &end, 10);
+	if( end == start || '\0' != *end )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! not a valid number for " << arguments[i - 1] << ": " << value_str;
+		return -1;
+	}
+
+	return 0;
+}
+
+// comma separated numbers 1..90
+int32_t parse_option_numbers(const std::vector<std::string>& arguments, size_t& i, std::vector<uint32_t>& numbers)
+{
+	std::string value_str;
+	if( parse_option_value(arguments, i, value_str) )
+	{
+		return -1;
+	}
+
+	numbers.clear();
+	const char *cursor = value_str.c_str();
+	while( true )
+	{
+		char *end = NULL;
+		const uint32_t number = std::strtoul(cursor, &end, 10);
+		if( end == cursor || number < 1 || number > 90 || ( '\0' != *end && ',' != *end ) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error! not a valid list of numbers for " << arguments[i - 1] << ": " << value_str;
+			return -1;
+		}
+		numbers.push_back(number);
+		if( '\0' == *end )
+		{
+			break;
+		}
+		cursor = end + 1;
+	}
+
+	return 0;
+}
+
+// YYYY, YYYY-MM or YYYY-MM-DD; the missing fields are the first or,
+// with last set, the last month and day so that ranges include them
+bool parse_date(const std::string& str, bool last, uint32_t& date)
+{
+	uint32_t fields[3] = { 0, last ? 12U : 1U, last ? 31U : 1U };
+	const char *cursor = str.c_str();
+	for( uint32_t k = 0; k < 3; k++ )
+	{
+		char *end = NULL;
+		fields[k] = std::strtoul(cursor, &end, 10);
+		if( end == cursor || ( '\0' != *end && ( '-' != *end || 2 == k ) ) )
+		{
+			return false;
+		}
+		if( '\0' == *end )
+		{
+			break;
+		}
+		cursor = end + 1;
+	}
+	if( fields[0] > 0xFFFF || fields[1] < 1 || fields[1] > 12 || fields[2] < 1 || fields[2] > 31 )
+	{
+		return false;
+	}
+	date = make_date(fields[0], fields[1], fields[2]);
+
+	return true;
+}
+
+int32_t parse_option_date(const std::vector<std::string>& arguments, size_t& i, bool last, uint32_t& date)
+{
+	std::string value_str;
+	if( parse_option_value(arguments, i, value_str) )
+	{
+		return -1;
+	}
+	if( !parse_date(value_str, last, date) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! not a valid date for " << arguments[i - 1] << ": " << value_str;
+		return -1;
+	}
+
+	return 0;
+}
+
+// FROM:TO, either end may be left out
+int32_t parse_option_window(const std::vector<std::string>& arguments, size_t& i, date_window_t& window)
+{
+	std::string value_str;
+	if( parse_option_value(arguments, i, value_str) )
+	{
+		return -1;
+	}
+
+	const size_t colon = value_str.find(':');
+	const std::string from_str = value_str.substr(0, colon);
+	const std::string to_str = ( std::string::npos == colon ) ? std::string() : value_str.substr(colon + 1);
+	window.from_date = 0;
+	window.to_date = make_date(0xFFFF, 0xF, 0x1F);
+	if( std::string::npos == colon || \
+		( !from_str.empty() && !parse_date(from_str, false, window.from_date) ) || \
+		( !to_str.empty() && !parse_date(to_str, true, window.to_date) ) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! not a valid window for " << arguments[i - 1] << ": " << value_str;
+		return -1;
+	}
+
+	return 0;
+}
+
+void print_usage(int argc, char *argv[])
+{
+	log_flush();
+	std::cout << "Usage: " << std::string(argv[0]) << \
+			" [--jobs N] [--stream | --append | --columnar file.col | --compressed file.dbz] start_year (" << LOTTO_START_YEAR << "-" << LOTTO_END_YEAR << ") " << \
+			"end_year   (" << LOTTO_START_YEAR << "-" << LOTTO_END_YEAR << ") file_output.db" << std::endl;
+	std::cout << "   --jobs N   parse year files with N worker threads (0 = all cores, default 1)" << std::endl;
+	std::cout << "   --stream   write each year as soon as it is parsed, with bounded memory" << std::endl;
+	std::cout << "   --append   append to an existing db the draws after its last one, parsing" << std::endl;
+	std::cout << "              from the later of start_year and the year of that draw (alias --update)" << std::endl;
+	std::cout << "   --quiet    only errors and warnings, --verbose also each year file and section" << std::endl;
+	std::cout << "   --bulk history.txt    read the years from one history file, the year files one" << std::endl;
+	std::cout << "                         after the other, split in chunks parsed by the --jobs threads" << std::endl;
+	std::cout << "   --cache    keep the records of each year file in " << LOTTO_PARSE_CACHE_DIR << \
+			" and parse again only the files that changed" << std::endl;
+	std::cout << "   --watch    after the import, or the append to an existing db, watch the year files" << std::endl;
+	std::cout << "              and splice into the db each year written again, until Ctrl-C" << std::endl;
+	std::cout << "   --columnar file.col   also export the extractions one column per field" << std::endl;
+	std::cout << "   --compressed file.dbz also export the extractions in compressed blocks" << std::endl;
+	std::cout << "   --stats[=text|=json]  report wall and CPU time, bytes, records/s, allocations and" << std::endl;
+	std::cout << "                         peak RSS of each import phase, json on a single line" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --verify file.db" << std::endl;
+	std::cout << "   check the records of a db against the checksum in its trailer" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --info file.db" << std::endl;
+	std::cout << "   format version, records and date range of a db from its header" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --frequency file.db [--from YYYY[-MM[-DD]]] [--to YYYY[-MM[-DD]]]" << std::endl;
+	std::cout << "   count how many times each number was drawn on each ruota in the date range" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --ritardo file.db" << std::endl;
+	std::cout << "   draws since each number last came out on each ruota and its longest delay," << std::endl;
+	std::cout << "   from the index kept next to the db (rebuilt when missing or out of date)" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --combo file.db --numbers N1,N2[,...] [--ruota NAME] [--from DATE] [--to DATE]" << std::endl;
+	std::cout << "   count the draws holding all the numbers (ambo, terno, ...) from the bitset index" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --cooccurrence file.db [--window FROM:TO ...] [--jobs N] [--csv file.csv]" << std::endl;
+	std::cout << "   pair co-occurrence matrices per ruota and TUTTE, one per window, in a single pass;" << std::endl;
+	std::cout << "   an import with --csv [--window FROM:TO ...] writes them from the parsed records" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --bench-scanner NNNN.txt [--repeat N]" << std::endl;
+	std::cout << "   time the record scanner against the boost::tokenizer parsing of a year file" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --generate [--draws N] [--seed S] start_year end_year (1-" << \
+			LOTTO_SYNTHETIC_MAX_YEAR << ")" << std::endl;
+	std::cout << "   write synthetic year files in the current directory, N draws a year (default " << \
+			LOTTO_SYNTHETIC_DRAWS << ", at most " << LOTTO_SYNTHETIC_MAX_DRAWS << ")" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --bench-import [--jobs N] [--repeat N] [--cache] start_year end_year (1-" << \
+			LOTTO_SYNTHETIC_MAX_YEAR << ")" << std::endl;
+	std::cout << "   time the parse, encode, write and verify phases of an import, records/s and MB/s" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --compress file.db | --decompress file.dbz" << std::endl;
+	std::cout << "   write a db in compressed blocks to file.dbz, or a compressed file back to a db" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --convert old.db new.db" << std::endl;
+	std::cout << "   rewrite a db of any version as a version " << LOTTO_DB_VERSION << " db, records sorted by date and ruota;" << std::endl;
+	std::cout << "   new.db must not exist, or be old.db itself to rewrite it in place" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --merge new.db [--duplicates first|last|error] [--stats] file1.db file2.db ..." << std::endl;
+	std::cout << "   merge dbs of any version by date and ruota in one pass, sorting an unsorted one in runs;" << std::endl;
+	std::cout << "   the same record twice is kept once, different records of one draw and ruota are an" << std::endl;
+	std::cout << "   error unless the first or the last db given wins; new.db must not exist" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --bench-decode file.dbz [--repeat N]" << std::endl;
+	std::cout << "   time the decoding of the compressed blocks against the plain db records" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --serve file.db [--socket path]" << std::endl;
+	std::cout << "   keep the db and its indexes in memory and answer frequency, ritardo and range" << std::endl;
+	std::cout << "   queries on a Unix socket (default file.db" << LOTTO_DAEMON_SOCKET_SUFFIX << "), reloading the db when it changes" << std::endl;
+	std::cout << "Usage: " << std::string(argv[0]) << " --bench-daemon path [--repeat N]" << std::endl;
+	std::cout << "   time the queries of a running daemon, latency one at a time and pipelined throughput" << std::endl;
+}
+
+int32_t process_all_files(const boost::filesystem::path& file_db, uint32_t start_year, uint32_t end_year, const options_t& options,
+		import_stats_t& stats)
+{
+	if( options.stream )
+	{
+		return process_all_files_streaming(file_db, start_year, end_year, options.jobs, options.cache, stats);
+	}
+
+	std::vector<extraction_t> extraction_vec;
+
+	stats.begin("parse");
+	int32_t ret = options.bulk.empty() ? parse_all_files(extraction_vec, start_year, end_year, options.jobs, options.cache) :
+			parse_history_file(extraction_vec, boost::filesystem::path(options.bulk), start_year, end_year, options.jobs);
+	stats.end(extraction_vec.size());
+	if(ret)
+	{
+		return ret;
+	}
+
+	// save file db
+	stats.begin("save");
+	ret = save_file_db(extraction_vec, file_db);
+	stats.end(extraction_vec.size());
+	if(ret)
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from save_file_db." << " abort.";
+		return ret;
+	}
+
+	// verify file db
+	stats.begin("verify");
+	ret = verify_file_db(extraction_vec, file_db, 0);
+	stats.end(extraction_vec.size());
+	if(ret)
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from verify_file_db." << " abort.";
+		return ret;
+	}
+
+	// ritardo and bitset indexes
+	stats.begin("indexes");
+	ritardo_index_t index;
+	ret = build_ritardo_index(file_db, index);
+	if(ret)
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from build_ritardo_index." << " abort.";
+		return ret;
+	}
+	ret = build_bitset_index(file_db);
+	stats.end(extraction_vec.size());
+	if(ret)
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from build_bitset_index." << " abort.";
+		return ret;
+	}
+
+	// co-occurrence matrices
+	if( !options.csv.empty() )
+	{
+		stats.begin("cooccurrence");
+		std::vector<cooccurrence_matrix_t> matrices;
+		ret = compute_cooccurrence(extraction_vec, options.windows, options.jobs, matrices);
+		if( 0 == ret )
+		{
+			boost::filesystem::path file_csv(boost::filesystem::current_path());
+			file_csv /= boost::filesystem::path(options.csv);
+			ret = save_cooccurrence_csv(matrices, file_csv);
+		}
+		stats.end(extraction_vec.size());
+		if(ret)
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error from save_cooccurrence_csv." << " abort.";
+			return ret;
+		}
+	}
+
+	// columnar export
+	if( !options.columnar.empty() )
+	{
+		boost::filesystem::path file_col(boost::filesystem::current_path());
+		file_col /= boost::filesystem::path(options.columnar);
+		stats.begin("columnar");
+		ret = save_file_columnar(extraction_vec, file_col);
+		if(ret)
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error from save_file_columnar." << " abort.";
+			return ret;
+		}
+		ret = verify_file_columnar(extraction_vec, file_col);
+		stats.end(extraction_vec.size());
+		if(ret)
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error from verify_file_columnar." << " abort.";
+			return ret;
+		}
+	}
+
+	// compressed export
+	if( !options.compressed.empty() )
+	{
+		boost::filesystem::path file_z(boost::filesystem::current_path());
+		file_z /= boost::filesystem::path(options.compressed);
+		stats.begin("compressed");
+		ret = save_file_compressed(extraction_vec, file_z);
+		if(ret)
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error from save_file_compressed." << " abort.";
+			return ret;
+		}
+		ret = verify_file_compressed(extraction_vec, file_z);
+		stats.end(extraction_vec.size());
+		if(ret)
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error from verify_file_compressed." << " abort.";
+			return ret;
+		}
+	}
+
+	return ret;
+}
+
+int32_t append_all_files(const boost::filesystem::path& file_db, uint32_t start_year, uint32_t end_year, const options_t& options,
+		import_stats_t& stats)
+{
+	std::vector<extraction_t> last_draw;
+	uint64_t n_records = 0;
+	uint32_t version = 0;
+	int32_t ret = read_last_draw(file_db, last_draw, n_records, version);
+	if(ret)
+	{
+		return ret;
+	}
+
+	// the last draw in the db is parsed again, it might be incomplete or
+	// corrected, and only the years from its one on can hold newer draws
+	uint32_t first_year = start_year;
+	uint32_t last_date = 0;
+	if( !last_draw.empty() )
+	{
+		const extraction_t& last = last_draw.back();
+		last_date = extraction_date(last);
+		first_year = std::max(start_year, (uint32_t) last.year());
+		LOTTO_LOG(LOG_INFO) << "records in db: " << n_records << ", last draw: " << last.year() << "/" << \
+				convert_mese_to_string((mese_t) last.month()) << "/" << last.day();
+	}
+	const uint64_t first_record = n_records - last_draw.size();
+	// the last draw is written again from the year files, without its
+	// year it would be cut off the db
+	if( first_year > end_year )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! the last draw in the db is of year " << first_year << \
+				", after end year " << end_year << ": nothing to append, db left as it is.";
+		return -1;
+	}
+
+	std::vector<extraction_t> extraction_vec;
+	stats.begin("parse");
+	ret = options.bulk.empty() ? parse_all_files(extraction_vec, first_year, end_year, options.jobs, options.cache) :
+			parse_history_file(extraction_vec, boost::filesystem::path(options.bulk), first_year, end_year, options.jobs);
+	stats.end(extraction_vec.size());
+	if(ret)
+	{
+		return ret;
+	}
+
+	// keep the last draw and the ones after it, the records are in date order
+	auto first_new = std::find_if(extraction_vec.begin(), extraction_vec.end(),
+			[last_date](const extraction_t& e){ return extraction_date(e) >= last_date; });
+	extraction_vec.erase(extraction_vec.begin(), first_new);
+	// an append never writes fewer records than the db holds: the last
+	// draw must be parsed again, with at least the records it had
+	const size_t last_parsed = (size_t) std::count_if(extraction_vec.begin(), extraction_vec.end(),
+			[last_date](const extraction_t& e){ return extraction_date(e) == last_date; });
+	if( last_parsed < last_draw.size() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! the last draw in the db has " << last_draw.size() << \
+				" records, the year files " << last_parsed << ": it would be lost, db left as it is.";
+		LOTTO_LOG(LOG_ERROR) << "Error! a full import writes the db again from the year files.";
+		return -1;
+	}
+	// a db in an older format is always rewritten in the current one
+	if( LOTTO_DB_VERSION == version && \
+		extraction_vec.size() == last_draw.size() && \
+		std::equal(extraction_vec.begin(), extraction_vec.end(), last_draw.begin(),
+				[](const extraction_t& a, const extraction_t& b){ return a.raw == b.raw; }) )
+	{
+		LOTTO_LOG(LOG_INFO) << "db is up to date, nothing to append.";
+		ritardo_index_t index;
+		if( load_current_ritardo_index(file_db, index) && build_ritardo_index(file_db, index) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error from build_ritardo_index." << " abort.";
+			return -1;
+		}
+		return 0;
+	}
+	LOTTO_LOG(LOG_INFO) << "appending records: " << extraction_vec.size() << \
+			" from record: " << first_record;
+
+	// the index can be carried forward only if it covers exactly this db
+	// and the records of the last draw it counted are written again as
+	// they are, a corrected draw needs a rebuild
+	ritardo_index_t index;
+	bool index_current = ( 0 == load_current_ritardo_index(file_db, index) ) && \
+		std::all_of(last_draw.begin(), last_draw.end(), [&extraction_vec](const extraction_t& old)
+			{
+				return extraction_vec.end() != std::find_if(extraction_vec.begin(), extraction_vec.end(),
+						[&old](const extraction_t& e){ return e.raw == old.raw; });
+			});
+
+	stats.begin("save");
+	db_file_writer_t writer;
+	if( LOTTO_DB_VERSION != version )
+	{
+		// older formats have no room for the header, the records kept
+		// are read back, put in the order of the current records, and
+		// the db is written anew
+		std::vector<extraction_t> kept;
+		if( read_file_db(file_db, kept, first_record) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error from save_file_db." << " abort.";
+			return -1;
+		}
+		std::stable_sort(kept.begin(), kept.end(), [](const extraction_t& a, const extraction_t& b){ return a.raw < b.raw; });
+		if( writer.open_db(file_db.c_str(), first_record + extraction_vec.size()) || \
+			writer.write_records(kept.data(), kept.size()) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error from save_file_db." << " abort.";
+			return -1;
+		}
+	}
+	else if( writer.open_db_append(file_db.c_str(), first_record) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from save_file_db." << " abort.";
+		return -1;
+	}
+	if( writer.write_records(extraction_vec.data(), extraction_vec.size()) || \
+		writer.write_trailer() || \
+		writer.commit() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from save_file_db." << " abort.";
+		return -1;
+	}
+	stats.end(extraction_vec.size());
+
+	stats.begin("verify");
+	ret = verify_file_db(extraction_vec, file_db, first_record);
+	stats.end(extraction_vec.size());
+	if(ret)
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from verify_file_db." << " abort.";
+		return ret;
+	}
+
+	stats.begin("indexes");
+	if(index_current)
+	{
+		ritardo_update(index, extraction_vec.data(), extraction_vec.size());
+		index.db_records = first_record + extraction_vec.size();
+		index.db_crc = writer.crc();
+		ret = save_ritardo_index(index, ritardo_index_path(file_db));
+	}
+	else
+	{
+		ret = build_ritardo_index(file_db, index);
+	}
+	if(ret)
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from build_ritardo_index." << " abort.";
+		return ret;
+	}
+	ret = build_bitset_index(file_db);
+	stats.end(extraction_vec.size());
+	if(ret)
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from build_bitset_index." << " abort.";
+		return ret;
+	}
+
+	return 0;
+}
+
+int32_t process_all_files_streaming(const boost::filesystem::path& file_db, uint32_t start_year, uint32_t end_year, uint32_t jobs,
+		bool cached, import_stats_t& stats)
+{
+	const uint32_t n_years = ( start_year > end_year ) ? 0 : end_year - start_year + 1;
+	const uint32_t n_workers = std::max(1u, std::min(jobs, n_years));
+
+	// parse -> encode -> write, at most LOTTO_STREAM_QUEUE_DEPTH years
+	// wait in each queue and one year is being parsed by each worker
+	bounded_queue_t<year_block_t> parsed_queue(LOTTO_STREAM_QUEUE_DEPTH);
+	bounded_queue_t<encoded_block_t> encoded_queue(LOTTO_STREAM_QUEUE_DEPTH);
+	std::atomic<bool> failed(false);
+	std::atomic<uint32_t> next_year(0);
+	std::atomic<uint32_t> active_workers(n_workers);
+
+	// parsed years are handed to the encoder in year order
+	std::mutex order_mutex;
+	std::condition_variable order_cv;
+	uint32_t next_to_push = 0;
+	int32_t parse_ret = 0;
+	uint32_t failed_year = 0;
+
+	auto parse_worker = [&]()
+	{
+		while(!failed)
+		{
+			const uint32_t k = next_year++;
+			if( k >= n_years )
+			{
+				break;
+			}
+			year_block_t block;
+			block.year = start_year + k;
+			LOTTO_LOG(LOG_INFO) << "... processing year: " << block.year;
+			int32_t ret = cached ? process_file_cached(block.records, block.year) : process_file(block.records, block.year);
+
+			std::unique_lock<std::mutex> lock(order_mutex);
+			order_cv.wait(lock, [&]{ return failed || next_to_push == k; });
+			if( !failed && ret )
+			{
+				parse_ret = ret;
+				failed_year = block.year;
+				failed = true;
+			}
+			if( !failed && !parsed_queue.push(std::move(block)) )
+			{
+				failed = true;
+			}
+			next_to_push++;
+			order_cv.notify_all();
+		}
+		if( 0 == --active_workers )
+		{
+			parsed_queue.close();
+		}
+	};
+
+	uint64_t n_records = 0;
+	uint32_t crc = 0;
+	ritardo_index_t index;
+	ritardo_reset(index);
+	auto encode_stage = [&]()
+	{
+		year_block_t block;
+		while( parsed_queue.pop(block) )
+		{
+			encoded_block_t encoded;
+			encoded.year = block.year;
+			encoded.bytes.resize(block.records.size() * LOTTO_RECORD_BYTES);
+			encode_records(block.records.data(), block.records.size(), encoded.bytes.data());
+			crc = crc32c_update(crc, encoded.bytes.data(), encoded.bytes.size());
+			n_records += block.records.size();
+			ritardo_update(index, block.records.data(), block.records.size());
+			if( !encoded_queue.push(std::move(encoded)) )
+			{
+				failed = true;
+				parsed_queue.close();
+				break;
+			}
+		}
+		encoded_queue.close();
+	};
+
+	// parse, encode and write overlap, they are one phase
+	stats.begin("stream");
+	db_file_writer_t writer;
+	if( writer.open_db(file_db.c_str(), 0) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not open file " << file_db.c_str();
+		return -1;
+	}
+
+	std::vector<std::thread> threads;
+	for(uint32_t j = 0; j < n_workers; j++)
+	{
+		threads.emplace_back(parse_worker);
+	}
+	threads.emplace_back(encode_stage);
+
+	// write stage
+	int32_t write_ret = 0;
+	encoded_block_t encoded;
+	while( encoded_queue.pop(encoded) )
+	{
+		if( writer.write_encoded_records(encoded.bytes.data(), encoded.bytes.size() / LOTTO_RECORD_BYTES) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: could not write year " << encoded.year << " to file " << file_db.c_str();
+			write_ret = -1;
+			failed = true;
+			encoded_queue.close();
+			parsed_queue.close();
+			break;
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(order_mutex);
+		order_cv.notify_all();
+	}
+	for(auto& t : threads)
+	{
+		t.join();
+	}
+
+	if( parse_ret )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from year: " << failed_year << " abort.";
+		writer.abort();
+		return parse_ret;
+	}
+	if( write_ret || failed )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from save_file_db." << " abort.";
+		writer.abort();
+		return -1;
+	}
+	if( writer.write_trailer() || writer.commit() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from save_file_db." << " abort.";
+		return -1;
+	}
+	stats.end(n_records);
+
+	// verify file db against what the encoder produced
+	uint64_t file_records = 0;
+	uint32_t file_crc = 0;
+	stats.begin("verify");
+	int32_t ret = verify_file_db_checksum(file_db, file_records, file_crc);
+	stats.end(file_records);
+	if( 0 == ret && ( file_records != n_records || file_crc != crc ) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! inconsistent extractions found from file " << file_db.c_str();
+		LOTTO_LOG(LOG_ERROR) << "Expected records: " << n_records << " crc32c: " << crc;
+		LOTTO_LOG(LOG_ERROR) << "Found    records: " << file_records << " crc32c: " << file_crc;
+		ret = -1;
+	}
+	if(ret)
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from verify_file_db." << " abort.";
+		return ret;
+	}
+
+	stats.begin("indexes");
+	index.db_records = n_records;
+	index.db_crc = crc;
+	ret = save_ritardo_index(index, ritardo_index_path(file_db));
+	if(ret)
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from save_ritardo_index." << " abort.";
+		return ret;
+	}
+	ret = build_bitset_index(file_db);
+	stats.end(n_records);
+	if(ret)
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from build_bitset_index." << " abort.";
+		return ret;
+	}
+
+	return 0;
+}
+
+int32_t print_file_db_info(const boost::filesystem::path& file_db)
+{
+	db_reader_t reader;
+	if( reader.open(file_db.c_str()) )
+	{
+		return -1;
+	}
+	const db_layout_t& layout = reader.layout();
+
+	log_flush();
+	std::cout << file_db.c_str() << ": version " << layout.version << ", " << layout.n_records << " records";
+	if( layout.has_trailer )
+	{
+		std::cout << ", crc32c " << layout.crc;
+	}
+	std::cout << std::endl;
+	if( layout.n_months )
+	{
+		std::cout << "   from " << (layout.first_date >> 9) << "/" << convert_mese_to_string((mese_t) ((layout.first_date >> 5) & 0xF)) << \
+				"/" << (layout.first_date & 0x1F) << " to " << (layout.last_date >> 9) << "/" << \
+				convert_mese_to_string((mese_t) ((layout.last_date >> 5) & 0xF)) << "/" << (layout.last_date & 0x1F) << \
+				", " << layout.n_months << " months indexed" << std::endl;
+	}
+	if( layout.version < LOTTO_DB_SORTED_VERSION )
+	{
+		std::cout << "   legacy records, --convert rewrites it as a version " << LOTTO_DB_VERSION << " db" << std::endl;
+	}
+
+	return 0;
+}
+
+int32_t compress_file_db(const boost::filesystem::path& file_db)
+{
+	boost::filesystem::path file_z(file_db);
+	file_z += LOTTO_COMPRESSED_SUFFIX;
+    if( boost::filesystem::exists(file_z) )
+    {
+		LOTTO_LOG(LOG_ERROR) << "Error! file " << file_z.c_str() << " already exists.";
+		return -1;
+    }
+
+	// the records are checked against the trailer before compressing
+	uint64_t n_records = 0;
+	uint32_t crc = 0;
+	std::vector<extraction_t> extraction_vec;
+	if( verify_file_db_checksum(file_db, n_records, crc) || read_file_db(file_db, extraction_vec, n_records) )
+	{
+		return -1;
+	}
+
+	if( save_file_compressed(extraction_vec, file_z) || verify_file_compressed(extraction_vec, file_z) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from save_file_compressed." << " abort.";
+		return -1;
+	}
+
+	const uint64_t db_bytes = boost::filesystem::file_size(file_db);
+	const uint64_t z_bytes = boost::filesystem::file_size(file_z);
+	LOTTO_LOG(LOG_INFO) << file_z.c_str() << ": " << n_records << " records, " << z_bytes << " bytes (db " << db_bytes << \
+			" bytes, ratio " << ( z_bytes ? (double) db_bytes / (double) z_bytes : 0.0 ) << ")";
+
+	return 0;
+}
+
+int32_t decompress_file_db(const boost::filesystem::path& file_z)
+{
+	const std::string name = file_z.string();
+	if( name.size() <= 1 || LOTTO_COMPRESSED_SUFFIX[0] != name.back() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! file " << file_z.c_str() << " does not end with " << LOTTO_COMPRESSED_SUFFIX;
+		return -1;
+	}
+	const boost::filesystem::path file_db(name.substr(0, name.size() - 1));
+    if( boost::filesystem::exists(file_db) )
+    {
+		LOTTO_LOG(LOG_ERROR) << "Error! file " << file_db.c_str() << " already exists.";
+		return -1;
+    }
+
+	std::vector<extraction_t> extraction_vec;
+	if( load_file_compressed(file_z, extraction_vec) )
+	{
+		return -1;
+	}
+	if( save_file_db(extraction_vec, file_db) || verify_file_db(extraction_vec, file_db, 0) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from save_file_db." << " abort.";
+		return -1;
+	}
+	LOTTO_LOG(LOG_INFO) << file_db.c_str() << ": " << extraction_vec.size() << " records";
+
+	return 0;
+}
+
+void print_frequencies(const frequency_table_t& table)
+{
+	log_flush();
+	std::cout << "draws in range: " << table.n_records << std::endl;
+	for( uint32_t r = 0; r < ruota_t::UNKNOWN; r++ )
+	{
+		std::cout << convert_ruota_to_string((ruota_t) r) << std::endl;
+		for( uint32_t number = 1; number <= 90; number++ )
+		{
+			std::cout << "   " << std::setw(2) << number << ": " << std::setw(6) << table.counts[r][number];
+			if( 0 == number % 6 )
+			{
+				std::cout << std::endl;
+			}
+		}
+	}
+}
+
+void print_ritardo(const ritardo_index_t& index)
+{
+	log_flush();
+	std::cout << "ritardo (current/max) per number" << std::endl;
+	for( uint32_t r = 0; r < ruota_t::TUTTE; r++ )
+	{
+		std::cout << convert_ruota_to_string((ruota_t) r) << ", draws: " << index.draws[r] << std::endl;
+		for( uint32_t number = 1; number <= 90; number++ )
+		{
+			std::cout << "   " << std::setw(2) << number << ": " << std::setw(4) << ritardo_current(index, (ruota_t) r, number) << \
+					"/" << std::setw(4) << std::left << ritardo_max(index, (ruota_t) r, number) << std::right;
+			if( 0 == number % 6 )
+			{
+				std::cout << std::endl;
+			}
+		}
+	}
+}
+
+void print_combo(const options_t& options, const combo_result_t& result)
+{
+	log_flush();
+	std::cout << "numbers:";
+	for( uint32_t number : options.numbers )
+	{
+		std::cout << " " << number;
+	}
+	std::cout << std::endl;
+	for( uint32_t r = 0; r < ruota_t::UNKNOWN; r++ )
+	{
+		if( ruota_t::UNKNOWN != options.ruota && r != options.ruota && r != ruota_t::TUTTE )
+		{
+			continue;
+		}
+		std::cout << "   " << std::setw(10) << std::left << convert_ruota_to_string((ruota_t) r) << std::right << \
+				" draws: " << std::setw(6) << result.counts[r];
+		const uint32_t date = result.last_date[r];
+		if( date )
+		{
+			std::cout << ", last: " << (date >> 9) << "/" << convert_mese_to_string((mese_t) ((date >> 5) & 0xF)) << "/" << (date & 0x1F);
+		}
+		std::cout << std::endl;
+	}
+}
+
+void print_cooccurrence(const std::vector<date_window_t>& windows, const std::vector<cooccurrence_matrix_t>& matrices)
+{
+	log_flush();
+	for( size_t w = 0; w < matrices.size(); w++ )
+	{
+		const uint32_t from = windows[w].from_date;
+		const uint32_t to = windows[w].to_date;
+		std::cout << "window " << w << ": " << (from >> 9) << "/" << ((from >> 5) & 0xF) << "/" << (from & 0x1F) << \
+				" - " << (to >> 9) << "/" << ((to >> 5) & 0xF) << "/" << (to & 0x1F) << std::endl;
+
+		// most frequent ambi on TUTTE
+		std::vector<std::pair<uint32_t, uint32_t>> pairs;
+		for( uint32_t a = 1; a <= 90; a++ )
+		{
+			for( uint32_t b = a + 1; b <= 90; b++ )
+			{
+				pairs.push_back({ matrices[w].counts[ruota_t::TUTTE][a][b], a * 91 + b });
+			}
+		}
+		std::partial_sort(pairs.begin(), pairs.begin() + 10, pairs.end(),
+				[](const std::pair<uint32_t, uint32_t>& x, const std::pair<uint32_t, uint32_t>& y)
+				{ return x.first > y.first || ( x.first == y.first && x.second < y.second ); });
+		for( size_t k = 0; k < 10; k++ )
+		{
+			std::cout << "   " << std::setw(2) << pairs[k].second / 91 << "-" << std::setw(2) << std::left << pairs[k].second % 91 << \
+					std::right << " TUTTE: " << pairs[k].first << std::endl;
+		}
+	}
 }
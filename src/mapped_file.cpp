@@ -0,0 +1,77 @@
+/*
+ * mapped_file.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "import_stats.h"
+#include "logger.h"
+#include "mapped_file.h"
+
+mapped_file_t::mapped_file_t() : data_(NULL), size_(0), is_open_(false)
+{
+}
+
+mapped_file_t::~mapped_file_t()
+{
+	close();
+}
+
+int32_t mapped_file_t::open(const char *filename)
+{
+	close();
+
+	int fd = ::open(filename, O_RDONLY);
+	if( fd < 0 )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not open file: " << filename;
+		return -1;
+	}
+
+	struct stat st;
+	if( ::fstat(fd, &st) < 0 )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not stat file: " << filename;
+		::close(fd);
+		return -1;
+	}
+
+	// an empty file can not be mapped, expose it as an empty view
+	size_t size = (size_t) st.st_size;
+	if( size > 0 )
+	{
+		void *addr = ::mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if( MAP_FAILED == addr )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: could not map file: " << filename;
+			::close(fd);
+			return -1;
+		}
+		// the files are scanned once from the start to the end
+		::madvise(addr, size, MADV_SEQUENTIAL);
+		data_ = (const char *) addr;
+	}
+	::close(fd);
+
+	size_ = size;
+	is_open_ = true;
+	stats_add_bytes_read(size);
+
+	return 0;
+}
+
+void mapped_file_t::close()
+{
+	if( NULL != data_ )
+	{
+		::munmap((void *) data_, size_);
+	}
+	data_ = NULL;
+	size_ = 0;
+	is_open_ = false;
+}
@@ -0,0 +1,178 @@
+/*
+ * parse_cache.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <boost/system/error_code.hpp>
+#include "utilities.h"
+#include "mapped_file.h"
+#include "crc32c.h"
+#include "db_io.h"
+#include "year_parser.h"
+#include "logger.h"
+#include "parse_cache.h"
+
+typedef struct PARSE_CACHE_HEADER
+{
+	uint32_t version;
+	uint32_t year;
+	uint64_t text_bytes;
+	uint32_t text_crc;
+	uint32_t records_crc;
+	uint64_t n_records;
+} parse_cache_header_t;
+
+static void encode_cache_header(const parse_cache_header_t& header, uint8_t *dst)
+{
+	std::memset(dst, 0, LOTTO_PARSE_CACHE_HEADER);
+	std::memcpy(dst, LOTTO_PARSE_CACHE_MAGIC, 8);
+	store_be(dst + 8, header.version, 4);
+	store_be(dst + 12, header.year, 4);
+	store_be(dst + 16, header.text_bytes, 8);
+	store_be(dst + 24, header.text_crc, 4);
+	store_be(dst + 28, header.records_crc, 4);
+	store_be(dst + 32, header.n_records, 8);
+	store_be(dst + 40, crc32c_update(0, dst, 40), 4);
+}
+
+static int32_t decode_cache_header(const uint8_t *src, parse_cache_header_t& header)
+{
+	if( 0 != std::memcmp(src, LOTTO_PARSE_CACHE_MAGIC, 8) || \
+		crc32c_update(0, src, 40) != (uint32_t) load_be(src + 40, 4) )
+	{
+		return -1;
+	}
+	header.version = (uint32_t) load_be(src + 8, 4);
+	header.year = (uint32_t) load_be(src + 12, 4);
+	header.text_bytes = load_be(src + 16, 8);
+	header.text_crc = (uint32_t) load_be(src + 24, 4);
+	header.records_crc = (uint32_t) load_be(src + 28, 4);
+	header.n_records = load_be(src + 32, 8);
+	return 0;
+}
+
+boost::filesystem::path parse_cache_path(uint32_t year)
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%04u.cache", year);
+	return boost::filesystem::path(LOTTO_PARSE_CACHE_DIR) / name;
+}
+
+// size and CRC-32C of the year file, -1 when it can not be read
+static int32_t hash_year_file(uint32_t year, uint64_t& text_bytes, uint32_t& text_crc)
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%04u.txt", year);
+	boost::system::error_code ec;
+	if( !boost::filesystem::is_regular_file(name, ec) || 0 == boost::filesystem::file_size(name, ec) )
+	{
+		return -1;
+	}
+	mapped_file_t infile;
+	if( infile.open(name) )
+	{
+		return -1;
+	}
+	text_bytes = infile.size();
+	text_crc = crc32c_update(0, (const uint8_t *) infile.data(), infile.size());
+	return 0;
+}
+
+// append the cached records of the year when the cache matches the text
+static int32_t load_cached_year(std::vector<extraction_t>& extraction_vec, uint32_t year, uint64_t text_bytes, uint32_t text_crc)
+{
+	const boost::filesystem::path file_cache = parse_cache_path(year);
+	boost::system::error_code ec;
+	if( !boost::filesystem::is_regular_file(file_cache, ec) )
+	{
+		return -1;
+	}
+	mapped_file_t infile;
+	if( infile.open(file_cache.c_str()) || infile.size() < LOTTO_PARSE_CACHE_HEADER )
+	{
+		return -1;
+	}
+	const uint8_t *data = (const uint8_t *) infile.data();
+	parse_cache_header_t header;
+	if( decode_cache_header(data, header) || \
+		LOTTO_PARSE_CACHE_VERSION != header.version || year != header.year || \
+		text_bytes != header.text_bytes || text_crc != header.text_crc || \
+		infile.size() != LOTTO_PARSE_CACHE_HEADER + header.n_records * LOTTO_RECORD_BYTES || \
+		header.records_crc != crc32c_update(0, data + LOTTO_PARSE_CACHE_HEADER, header.n_records * LOTTO_RECORD_BYTES) )
+	{
+		return -1;
+	}
+
+	const size_t first = extraction_vec.size();
+	extraction_vec.resize(first + header.n_records);
+	decode_records(data + LOTTO_PARSE_CACHE_HEADER, header.n_records, extraction_vec.data() + first);
+	return 0;
+}
+
+static int32_t save_cached_year(const extraction_t *records, size_t n, uint32_t year, uint64_t text_bytes, uint32_t text_crc)
+{
+	boost::system::error_code ec;
+	boost::filesystem::create_directories(LOTTO_PARSE_CACHE_DIR, ec);
+	if(ec)
+	{
+		LOTTO_LOG(LOG_WARN) << "Warning: could not create the parse cache " << LOTTO_PARSE_CACHE_DIR << ": " << ec.message();
+		return -1;
+	}
+
+	std::vector<uint8_t> encoded(LOTTO_PARSE_CACHE_HEADER + n * LOTTO_RECORD_BYTES);
+	encode_records(records, n, encoded.data() + LOTTO_PARSE_CACHE_HEADER);
+	parse_cache_header_t header;
+	header.version = LOTTO_PARSE_CACHE_VERSION;
+	header.year = year;
+	header.text_bytes = text_bytes;
+	header.text_crc = text_crc;
+	header.records_crc = crc32c_update(0, encoded.data() + LOTTO_PARSE_CACHE_HEADER, n * LOTTO_RECORD_BYTES);
+	header.n_records = n;
+	encode_cache_header(header, encoded.data());
+
+	const boost::filesystem::path file_cache = parse_cache_path(year);
+	db_file_writer_t writer;
+	if( writer.open(file_cache.c_str(), encoded.size()) || \
+		writer.write_bytes(encoded.data(), encoded.size()) || \
+		writer.commit() )
+	{
+		LOTTO_LOG(LOG_WARN) << "Warning: could not write the parse cache " << file_cache.c_str();
+		return -1;
+	}
+	return 0;
+}
+
+int32_t process_file_cached(std::vector<extraction_t>& extraction_vec, uint32_t year)
+{
+	uint64_t text_bytes = 0;
+	uint32_t text_crc = 0;
+	if( hash_year_file(year, text_bytes, text_crc) )
+	{
+		// missing or empty, reported by the parser
+		return process_file(extraction_vec, year);
+	}
+	if( 0 == load_cached_year(extraction_vec, year, text_bytes, text_crc) )
+	{
+		LOTTO_LOG(LOG_DEBUG) << "... cached year: " << year;
+		return 0;
+	}
+
+	const size_t first = extraction_vec.size();
+	int32_t ret = process_file(extraction_vec, year);
+	if(ret)
+	{
+		return ret;
+	}
+	// a file rewritten while it was parsed is not cached
+	uint64_t after_bytes = 0;
+	uint32_t after_crc = 0;
+	if( 0 == hash_year_file(year, after_bytes, after_crc) && after_bytes == text_bytes && after_crc == text_crc )
+	{
+		save_cached_year(extraction_vec.data() + first, extraction_vec.size() - first, year, text_bytes, text_crc);
+	}
+	return 0;
+}
@@ -0,0 +1,661 @@
+/*
+ * query_daemon.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "db_io.h"
+#include "db_file.h"
+#include "db_query.h"
+#include "ritardo_index.h"
+#include "utilities.h"
+#include "logger.h"
+#include "query_daemon.h"
+
+#define LOTTO_DAEMON_EVENTS        (64)
+#define LOTTO_DAEMON_READ_BYTES    (64 * 1024)
+// a client with this much unsent is not read, nor polled for input,
+// until it drains
+#define LOTTO_DAEMON_MAX_PENDING   (4 * 1024 * 1024)
+
+// what tells a new version of the db file apart
+typedef struct FILE_IDENTITY
+{
+	uint64_t dev;
+	uint64_t ino;
+	uint64_t size;
+	int64_t  mtime_ns;
+} file_identity_t;
+
+// immutable once published, shared by the queries of a batch
+typedef struct DB_SNAPSHOT
+{
+	db_reader_t           reader;
+	file_identity_t       identity;
+	uint32_t              generation;
+	ritardo_index_t       ritardo;
+	// counts[ruota][number] of the records before each block, only with
+	// a month index, the range of a query is then exact
+	std::vector<uint32_t> prefix;
+} db_snapshot_t;
+
+#define LOTTO_PREFIX_ROW      (91)
+#define LOTTO_PREFIX_TABLE    (ruota_t::TUTTE * LOTTO_PREFIX_ROW)
+
+static std::atomic<bool> daemon_stop(false);
+
+static void on_stop_signal(int)
+{
+	daemon_stop = true;
+}
+
+void encode_request(const daemon_request_t& request, uint8_t *dst)
+{
+	std::memset(dst, 0, LOTTO_DAEMON_REQUEST_BYTES);
+	dst[0] = request.op;
+	dst[1] = (uint8_t) request.ruota;
+	store_be(dst + 4, request.from_date, 4);
+	store_be(dst + 8, request.to_date, 4);
+	store_be(dst + 12, request.limit, 4);
+}
+
+void decode_request(const uint8_t *src, daemon_request_t& request)
+{
+	request.op = (query_op_t) src[0];
+	request.ruota = (ruota_t) src[1];
+	request.from_date = (uint32_t) load_be(src + 4, 4);
+	request.to_date = (uint32_t) load_be(src + 8, 4);
+	request.limit = (uint32_t) load_be(src + 12, 4);
+}
+
+static int32_t stat_identity(const boost::filesystem::path& file_db, file_identity_t& identity)
+{
+	struct stat st;
+	if( ::stat(file_db.c_str(), &st) )
+	{
+		return -1;
+	}
+	identity.dev = (uint64_t) st.st_dev;
+	identity.ino = (uint64_t) st.st_ino;
+	identity.size = (uint64_t) st.st_size;
+	identity.mtime_ns = (int64_t) st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+	return 0;
+}
+
+static bool same_identity(const file_identity_t& a, const file_identity_t& b)
+{
+	return a.dev == b.dev && a.ino == b.ino && a.size == b.size && a.mtime_ns == b.mtime_ns;
+}
+
+static void add_counts(const frequency_table_t& table, uint32_t *counts)
+{
+	for( uint32_t r = 0; r < ruota_t::TUTTE; r++ )
+	{
+		for( uint32_t number = 1; number <= 90; number++ )
+		{
+			counts[r * LOTTO_PREFIX_ROW + number] += table.counts[r][number];
+		}
+	}
+}
+
+static std::shared_ptr<db_snapshot_t> load_snapshot(const boost::filesystem::path& file_db, uint32_t generation)
+{
+	std::shared_ptr<db_snapshot_t> snapshot = std::make_shared<db_snapshot_t>();
+	// taken before the mapping: a file replaced in between is reloaded again
+	if( stat_identity(file_db, snapshot->identity) || snapshot->reader.open(file_db.c_str()) )
+	{
+		return NULL;
+	}
+	// a db torn by a writer not going through a temporary file is not
+	// served, it is tried again when it changes
+	uint32_t crc = 0;
+	if( snapshot->reader.layout().has_trailer && snapshot->reader.verify(crc) )
+	{
+		return NULL;
+	}
+	snapshot->generation = generation;
+	const db_layout_t& layout = snapshot->reader.layout();
+	const db_range_t records = snapshot->reader.records();
+
+	// the index on disk is used when it matches this very db
+	if( !layout.has_trailer || \
+		load_ritardo_index(ritardo_index_path(file_db), snapshot->ritardo) || \
+		snapshot->ritardo.db_records != layout.n_records || \
+		snapshot->ritardo.db_crc != layout.crc )
+	{
+		ritardo_reset(snapshot->ritardo);
+		const size_t chunk = 64 * 1024;
+		std::vector<extraction_t> buffer(chunk);
+		for( uint64_t i = 0; i < records.size(); i += chunk )
+		{
+			const size_t n = (size_t) std::min<uint64_t>(chunk, records.size() - i);
+			records.decode(i, n, buffer.data());
+			ritardo_update(snapshot->ritardo, buffer.data(), n);
+		}
+	}
+
+	if( NULL != layout.months )
+	{
+		const uint64_t n_blocks = records.size() / LOTTO_DAEMON_PREFIX_RECORDS;
+		snapshot->prefix.assign((n_blocks + 1) * LOTTO_PREFIX_TABLE, 0);
+		frequency_table_t table;
+		for( uint64_t b = 0; b < n_blocks; b++ )
+		{
+			uint32_t *next = snapshot->prefix.data() + (b + 1) * LOTTO_PREFIX_TABLE;
+			std::memcpy(next, next - LOTTO_PREFIX_TABLE, LOTTO_PREFIX_TABLE * sizeof(uint32_t));
+			compute_frequencies(records.subrange(b * LOTTO_DAEMON_PREFIX_RECORDS, LOTTO_DAEMON_PREFIX_RECORDS),
+					0, 0xFFFFFFFF, table);
+			add_counts(table, next);
+		}
+	}
+
+	return snapshot;
+}
+
+// counts[ruota][number] of the records dated from_date to to_date
+static uint64_t snapshot_frequencies(const db_snapshot_t& snapshot, uint32_t from_date, uint32_t to_date, uint32_t *counts)
+{
+	std::memset(counts, 0, LOTTO_PREFIX_TABLE * sizeof(uint32_t));
+	const db_range_t range = snapshot.reader.range(from_date, to_date);
+	frequency_table_t table;
+	if( snapshot.prefix.empty() )
+	{
+		compute_frequencies(range, from_date, to_date, table);
+		add_counts(table, counts);
+		return table.n_records;
+	}
+
+	// whole blocks from the prefix sums, the ends of the range scanned
+	const uint64_t first = range.first_record();
+	const uint64_t end = first + range.size();
+	const uint64_t first_block = (first + LOTTO_DAEMON_PREFIX_RECORDS - 1) / LOTTO_DAEMON_PREFIX_RECORDS;
+	const uint64_t end_block = end / LOTTO_DAEMON_PREFIX_RECORDS;
+	if( first_block >= end_block )
+	{
+		compute_frequencies(range, 0, 0xFFFFFFFF, table);
+		add_counts(table, counts);
+		return range.size();
+	}
+
+	const uint32_t *lo = snapshot.prefix.data() + first_block * LOTTO_PREFIX_TABLE;
+	const uint32_t *hi = snapshot.prefix.data() + end_block * LOTTO_PREFIX_TABLE;
+	for( size_t k = 0; k < LOTTO_PREFIX_TABLE; k++ )
+	{
+		counts[k] = hi[k] - lo[k];
+	}
+	const uint64_t head = first_block * LOTTO_DAEMON_PREFIX_RECORDS - first;
+	compute_frequencies(range.subrange(0, head), 0, 0xFFFFFFFF, table);
+	add_counts(table, counts);
+	const uint64_t tail = end_block * LOTTO_DAEMON_PREFIX_RECORDS - first;
+	compute_frequencies(range.subrange(tail, range.size() - tail), 0, 0xFFFFFFFF, table);
+	add_counts(table, counts);
+
+	return range.size();
+}
+
+static void append_u32(std::vector<uint8_t>& out, uint64_t value)
+{
+	uint8_t bytes[4];
+	store_be(bytes, value, 4);
+	out.insert(out.end(), bytes, bytes + 4);
+}
+
+static void append_u64(std::vector<uint8_t>& out, uint64_t value)
+{
+	uint8_t bytes[8];
+	store_be(bytes, value, 8);
+	out.insert(out.end(), bytes, bytes + 8);
+}
+
+// the reply to one request appended to out
+static void answer_request(const db_snapshot_t& snapshot, const daemon_request_t& request, std::vector<uint8_t>& out)
+{
+	const size_t reply = out.size();
+	append_u32(out, REPLY_OK);
+	append_u32(out, 0);
+
+	const db_layout_t& layout = snapshot.reader.layout();
+	bool ok = true;
+	switch (request.op)
+	{
+		case query_op_t::QUERY_INFO:
+			append_u32(out, snapshot.generation);
+			append_u32(out, layout.version);
+			append_u64(out, layout.n_records);
+			append_u32(out, layout.crc);
+			append_u32(out, layout.first_date);
+			append_u32(out, layout.last_date);
+			append_u32(out, 0);
+			break;
+		case query_op_t::QUERY_FREQUENCY:
+		{
+			if( request.ruota > ruota_t::TUTTE )
+			{
+				ok = false;
+				break;
+			}
+			uint32_t counts[LOTTO_PREFIX_TABLE];
+			append_u64(out, snapshot_frequencies(snapshot, request.from_date, request.to_date, counts));
+			for( uint32_t number = 1; number <= 90; number++ )
+			{
+				uint32_t count = 0;
+				for( uint32_t r = 0; r < ruota_t::TUTTE; r++ )
+				{
+					if( ruota_t::TUTTE == request.ruota || r == request.ruota )
+					{
+						count += counts[r * LOTTO_PREFIX_ROW + number];
+					}
+				}
+				append_u32(out, count);
+			}
+			break;
+		}
+		case query_op_t::QUERY_RITARDO:
+			if( request.ruota >= ruota_t::TUTTE )
+			{
+				ok = false;
+				break;
+			}
+			append_u32(out, snapshot.ritardo.draws[request.ruota]);
+			append_u32(out, snapshot.ritardo.last_date[request.ruota]);
+			for( uint32_t number = 1; number <= 90; number++ )
+			{
+				append_u32(out, ritardo_current(snapshot.ritardo, request.ruota, number));
+				append_u32(out, ritardo_max(snapshot.ritardo, request.ruota, number));
+			}
+			break;
+		case query_op_t::QUERY_RANGE:
+		{
+			// without a month index the records are filtered one by one
+			const db_range_t range = snapshot.reader.range(request.from_date, request.to_date);
+			const uint32_t limit = std::min<uint32_t>(request.limit, LOTTO_DAEMON_MAX_RANGE);
+			const size_t header = out.size();
+			append_u64(out, 0);
+			append_u32(out, 0);
+			append_u32(out, 0);
+			uint64_t total = 0;
+			uint32_t returned = 0;
+			if( NULL != layout.months )
+			{
+				total = range.size();
+				returned = (uint32_t) std::min<uint64_t>(limit, total);
+				const size_t at = out.size();
+				out.resize(at + (size_t) returned * LOTTO_RECORD_BYTES);
+				range.encode(0, returned, out.data() + at);
+			}
+			else
+			{
+				for( uint64_t i = 0; i < range.size(); i++ )
+				{
+					const uint32_t date = stored_record_date(range.bytes() + i * LOTTO_RECORD_BYTES);
+					if( date < request.from_date || date > request.to_date )
+					{
+						continue;
+					}
+					if( returned < limit )
+					{
+						const size_t at = out.size();
+						out.resize(at + LOTTO_RECORD_BYTES);
+						range.encode(i, 1, out.data() + at);
+						returned++;
+					}
+					total++;
+				}
+			}
+			store_be(out.data() + header, total, 8);
+			store_be(out.data() + header + 8, returned, 4);
+			break;
+		}
+		default:
+			ok = false;
+			break;
+	}
+
+	if( !ok )
+	{
+		out.resize(reply + LOTTO_DAEMON_REPLY_BYTES);
+		store_be(out.data() + reply, REPLY_BAD_REQUEST, 4);
+	}
+	store_be(out.data() + reply + 4, out.size() - reply - LOTTO_DAEMON_REPLY_BYTES, 4);
+}
+
+typedef struct DAEMON_CLIENT
+{
+	std::vector<uint8_t> in;
+	std::vector<uint8_t> out;
+	size_t               out_done;
+	uint32_t             events;    // registered with epoll
+} daemon_client_t;
+
+static bool client_backlogged(const daemon_client_t& client)
+{
+	return client.out.size() - client.out_done >= LOTTO_DAEMON_MAX_PENDING;
+}
+
+// send what is pending, false when the client is gone
+static bool flush_client(int epoll_fd, int fd, daemon_client_t& client)
+{
+	while( client.out_done < client.out.size() )
+	{
+		ssize_t ret = ::send(fd, client.out.data() + client.out_done, client.out.size() - client.out_done, MSG_NOSIGNAL);
+		if( ret < 0 )
+		{
+			if( EINTR == errno )
+				continue;
+			if( EAGAIN == errno || EWOULDBLOCK == errno )
+				break;
+			return false;
+		}
+		client.out_done += (size_t) ret;
+	}
+	if( client.out_done == client.out.size() )
+	{
+		client.out.clear();
+		client.out_done = 0;
+	}
+
+	// wait for room in the socket only while something is pending, and
+	// for requests only while the replies pending are below the limit:
+	// polled for input meanwhile, a client not reading would wake the
+	// loop at once on every turn
+	const uint32_t events = ( client_backlogged(client) ? 0u : (uint32_t) EPOLLIN ) | ( client.out.empty() ? 0u : (uint32_t) EPOLLOUT );
+	if( events != client.events )
+	{
+		struct epoll_event ev;
+		ev.events = events;
+		ev.data.fd = fd;
+		::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+		client.events = events;
+	}
+	return true;
+}
+
+// read what arrived and answer every complete request, false when the
+// client is gone
+static bool serve_client(int epoll_fd, int fd, daemon_client_t& client, const db_snapshot_t& snapshot)
+{
+	bool open = true;
+	uint8_t buffer[LOTTO_DAEMON_READ_BYTES];
+	while( !client_backlogged(client) )
+	{
+		ssize_t ret = ::recv(fd, buffer, sizeof(buffer), 0);
+		if( ret < 0 )
+		{
+			if( EINTR == errno )
+				continue;
+			if( EAGAIN != errno && EWOULDBLOCK != errno )
+				open = false;
+			break;
+		}
+		if( 0 == ret )
+		{
+			open = false;
+			break;
+		}
+		client.in.insert(client.in.end(), buffer, buffer + ret);
+
+		// the whole batch is answered before a single send
+		size_t done = 0;
+		daemon_request_t request;
+		while( client.in.size() - done >= LOTTO_DAEMON_REQUEST_BYTES )
+		{
+			decode_request(client.in.data() + done, request);
+			answer_request(snapshot, request, client.out);
+			done += LOTTO_DAEMON_REQUEST_BYTES;
+		}
+		client.in.erase(client.in.begin(), client.in.begin() + done);
+	}
+
+	return flush_client(epoll_fd, fd, client) && open;
+}
+
+int32_t serve_db(const boost::filesystem::path& file_db, const boost::filesystem::path& socket_path)
+{
+	uint32_t generation = 1;
+	std::shared_ptr<db_snapshot_t> current = load_snapshot(file_db, generation);
+	if( NULL == current )
+	{
+		return -1;
+	}
+
+	struct sockaddr_un addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if( socket_path.string().size() >= sizeof(addr.sun_path) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! socket path too long: " << socket_path.c_str();
+		return -1;
+	}
+	std::strcpy(addr.sun_path, socket_path.c_str());
+
+	// a socket left by a previous daemon is replaced, nothing else is
+	struct stat st;
+	if( 0 == ::lstat(socket_path.c_str(), &st) )
+	{
+		if( !S_ISSOCK(st.st_mode) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error! file " << socket_path.c_str() << " exists and is not a socket.";
+			return -1;
+		}
+		::unlink(socket_path.c_str());
+	}
+
+	int listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if( listen_fd < 0 || \
+		::bind(listen_fd, (const struct sockaddr *) &addr, sizeof(addr)) || \
+		::listen(listen_fd, SOMAXCONN) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not listen on " << socket_path.c_str() << ": " << std::strerror(errno);
+		if( listen_fd >= 0 )
+			::close(listen_fd);
+		return -1;
+	}
+	int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.fd = listen_fd;
+	::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+
+	daemon_stop = false;
+	std::signal(SIGINT, on_stop_signal);
+	std::signal(SIGTERM, on_stop_signal);
+
+	// the db is checked in the background, a new version is loaded aside
+	// and published in one step; batches in flight keep the old one
+	std::thread reloader([&]()
+	{
+		file_identity_t failed = { 0, 0, 0, 0 };
+		while( !daemon_stop )
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(LOTTO_DAEMON_RELOAD_MS));
+			file_identity_t identity;
+			const std::shared_ptr<db_snapshot_t> serving = std::atomic_load(&current);
+			if( stat_identity(file_db, identity) || same_identity(identity, serving->identity) || \
+				same_identity(identity, failed) )
+			{
+				continue;
+			}
+			std::shared_ptr<db_snapshot_t> loaded = load_snapshot(file_db, serving->generation + 1);
+			if( NULL == loaded )
+			{
+				// not retried until the file changes again
+				failed = identity;
+				continue;
+			}
+			std::atomic_store(&current, loaded);
+			LOTTO_LOG(LOG_INFO) << "reloaded " << file_db.c_str() << ", generation " << loaded->generation << ", " << \
+					loaded->reader.size() << " records";
+		}
+	});
+
+	LOTTO_LOG(LOG_INFO) << "serving " << file_db.c_str() << " (" << current->reader.size() << " records) on " << \
+			socket_path.c_str();
+
+	std::unordered_map<int, daemon_client_t> clients;
+	struct epoll_event events[LOTTO_DAEMON_EVENTS];
+	while( !daemon_stop )
+	{
+		const int n = ::epoll_wait(epoll_fd, events, LOTTO_DAEMON_EVENTS, LOTTO_DAEMON_RELOAD_MS);
+		if( n < 0 )
+		{
+			if( EINTR == errno )
+				continue;
+			LOTTO_LOG(LOG_ERROR) << "Error: epoll_wait failed: " << std::strerror(errno);
+			break;
+		}
+
+		// one snapshot for the whole batch of ready clients
+		const std::shared_ptr<db_snapshot_t> snapshot = std::atomic_load(&current);
+		for( int k = 0; k < n; k++ )
+		{
+			const int fd = events[k].data.fd;
+			if( fd == listen_fd )
+			{
+				int client_fd;
+				while( (client_fd = ::accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0 )
+				{
+					struct epoll_event cev;
+					cev.events = EPOLLIN;
+					cev.data.fd = client_fd;
+					::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_fd, &cev);
+					clients[client_fd] = daemon_client_t{ {}, {}, 0, EPOLLIN };
+				}
+				continue;
+			}
+
+			auto it = clients.find(fd);
+			if( clients.end() == it )
+			{
+				continue;
+			}
+			bool open = true;
+			if( events[k].events & EPOLLOUT )
+			{
+				open = flush_client(epoll_fd, fd, it->second);
+			}
+			if( open && ( events[k].events & (EPOLLIN | EPOLLHUP | EPOLLERR) ) )
+			{
+				open = serve_client(epoll_fd, fd, it->second, *snapshot);
+			}
+			if( !open )
+			{
+				::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+				::close(fd);
+				clients.erase(it);
+			}
+		}
+	}
+
+	daemon_stop = true;
+	reloader.join();
+	for( auto& client : clients )
+	{
+		::close(client.first);
+	}
+	::close(epoll_fd);
+	::close(listen_fd);
+	::unlink(socket_path.c_str());
+	std::signal(SIGINT, SIG_DFL);
+	std::signal(SIGTERM, SIG_DFL);
+	LOTTO_LOG(LOG_INFO) << "stopped serving " << file_db.c_str();
+
+	return 0;
+}
+
+int daemon_connect(const boost::filesystem::path& socket_path)
+{
+	struct sockaddr_un addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if( socket_path.string().size() >= sizeof(addr.sun_path) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! socket path too long: " << socket_path.c_str();
+		return -1;
+	}
+	std::strcpy(addr.sun_path, socket_path.c_str());
+
+	int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if( fd < 0 || ::connect(fd, (const struct sockaddr *) &addr, sizeof(addr)) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not connect to " << socket_path.c_str() << ": " << std::strerror(errno);
+		if( fd >= 0 )
+			::close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+static int32_t read_exact(int fd, uint8_t *dst, size_t n)
+{
+	size_t done = 0;
+	while( done < n )
+	{
+		ssize_t ret = ::recv(fd, dst + done, n - done, 0);
+		if( ret < 0 && EINTR == errno )
+			continue;
+		if( ret <= 0 )
+			return -1;
+		done += (size_t) ret;
+	}
+	return 0;
+}
+
+int32_t daemon_query(int fd, const daemon_request_t *requests, size_t n, std::vector<uint32_t>& statuses,
+		std::vector<size_t>& offsets, std::vector<uint8_t>& payload)
+{
+	std::vector<uint8_t> bytes(n * LOTTO_DAEMON_REQUEST_BYTES);
+	for( size_t i = 0; i < n; i++ )
+	{
+		encode_request(requests[i], bytes.data() + i * LOTTO_DAEMON_REQUEST_BYTES);
+	}
+	size_t sent = 0;
+	while( sent < bytes.size() )
+	{
+		ssize_t ret = ::send(fd, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+		if( ret < 0 && EINTR == errno )
+			continue;
+		if( ret <= 0 )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: could not send the requests: " << std::strerror(errno);
+			return -1;
+		}
+		sent += (size_t) ret;
+	}
+
+	for( size_t i = 0; i < n; i++ )
+	{
+		uint8_t reply[LOTTO_DAEMON_REPLY_BYTES];
+		if( read_exact(fd, reply, sizeof(reply)) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: connection closed before the reply";
+			return -1;
+		}
+		const size_t size = (size_t) load_be(reply + 4, 4);
+		statuses.push_back((uint32_t) load_be(reply, 4));
+		offsets.push_back(payload.size());
+		payload.resize(payload.size() + size);
+		if( read_exact(fd, payload.data() + payload.size() - size, size) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: connection closed before the reply";
+			return -1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * record_scanner.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include "utilities.h"
+#include "record_scanner.h"
+
+static inline bool is_digit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+// two characters token, same rules as strtoul: a digit optionally
+// followed by a second one, or a white space or plus sign followed
+// by a digit; 0 when invalid
+static inline uint64_t decode_number(const char *t, size_t len)
+{
+	if( 2 != len )
+		return 0;
+
+	const char c0 = t[0];
+	const char c1 = t[1];
+	if( is_digit(c0) )
+	{
+		uint64_t value = (uint64_t) (c0 - '0');
+		if( is_digit(c1) )
+		{
+			value = value * 10 + (uint64_t) (c1 - '0');
+		}
+		return value;
+	}
+	if( ( '+' == c0 || ( c0 >= '\t' && c0 <= '\r' ) ) && is_digit(c1) )
+	{
+		return (uint64_t) (c1 - '0');
+	}
+	return 0;
+}
+
+scan_status_t scan_record(std::string_view line, size_t n_ruote, record_t& record)
+{
+	const size_t record_size = 2 + (5 * n_ruote) + 1;
+	const size_t n_numbers = 5 * n_ruote;
+
+	const char *p = line.data();
+	const char *end = p + line.size();
+
+	scan_status_t status = scan_status_t::SCAN_OK;
+	bool first_is_end = false;
+	size_t tok = 0;
+
+	record.day = 0;
+	record.month = mese_t::NULL_MESE;
+	record.bad_value = 0;
+
+	while( true )
+	{
+		while( p < end && ' ' == *p )
+			p++;
+		if( p == end )
+			break;
+
+		const char *t = p;
+		while( p < end && ' ' != *p )
+			p++;
+		const size_t len = (size_t) (p - t);
+
+		if( tok >= 2 )
+		{
+			const size_t k = tok - 2;
+			if( k < n_numbers && scan_status_t::SCAN_OK == status )
+			{
+				uint64_t number = 0;
+				if( !( 2 == len && '-' == t[0] && '-' == t[1] ) )
+				{
+					number = decode_number(t, len);
+					if( number < 1 || number > 90 )
+					{
+						status = scan_status_t::SCAN_BAD_NUMBER;
+						record.bad_token = std::string_view(t, len);
+						record.bad_value = number;
+					}
+				}
+				record.numbers[k] = number;
+			}
+		}
+		else if( 0 == tok )
+		{
+			first_is_end = ( 3 == len && 'E' == t[0] && 'N' == t[1] && 'D' == t[2] );
+			record.day = decode_number(t, len);
+			if( record.day < 1 || record.day > 31 )
+			{
+				status = scan_status_t::SCAN_BAD_DAY;
+				record.bad_token = std::string_view(t, len);
+				record.bad_value = record.day;
+			}
+		}
+		else
+		{
+			record.month = convert_string_to_mese(std::string_view(t, len));
+			if( mese_t::NULL_MESE == record.month && scan_status_t::SCAN_OK == status )
+			{
+				status = scan_status_t::SCAN_BAD_MONTH;
+				record.bad_token = std::string_view(t, len);
+			}
+		}
+		tok++;
+	}
+	record.tok_size = tok;
+
+	if( first_is_end && ( 1 == tok || record_size == tok ) )
+	{
+		return scan_status_t::SCAN_END;
+	}
+	if( record_size != tok )
+	{
+		return scan_status_t::SCAN_ILL_FORMED;
+	}
+	return status;
+}
@@ -0,0 +1,192 @@
+/*
+ * ritardo_index.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstring>
+#include <vector>
+#include "db_io.h"
+#include "db_file.h"
+#include "mapped_file.h"
+#include "utilities.h"
+#include "logger.h"
+#include "ritardo_index.h"
+
+#define LOTTO_RITARDO_HEADER_BYTES    (32)
+#define LOTTO_RITARDO_BYTES           (LOTTO_RITARDO_HEADER_BYTES + ruota_t::TUTTE * 8 + ruota_t::TUTTE * 90 * 8)
+
+void ritardo_reset(ritardo_index_t& index)
+{
+	std::memset(&index, 0, sizeof(index));
+}
+
+void ritardo_update(ritardo_index_t& index, const extraction_t *records, size_t n)
+{
+	for( size_t i = 0; i < n; i++ )
+	{
+		const extraction_t& e = records[i];
+		const uint32_t date = extraction_date(e);
+		if( e.ruota() >= ruota_t::TUTTE || date <= index.last_date[e.ruota()] )
+		{
+			continue;
+		}
+
+		const uint32_t draw = ++index.draws[e.ruota()];
+		index.last_date[e.ruota()] = date;
+		const uint64_t numbers[5] = { e.a(), e.b(), e.c(), e.d(), e.e() };
+		for( uint64_t number : numbers )
+		{
+			// 0 is a missing number
+			if( 0 == number || number > 90 )
+			{
+				continue;
+			}
+			ritardo_entry_t& entry = index.entries[e.ruota()][number];
+			const uint32_t delay = draw - 1 - entry.last_seen;
+			if( delay > entry.max_delay )
+			{
+				entry.max_delay = delay;
+			}
+			entry.last_seen = draw;
+		}
+	}
+}
+
+boost::filesystem::path ritardo_index_path(const boost::filesystem::path& file_db)
+{
+	boost::filesystem::path file_rit(file_db);
+	file_rit += LOTTO_RITARDO_SUFFIX;
+	return file_rit;
+}
+
+int32_t save_ritardo_index(const ritardo_index_t& index, const boost::filesystem::path& file_rit)
+{
+	std::vector<uint8_t> image(LOTTO_RITARDO_BYTES, 0);
+	uint8_t *p = image.data();
+	std::memcpy(p, LOTTO_RITARDO_MAGIC, 8);
+	store_be(p + 8, LOTTO_RITARDO_VERSION, 4);
+	store_be(p + 12, ruota_t::TUTTE, 4);
+	store_be(p + 16, index.db_records, 8);
+	store_be(p + 24, index.db_crc, 4);
+	p += LOTTO_RITARDO_HEADER_BYTES;
+	for( uint32_t r = 0; r < ruota_t::TUTTE; r++, p += 8 )
+	{
+		store_be(p, index.draws[r], 4);
+		store_be(p + 4, index.last_date[r], 4);
+	}
+	for( uint32_t r = 0; r < ruota_t::TUTTE; r++ )
+	{
+		for( uint32_t number = 1; number <= 90; number++, p += 8 )
+		{
+			store_be(p, index.entries[r][number].last_seen, 4);
+			store_be(p + 4, index.entries[r][number].max_delay, 4);
+		}
+	}
+
+	db_file_writer_t writer;
+	if( writer.open(file_rit.c_str(), image.size()) || \
+		writer.write_bytes(image.data(), image.size()) || \
+		writer.commit() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << file_rit.c_str();
+		writer.abort();
+		return -1;
+	}
+
+	return 0;
+}
+
+int32_t load_ritardo_index(const boost::filesystem::path& file_rit, ritardo_index_t& index)
+{
+	// a missing index is not an error, it is built on demand
+	if( !boost::filesystem::exists(file_rit) )
+	{
+		return -1;
+	}
+	mapped_file_t infile;
+	if( infile.open(file_rit.c_str()) )
+	{
+		return -1;
+	}
+	const uint8_t *p = (const uint8_t *) infile.data();
+	if( LOTTO_RITARDO_BYTES != infile.size() || 0 != std::memcmp(p, LOTTO_RITARDO_MAGIC, 8) || \
+		LOTTO_RITARDO_VERSION != load_be(p + 8, 4) || ruota_t::TUTTE != load_be(p + 12, 4) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: " << file_rit.c_str() << " is not a ritardo index";
+		return -1;
+	}
+
+	ritardo_reset(index);
+	index.db_records = load_be(p + 16, 8);
+	index.db_crc = (uint32_t) load_be(p + 24, 4);
+	p += LOTTO_RITARDO_HEADER_BYTES;
+	for( uint32_t r = 0; r < ruota_t::TUTTE; r++, p += 8 )
+	{
+		index.draws[r] = (uint32_t) load_be(p, 4);
+		index.last_date[r] = (uint32_t) load_be(p + 4, 4);
+	}
+	for( uint32_t r = 0; r < ruota_t::TUTTE; r++ )
+	{
+		for( uint32_t number = 1; number <= 90; number++, p += 8 )
+		{
+			index.entries[r][number].last_seen = (uint32_t) load_be(p, 4);
+			index.entries[r][number].max_delay = (uint32_t) load_be(p + 4, 4);
+			if( index.entries[r][number].last_seen > index.draws[r] )
+			{
+				LOTTO_LOG(LOG_ERROR) << "Error: " << file_rit.c_str() << " is corrupted";
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int32_t load_current_ritardo_index(const boost::filesystem::path& file_db, ritardo_index_t& index)
+{
+	db_reader_t reader;
+	if( reader.open(file_db.c_str()) )
+	{
+		return -1;
+	}
+	const db_layout_t& layout = reader.layout();
+
+	// without a trailer there is nothing to tie the index to the db
+	if( !layout.has_trailer || \
+		load_ritardo_index(ritardo_index_path(file_db), index) || \
+		index.db_records != layout.n_records || \
+		index.db_crc != layout.crc )
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+int32_t build_ritardo_index(const boost::filesystem::path& file_db, ritardo_index_t& index)
+{
+	db_reader_t reader;
+	if( reader.open(file_db.c_str()) )
+	{
+		return -1;
+	}
+
+	ritardo_reset(index);
+	index.db_records = reader.size();
+	index.db_crc = reader.layout().crc;
+
+	// decode in chunks to keep the buffer in cache
+	const db_range_t range = reader.records();
+	const size_t chunk = 64 * 1024;
+	std::vector<extraction_t> records(chunk);
+	for( uint64_t i = 0; i < range.size(); i += chunk )
+	{
+		const size_t n = (size_t) std::min<uint64_t>(chunk, range.size() - i);
+		range.decode(i, n, records.data());
+		ritardo_update(index, records.data(), n);
+	}
+
+	return save_ritardo_index(index, ritardo_index_path(file_db));
+}
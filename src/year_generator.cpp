@@ -0,0 +1,145 @@
+/*
+ * year_generator.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <stdio.h>
+#include <boost/filesystem.hpp>
+#include "utilities.h"
+#include "db_io.h"
+#include "logger.h"
+#include "year_generator.h"
+
+// the order of the recent year files
+static const ruota_t generated_ruote[] =
+{
+	ruota_t::BARI,
+	ruota_t::CAGLIARI,
+	ruota_t::FIRENZE,
+	ruota_t::GENOVA,
+	ruota_t::MILANO,
+	ruota_t::NAPOLI,
+	ruota_t::PALERMO,
+	ruota_t::ROMA,
+	ruota_t::TORINO,
+	ruota_t::VENEZIA,
+	ruota_t::NAZIONALE,
+};
+
+static const uint32_t days_in_month[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+// splitmix64
+static inline uint64_t next_random(uint64_t& state)
+{
+	uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static inline void append_two_digits(std::string& text, uint32_t value)
+{
+	text.push_back((char) ('0' + value / 10));
+	text.push_back((char) ('0' + value % 10));
+}
+
+void generate_year_text(uint32_t year, uint32_t draws, uint64_t seed, std::string& text)
+{
+	const size_t n_ruote = sizeof(generated_ruote) / sizeof(generated_ruote[0]);
+	char year_cstr[16];
+	std::snprintf(year_cstr, sizeof(year_cstr), "%04u", year);
+
+	text.clear();
+	text.reserve(32 + n_ruote * 12 + (size_t) draws * (8 + n_ruote * 15 + 8));
+	text += year_cstr;
+	for( const auto& ruota : generated_ruote )
+	{
+		text.push_back(' ');
+		text += convert_ruota_to_string(ruota);
+	}
+	text.push_back(' ');
+	text += year_cstr;
+	text.push_back('\n');
+
+	uint64_t state = seed ^ ( (uint64_t) year << 32 );
+	for( uint32_t k = 0; k < draws; k++ )
+	{
+		// draws spread over the year on distinct days
+		uint32_t day = (uint32_t) ( (uint64_t) k * 365 / draws );
+		uint32_t month = 0;
+		while( day >= days_in_month[month] )
+		{
+			day -= days_in_month[month];
+			month++;
+		}
+		append_two_digits(text, day + 1);
+		text.push_back(' ');
+		text += convert_mese_to_string((mese_t) (month + 1));
+
+		for( size_t r = 0; r < n_ruote; r++ )
+		{
+			// one ruota in 64 is not drawn
+			if( 0 == ( next_random(state) & 63 ) )
+			{
+				text += " -- -- -- -- --";
+				continue;
+			}
+			uint64_t drawn[2] = { 0, 0 };
+			for( uint32_t i = 0; i < 5; i++ )
+			{
+				uint32_t number = 0;
+				do
+				{
+					number = 1 + (uint32_t) ( next_random(state) % 90 );
+				} while( drawn[number >> 6] & (1ULL << (number & 63)) );
+				drawn[number >> 6] |= 1ULL << (number & 63);
+				text.push_back(' ');
+				append_two_digits(text, number);
+			}
+		}
+		text.push_back(' ');
+		text += year_cstr;
+		text += " \n";
+	}
+	text += "END\n";
+}
+
+int32_t generate_year_files(uint32_t start_year, uint32_t end_year, uint32_t draws, uint64_t seed)
+{
+	if( 0 == draws || draws > LOTTO_SYNTHETIC_MAX_DRAWS )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error! draws per year must be 1 to " << LOTTO_SYNTHETIC_MAX_DRAWS;
+		return -1;
+	}
+
+	std::string text;
+	uint64_t total_bytes = 0;
+	for( uint32_t year = start_year; year <= end_year; year++ )
+	{
+		char year_cstr[256];
+		std::sprintf(year_cstr, "%04u.txt", year);
+		boost::filesystem::path p(boost::filesystem::current_path());
+		p /= boost::filesystem::path(year_cstr);
+		if( boost::filesystem::exists(p) )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error! file " << year_cstr << " already exists.";
+			return -1;
+		}
+
+		generate_year_text(year, draws, seed, text);
+		db_file_writer_t writer;
+		if( writer.open(p.c_str(), text.size()) || writer.write_bytes(text.data(), text.size()) || writer.commit() )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error: could not write file " << year_cstr;
+			writer.abort();
+			return -1;
+		}
+		total_bytes += text.size();
+	}
+	LOTTO_LOG(LOG_INFO) << "generated years " << start_year << "-" << end_year << ", " << draws << " draws per year, " << \
+			total_bytes << " bytes";
+
+	return 0;
+}
@@ -0,0 +1,562 @@
+/*
+ * year_parser.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <stdio.h>
+#include <cstring>
+#include <string>
+#include <cctype>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <boost/filesystem.hpp>
+#include "utilities.h"
+#include "mapped_file.h"
+#include "record_scanner.h"
+#include "year_parser.h"
+#include "parse_cache.h"
+#include "logger.h"
+
+// header "YYYY ruota ... YYYY" of a year file, a year of 0 is taken
+// from the header; the report of a bad header is left in error
+static int32_t parse_year_header(std::string_view header, uint32_t& year, std::vector<ruota_t>& ruote, std::string& error)
+{
+    std::vector<std::string_view> tokens;
+    split_tokens(header, tokens);
+    ruote.clear();
+    bool is_first = true;
+    for (const auto &t : tokens)
+    {
+    	// first the year
+    	if( is_first || ruota_t::UNKNOWN == convert_string_to_ruota(t) )
+    	{
+    		uint32_t current_year = 0;
+		    if( !parse_uint(t, current_year) )
+		    {
+		    	error = "Error: not a valid current year: " + std::string(t);
+		    	return -1;
+		    }
+		    if( is_first && 0 == year )
+		    {
+		    	year = current_year;
+		    }
+		    if( current_year != year )
+		    {
+		    	error = "Error: current year: " + std::to_string(current_year) + "\n" + \
+		    			"Error: asked   year: " + std::to_string(year);
+		    	return -1;
+		    }
+		    is_first = false;
+    	}
+    	else
+    	{
+    		ruote.push_back(convert_string_to_ruota(t));
+    	}
+    }
+
+    if( ruote.size() > LOTTO_MAX_RUOTE )
+    {
+    	error = "Error: too many ruote in header: " + std::to_string(ruote.size());
+    	return -1;
+    }
+    return 0;
+}
+
+// report a line that ends the records of a year, -1 when it is an error
+static int32_t report_scan_status(scan_status_t status, uint64_t line_counter, const record_t& rec, size_t n_ruote)
+{
+	const size_t record_size = 2 + (5*n_ruote) + 1;
+	switch (status)
+	{
+		case scan_status_t::SCAN_OK:
+			break;
+		case scan_status_t::SCAN_END:
+			LOTTO_LOG(LOG_DEBUG) << "End of file at line " << line_counter;
+			break;
+		case scan_status_t::SCAN_ILL_FORMED:
+			LOTTO_LOG(LOG_ERROR) << "Error: ill formed record at line " << line_counter;
+			LOTTO_LOG(LOG_ERROR) << "tok_size " << rec.tok_size << " requested " << record_size;
+			break;
+		case scan_status_t::SCAN_BAD_DAY:
+			LOTTO_LOG(LOG_ERROR) << "Error at line: " << line_counter << " current_day " << rec.bad_value;
+			return -1;
+		case scan_status_t::SCAN_BAD_MONTH:
+			LOTTO_LOG(LOG_ERROR) << "Error: invalid month " << rec.bad_token;
+			LOTTO_LOG(LOG_ERROR) << "Error at line: " << line_counter;
+			return -1;
+		case scan_status_t::SCAN_BAD_NUMBER:
+			LOTTO_LOG(LOG_ERROR) << "Error at line: " << line_counter << " c_number " << rec.bad_value;
+			return -1;
+	}
+	return 0;
+}
+
+// add the extractions of a record line, a ruota drawn as "--" is skipped;
+// they are put in ruota order, the one of their raw words, whatever the
+// order of the ruote in the header
+static inline void append_extractions(const record_t& rec, const std::vector<ruota_t>& ruote, uint32_t year,
+		std::vector<extraction_t>& extraction_vec)
+{
+    const size_t first = extraction_vec.size();
+    const uint64_t *num = rec.numbers;
+    for( const auto& ruota : ruote )
+    {
+    	if( num[0] != 0 )
+    	{
+    		extraction_vec.push_back(make_extraction(year, rec.month, rec.day, ruota, num[0], num[1], num[2], num[3], num[4]));
+    	}
+    	num += 5;
+    }
+    for( size_t i = first + 1; i < extraction_vec.size(); i++ )
+    {
+    	const extraction_t ex = extraction_vec[i];
+    	size_t k = i;
+    	for( ; k > first && extraction_vec[k - 1].raw > ex.raw; k-- )
+    	{
+    		extraction_vec[k] = extraction_vec[k - 1];
+    	}
+    	extraction_vec[k] = ex;
+    }
+}
+
+int32_t parse_all_files(std::vector<extraction_t>& extraction_vec, uint32_t start_year, uint32_t end_year, uint32_t jobs, bool cached)
+{
+	if( jobs > 1 )
+	{
+		return process_all_files_parallel(extraction_vec, start_year, end_year, jobs, cached);
+	}
+
+	for(uint32_t i = start_year; i <= end_year; i++)
+	{
+		LOTTO_LOG(LOG_INFO) << "... processing year: " << i;
+		int32_t ret = cached ? process_file_cached(extraction_vec, i) : process_file(extraction_vec, i);
+		if(ret)
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error from year: " << i << " abort.";
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+int32_t process_all_files_parallel(std::vector<extraction_t>& extraction_vec, uint32_t start_year, uint32_t end_year, uint32_t jobs,
+		bool cached)
+{
+	if( start_year > end_year )
+	{
+		return 0;
+	}
+
+	// every year is parsed into its own buffer, workers pick the next
+	// year in ascending order so that on error all the previous years
+	// are complete and the first failing year can be reported
+	const uint32_t n_years = end_year - start_year + 1;
+	std::vector<std::vector<extraction_t>> year_vecs(n_years);
+	std::vector<int32_t> year_rets(n_years, 0);
+	std::atomic<uint32_t> next_year(0);
+	std::atomic<bool> failed(false);
+
+	auto worker = [&]()
+	{
+		while(!failed)
+		{
+			const uint32_t k = next_year++;
+			if( k >= n_years )
+			{
+				break;
+			}
+			LOTTO_LOG(LOG_INFO) << "... processing year: " << (start_year + k);
+			year_rets[k] = cached ? process_file_cached(year_vecs[k], start_year + k) : process_file(year_vecs[k], start_year + k);
+			if(year_rets[k])
+			{
+				failed = true;
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	const uint32_t n_workers = std::min(jobs, n_years);
+	for(uint32_t j = 0; j < n_workers; j++)
+	{
+		workers.emplace_back(worker);
+	}
+	for(auto& w : workers)
+	{
+		w.join();
+	}
+
+	// merge in year order
+	size_t total_size = extraction_vec.size();
+	for(uint32_t k = 0; k < n_years; k++)
+	{
+		if(year_rets[k])
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error from year: " << (start_year + k) << " abort.";
+			return year_rets[k];
+		}
+		total_size += year_vecs[k].size();
+	}
+	extraction_vec.reserve(total_size);
+	for(uint32_t k = 0; k < n_years; k++)
+	{
+		extraction_vec.insert(extraction_vec.end(), year_vecs[k].begin(), year_vecs[k].end());
+		std::vector<extraction_t>().swap(year_vecs[k]);
+	}
+
+	return 0;
+}
+
+int32_t process_file(std::vector<extraction_t>& extraction_vec, uint32_t year)
+{
+	char year_cstr[256];
+	std::sprintf(year_cstr,"%04u.txt",year);
+	std::string filename = std::string(year_cstr);
+
+	// check valid file exists
+    boost::filesystem::path p(boost::filesystem::current_path());
+    p /= boost::filesystem::path(filename);
+    if(boost::filesystem::exists(p) && boost::filesystem::is_regular_file(p))
+    {
+		LOTTO_LOG(LOG_DEBUG) << "... found file: " << filename;
+    }
+    else
+    {
+		LOTTO_LOG(LOG_ERROR) << "Error: not found file: " << filename;
+    	return -1;
+    }
+
+    // map the file, lines and tokens are views into the mapping
+    mapped_file_t infile;
+    if( infile.open(p.c_str()) )
+    {
+		LOTTO_LOG(LOG_ERROR) << "Error: could not open file: " << filename;
+    	return -1;
+    }
+    const char *cursor = infile.data();
+    const char *file_end = infile.data() + infile.size();
+
+    // read header
+    std::string_view header = next_line(cursor, file_end);
+    std::vector<ruota_t> current_ruote;
+    std::string error;
+    if( parse_year_header(header, year, current_ruote, error) )
+    {
+    	LOTTO_LOG(LOG_ERROR) << error;
+    	return -1;
+    }
+
+    // parse all the records, one forward pass per line
+    record_t rec;
+    uint32_t line_counter = 0;
+	while( cursor < file_end )
+	{
+		line_counter++;
+		std::string_view line = next_line(cursor, file_end);
+		scan_status_t status = scan_record(line, current_ruote.size(), rec);
+		if( scan_status_t::SCAN_OK != status )
+		{
+			if( report_scan_status(status, line_counter, rec, current_ruote.size()) )
+			{
+				return -1;
+			}
+			break;
+		}
+		append_extractions(rec, current_ruote, year, extraction_vec);
+	}
+
+    return 0;
+}
+
+// records of one section within a chunk of a history file
+typedef struct HISTORY_SEGMENT
+{
+	uint32_t                  year;
+	bool                      header;      // starts with the header of its section
+	bool                      bad_header;  // reported in error
+	std::string               error;
+	scan_status_t             status;      // the line closing the section, SCAN_OK if none
+	record_t                  rec;
+	size_t                    n_ruote;
+	uint64_t                  line;        // of the header or the closing line, in the chunk
+	std::vector<extraction_t> records;
+} history_segment_t;
+
+typedef struct HISTORY_CHUNK
+{
+	const char                    *begin;
+	const char                    *end;
+	uint64_t                       n_lines;
+	std::vector<history_segment_t> segments;
+} history_chunk_t;
+
+// a header starts with the four digits of the year, a record line with
+// the two of the day
+static inline bool is_header_line(std::string_view line)
+{
+	return line.size() > 5 && ' ' == line[4] && \
+		std::isdigit((unsigned char) line[0]) && std::isdigit((unsigned char) line[1]) && \
+		std::isdigit((unsigned char) line[2]) && std::isdigit((unsigned char) line[3]);
+}
+
+static void parse_history_chunk(const char *file_begin, history_chunk_t& chunk)
+{
+	std::vector<ruota_t> ruote;
+	const char *cursor = chunk.begin;
+	chunk.n_lines = 0;
+
+	// a chunk starting inside a section takes its ruote from the header
+	// before it, a bad one is reported by the chunk holding it
+	const char *peek = cursor;
+	if( !is_header_line(next_line(peek, chunk.end)) )
+	{
+		chunk.segments.emplace_back();
+		history_segment_t& segment = chunk.segments.back();
+		segment.year = 0;
+		segment.header = false;
+		segment.bad_header = true;
+		segment.status = scan_status_t::SCAN_OK;
+		segment.line = 0;
+		const char *line_end = cursor;
+		while( line_end > file_begin )
+		{
+			const char *line_begin = line_end - 1;
+			while( line_begin > file_begin && '\n' != line_begin[-1] )
+			{
+				line_begin--;
+			}
+			std::string_view line(line_begin, line_end - 1 - line_begin);
+			if( is_header_line(line) )
+			{
+				segment.bad_header = ( 0 != parse_year_header(line, segment.year, ruote, segment.error) );
+				break;
+			}
+			line_end = line_begin;
+		}
+		segment.n_ruote = ruote.size();
+	}
+
+	while( cursor < chunk.end )
+	{
+		chunk.n_lines++;
+		std::string_view line = next_line(cursor, chunk.end);
+		if( is_header_line(line) )
+		{
+			chunk.segments.emplace_back();
+			history_segment_t& segment = chunk.segments.back();
+			segment.year = 0;
+			segment.header = true;
+			segment.bad_header = ( 0 != parse_year_header(line, segment.year, ruote, segment.error) );
+			segment.status = scan_status_t::SCAN_OK;
+			segment.n_ruote = ruote.size();
+			segment.line = chunk.n_lines;
+			continue;
+		}
+
+		history_segment_t& segment = chunk.segments.back();
+		if( segment.bad_header || scan_status_t::SCAN_OK != segment.status )
+		{
+			// the rest of the section is not read, as for a year file
+			continue;
+		}
+		scan_status_t status = scan_record(line, ruote.size(), segment.rec);
+		if( scan_status_t::SCAN_OK != status )
+		{
+			segment.status = status;
+			segment.line = chunk.n_lines;
+			continue;
+		}
+		append_extractions(segment.rec, ruote, segment.year, segment.records);
+	}
+}
+
+int32_t parse_history_file(std::vector<extraction_t>& extraction_vec, const boost::filesystem::path& file_history,
+		uint32_t start_year, uint32_t end_year, uint32_t jobs)
+{
+    mapped_file_t infile;
+    if( infile.open(file_history.c_str()) )
+    {
+		LOTTO_LOG(LOG_ERROR) << "Error: could not open file: " << file_history.c_str();
+    	return -1;
+    }
+    const char *file_begin = infile.data();
+    const char *file_end = infile.data() + infile.size();
+    if( infile.size() == 0 || !is_header_line(next_line(file_begin, file_end)) )
+    {
+		LOTTO_LOG(LOG_ERROR) << "Error: file " << file_history.c_str() << " does not start with a year header";
+    	return -1;
+    }
+    file_begin = infile.data();
+
+    // chunks of about the same size, cut after a new line
+    std::vector<history_chunk_t> chunks;
+    for( const char *begin = file_begin; begin < file_end; )
+    {
+    	const char *end = file_end;
+    	if( (size_t) (file_end - begin) > LOTTO_HISTORY_CHUNK_BYTES )
+    	{
+    		const char *eol = (const char *) std::memchr(begin + LOTTO_HISTORY_CHUNK_BYTES, '\n',
+    				file_end - begin - LOTTO_HISTORY_CHUNK_BYTES);
+    		end = ( NULL == eol ) ? file_end : eol + 1;
+    	}
+    	chunks.push_back({ begin, end, 0, {} });
+    	begin = end;
+    }
+	LOTTO_LOG(LOG_INFO) << "... parsing history file: " << file_history.c_str() << ", " << infile.size() << " bytes in " << \
+			chunks.size() << " chunks";
+
+	std::atomic<size_t> next_chunk(0);
+	auto worker = [&]()
+	{
+		for( size_t k = next_chunk++; k < chunks.size(); k = next_chunk++ )
+		{
+			parse_history_chunk(file_begin, chunks[k]);
+		}
+	};
+	std::vector<std::thread> workers;
+	const uint32_t n_workers = std::max<uint32_t>(1, std::min<size_t>(jobs, chunks.size()));
+	for(uint32_t j = 1; j < n_workers; j++)
+	{
+		workers.emplace_back(worker);
+	}
+	worker();
+	for(auto& w : workers)
+	{
+		w.join();
+	}
+
+	// merge in file order, a section closed in one chunk drops what the
+	// next chunks parsed of it; years must follow one another
+	size_t total_size = extraction_vec.size();
+	for( const auto& chunk : chunks )
+	{
+		for( const auto& segment : chunk.segments )
+		{
+			total_size += segment.records.size();
+		}
+	}
+	extraction_vec.reserve(total_size);
+
+	// every year asked must be in the file, as a year file must exist
+	uint64_t line_base = 0;
+	uint32_t last_year = 0;
+	uint32_t next_year = start_year;
+	bool closed = false;
+	for( const auto& chunk : chunks )
+	{
+		for( const auto& segment : chunk.segments )
+		{
+			if( segment.header )
+			{
+				if( segment.bad_header )
+				{
+					LOTTO_LOG(LOG_ERROR) << segment.error;
+					LOTTO_LOG(LOG_ERROR) << "Error: bad year header at line " << (line_base + segment.line);
+					return -1;
+				}
+				if( segment.year <= last_year )
+				{
+					LOTTO_LOG(LOG_ERROR) << "Error: year " << segment.year << " after year " << last_year << \
+							" at line " << (line_base + segment.line);
+					return -1;
+				}
+				if( segment.year > next_year && next_year <= end_year )
+				{
+					LOTTO_LOG(LOG_ERROR) << "Error: not found year: " << next_year << " in file: " << file_history.c_str();
+					return -1;
+				}
+				LOTTO_LOG(LOG_DEBUG) << "... found year: " << segment.year;
+				last_year = segment.year;
+				next_year = std::max(next_year, segment.year + 1);
+				closed = false;
+			}
+			if(closed)
+			{
+				continue;
+			}
+			if( segment.year >= start_year && segment.year <= end_year )
+			{
+				extraction_vec.insert(extraction_vec.end(), segment.records.begin(), segment.records.end());
+			}
+			if( scan_status_t::SCAN_OK != segment.status )
+			{
+				if( report_scan_status(segment.status, line_base + segment.line, segment.rec, segment.n_ruote) )
+				{
+					LOTTO_LOG(LOG_ERROR) << "Error from year: " << segment.year << " abort.";
+					return -1;
+				}
+				closed = true;
+			}
+		}
+		line_base += chunk.n_lines;
+	}
+	if( next_year <= end_year )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: not found year: " << next_year << " in file: " << file_history.c_str();
+		return -1;
+	}
+
+	return 0;
+}
+
+std::string_view next_line(const char*& cursor, const char *end)
+{
+	const char *begin = cursor;
+	const char *eol = (const char *) std::memchr(begin, '\n', end - begin);
+	if( NULL == eol )
+	{
+		cursor = end;
+		return std::string_view(begin, end - begin);
+	}
+	cursor = eol + 1;
+	return std::string_view(begin, eol - begin);
+}
+
+void split_tokens(std::string_view line, std::vector<std::string_view>& tokens)
+{
+	tokens.clear();
+
+	size_t pos = 0;
+	while( pos < line.size() )
+	{
+		if( ' ' == line[pos] )
+		{
+			pos++;
+			continue;
+		}
+		size_t token_end = line.find(' ', pos);
+		if( std::string_view::npos == token_end )
+		{
+			token_end = line.size();
+		}
+		tokens.push_back(line.substr(pos, token_end - pos));
+		pos = token_end;
+	}
+}
+
+bool parse_uint(std::string_view str, uint32_t& value)
+{
+	// same leading characters accepted by strtoul: white spaces and
+	// an optional plus sign, followed by at least one digit
+	size_t i = 0;
+	while( i < str.size() && std::isspace((unsigned char) str[i]) )
+	{
+		i++;
+	}
+	if( i < str.size() && '+' == str[i] )
+	{
+		i++;
+	}
+
+	value = 0;
+	size_t first_digit = i;
+	while( i < str.size() && str[i] >= '0' && str[i] <= '9' )
+	{
+		value = value * 10 + (uint32_t) (str[i] - '0');
+		i++;
+	}
+	return i > first_digit;
+}
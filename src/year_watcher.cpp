@@ -0,0 +1,229 @@
+/*
+ * year_watcher.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <vector>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include "basic_types.h"
+#include "utilities.h"
+#include "db_io.h"
+#include "db_file.h"
+#include "year_parser.h"
+#include "ritardo_index.h"
+#include "bitset_index.h"
+#include "logger.h"
+#include "year_watcher.h"
+
+static std::atomic<bool> watch_stop(false);
+
+static void on_stop_signal(int)
+{
+	watch_stop = true;
+}
+
+int32_t splice_year_file(const boost::filesystem::path& file_db, uint32_t year)
+{
+	std::vector<extraction_t> year_vec;
+	if( process_file(year_vec, year) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: year " << year << " not parsed, db left as it is";
+		return -1;
+	}
+
+	// the records of the year and the ones after it, which are moved
+	std::vector<extraction_t> spliced;
+	uint64_t first_record = 0;
+	{
+		db_reader_t reader;
+		if( reader.open(file_db.c_str()) )
+		{
+			return -1;
+		}
+		if( LOTTO_DB_VERSION != reader.layout().version )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error! file " << file_db.c_str() << " is a version " << reader.layout().version << \
+					" db, an --append rewrites it in the current format";
+			return -1;
+		}
+		// the records of the year are found as one run of the db
+		if( !reader.date_ordered() )
+		{
+			LOTTO_LOG(LOG_ERROR) << "Error! file " << file_db.c_str() << " has no month index, its records are not " << \
+					"in date order: year " << year << " not spliced, a full import writes the db again";
+			return -1;
+		}
+		const db_range_t old_year = reader.range(make_date(year, 1, 1), make_date(year, 12, 31));
+		first_record = old_year.first_record();
+		if( old_year.size() == year_vec.size() && \
+			std::equal(year_vec.begin(), year_vec.end(), old_year.begin(),
+					[](const extraction_t& a, const extraction_t& b){ return a.raw == b.raw; }) )
+		{
+			LOTTO_LOG(LOG_INFO) << "year " << year << " unchanged, " << year_vec.size() << " records";
+			return 0;
+		}
+		const uint64_t tail = reader.size() - first_record - old_year.size();
+		spliced.resize(year_vec.size() + tail);
+		std::copy(year_vec.begin(), year_vec.end(), spliced.begin());
+		reader.records().decode(first_record + old_year.size(), tail, spliced.data() + year_vec.size());
+		LOTTO_LOG(LOG_INFO) << "splicing year " << year << ": " << old_year.size() << " -> " << year_vec.size() << \
+				" records at record " << first_record << ", " << tail << " records moved";
+	}
+
+	db_file_writer_t writer;
+	if( writer.open_db_append(file_db.c_str(), first_record) || \
+		writer.write_records(spliced.data(), spliced.size()) || \
+		writer.write_trailer() || \
+		writer.commit() )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from save_file_db." << " abort.";
+		return -1;
+	}
+	if( verify_file_db(spliced, file_db, first_record) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from verify_file_db." << " abort.";
+		return -1;
+	}
+
+	// a year in the middle changes the draws counted after it, the
+	// indexes are rebuilt
+	ritardo_index_t index;
+	if( build_ritardo_index(file_db, index) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from build_ritardo_index." << " abort.";
+		return -1;
+	}
+	if( build_bitset_index(file_db) )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error from build_bitset_index." << " abort.";
+		return -1;
+	}
+
+	return 0;
+}
+
+// year of a file name NNNN.txt, 0 for any other name
+static uint32_t year_of_file(const char *name)
+{
+	if( std::strlen(name) != 8 || 0 != std::strcmp(name + 4, ".txt") )
+	{
+		return 0;
+	}
+	uint32_t year = 0;
+	if( !parse_uint(std::string_view(name, 4), year) )
+	{
+		return 0;
+	}
+	return year;
+}
+
+// add the years of the pending events to changed, false on error
+static bool read_events(int fd, uint32_t start_year, uint32_t end_year, std::set<uint32_t>& changed)
+{
+	alignas(struct inotify_event) char buffer[4096];
+	while( true )
+	{
+		ssize_t ret = ::read(fd, buffer, sizeof(buffer));
+		if( ret < 0 )
+		{
+			if( EINTR == errno )
+				continue;
+			return EAGAIN == errno || EWOULDBLOCK == errno;
+		}
+		for( char *p = buffer; p < buffer + ret; )
+		{
+			const struct inotify_event *event = (const struct inotify_event *) p;
+			if( event->mask & IN_Q_OVERFLOW )
+			{
+				// events were lost, every year is checked
+				for( uint32_t year = start_year; year <= end_year; year++ )
+				{
+					changed.insert(year);
+				}
+			}
+			else if( event->len > 0 )
+			{
+				const uint32_t year = year_of_file(event->name);
+				if( year >= start_year && year <= end_year )
+				{
+					changed.insert(year);
+				}
+			}
+			p += sizeof(struct inotify_event) + event->len;
+		}
+	}
+}
+
+int32_t watch_year_files(const boost::filesystem::path& file_db, uint32_t start_year, uint32_t end_year)
+{
+	int fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	// a file is read once written and closed, or moved in whole; an
+	// editor saving through a temporary file shows up as a move
+	if( fd < 0 || ::inotify_add_watch(fd, ".", IN_CLOSE_WRITE | IN_MOVED_TO) < 0 )
+	{
+		LOTTO_LOG(LOG_ERROR) << "Error: could not watch the current directory: " << std::strerror(errno);
+		if( fd >= 0 )
+			::close(fd);
+		return -1;
+	}
+
+	watch_stop = false;
+	std::signal(SIGINT, on_stop_signal);
+	std::signal(SIGTERM, on_stop_signal);
+	LOTTO_LOG(LOG_INFO) << "watching year files " << start_year << "-" << end_year << " for " << file_db.c_str();
+
+	int32_t ret = 0;
+	std::set<uint32_t> changed;
+	while( !watch_stop )
+	{
+		// wait for the first change, then until the writes settle
+		struct pollfd pfd = { fd, POLLIN, 0 };
+		const int ready = ::poll(&pfd, 1, changed.empty() ? -1 : LOTTO_WATCH_SETTLE_MS);
+		if( ready < 0 )
+		{
+			if( EINTR == errno )
+				continue;
+			LOTTO_LOG(LOG_ERROR) << "Error: poll failed: " << std::strerror(errno);
+			ret = -1;
+			break;
+		}
+		if( ready > 0 )
+		{
+			if( !read_events(fd, start_year, end_year, changed) )
+			{
+				LOTTO_LOG(LOG_ERROR) << "Error: could not read the changes: " << std::strerror(errno);
+				ret = -1;
+				break;
+			}
+			continue;
+		}
+
+		// in year order, a failed year is reported and the db kept
+		auto t_start = std::chrono::steady_clock::now();
+		for( uint32_t year : changed )
+		{
+			splice_year_file(file_db, year);
+		}
+		auto t_end = std::chrono::steady_clock::now();
+		LOTTO_LOG(LOG_INFO) << "changed years: " << changed.size() << ", splice time: " << \
+				std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start).count() << " us";
+		changed.clear();
+	}
+
+	::close(fd);
+	std::signal(SIGINT, SIG_DFL);
+	std::signal(SIGTERM, SIG_DFL);
+	LOTTO_LOG(LOG_INFO) << "stopped watching";
+
+	return ret;
+}
@@ -0,0 +1,130 @@
+/*
+ * bitset_index_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <algorithm>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "utilities.h"
+#include "db_io.h"
+#include "db_file.h"
+#include "bitset_index.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(bitset_index)
+
+// one record at a time, ruota UNKNOWN for every ruota
+static void naive_combo(const std::vector<extraction_t>& records, const std::vector<uint32_t>& numbers, ruota_t ruota,
+		uint32_t from_date, uint32_t to_date, combo_result_t& result)
+{
+	std::fill(result.counts, result.counts + ruota_t::UNKNOWN, 0);
+	std::fill(result.last_date, result.last_date + ruota_t::UNKNOWN, 0);
+	for( const auto& ex : records )
+	{
+		if( ex.date() < from_date || ex.date() > to_date || ( ruota < ruota_t::TUTTE && ex.ruota() != ruota ) )
+			continue;
+		const uint32_t drawn[5] = { ex.a(), ex.b(), ex.c(), ex.d(), ex.e() };
+		const bool all = std::all_of(numbers.begin(), numbers.end(),
+				[&drawn](uint32_t n){ return drawn + 5 != std::find(drawn, drawn + 5, n); });
+		if( !all )
+			continue;
+		for( uint32_t r : { ex.ruota(), (uint32_t) ruota_t::TUTTE } )
+		{
+			result.counts[r]++;
+			result.last_date[r] = std::max(result.last_date[r], ex.date());
+		}
+	}
+}
+
+static void check_same_result(const combo_result_t& expected, const combo_result_t& found)
+{
+	for( uint32_t r = 0; r < ruota_t::UNKNOWN; r++ )
+	{
+		BOOST_REQUIRE_EQUAL(expected.counts[r], found.counts[r]);
+		BOOST_REQUIRE_EQUAL(expected.last_date[r], found.last_date[r]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(draw_bits_layout)
+{
+	const extraction_t ex = make_extraction(2020, 12, 27, ruota_t::ROMA, 1, 64, 65, 90, 33);
+	const draw_bits_t bits = make_draw_bits(ex);
+	BOOST_CHECK_EQUAL(( 1ULL << 0 ) | ( 1ULL << 63 ) | ( 1ULL << 32 ), bits.lo);
+	BOOST_CHECK_EQUAL(( 1ULL << 0 ) | ( 1ULL << 25 ), bits.hi & LOTTO_BITSET_NUMBERS_HI);
+	BOOST_CHECK_EQUAL((uint64_t) ruota_t::ROMA, ( bits.hi >> LOTTO_BITSET_SHIFT_RUOTA ) & 0xF);
+	BOOST_CHECK_EQUAL((uint64_t) make_date(2020, 12, 27), bits.hi >> LOTTO_BITSET_SHIFT_DATE);
+}
+
+BOOST_AUTO_TEST_CASE(counts_match_a_naive_scan_at_every_length)
+{
+	// the vector path takes blocks of entries, the scalar one the rest
+	const std::vector<extraction_t> records = make_records(1990, 10);
+	std::vector<uint8_t> entries(records.size() * LOTTO_BITSET_ENTRY_BYTES);
+	for( size_t i = 0; i < records.size(); i++ )
+	{
+		const draw_bits_t bits = make_draw_bits(records[i]);
+		store_be(entries.data() + i * LOTTO_BITSET_ENTRY_BYTES, bits.lo, 8);
+		store_be(entries.data() + i * LOTTO_BITSET_ENTRY_BYTES + 8, bits.hi, 8);
+	}
+
+	const std::vector<uint32_t> numbers = { records[3].b(), records[3].d() };
+	for( size_t n = 0; n <= records.size(); n++ )
+	{
+		const std::vector<extraction_t> head(records.begin(), records.begin() + n);
+		combo_result_t expected, found;
+		naive_combo(head, numbers, ruota_t::UNKNOWN, 0, make_date(2100, 1, 1), expected);
+		count_combo(entries.data(), n, numbers.data(), numbers.size(), ruota_t::UNKNOWN, 0, make_date(2100, 1, 1), found);
+		check_same_result(expected, found);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(combos_match_a_naive_scan)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 500);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+
+	const std::vector<std::vector<uint32_t>> combos =
+	{
+		{ 7 },
+		{ 1, 90 },
+		{ 12, 64, 65 },
+		{ records[100].a(), records[100].b(), records[100].c() },
+		{ records[200].a(), records[200].b(), records[200].c(), records[200].d(), records[200].e() },
+	};
+	const uint32_t from_date = make_date(1992, 4, 1), to_date = make_date(1997, 9, 30);
+	for( const auto& numbers : combos )
+	{
+		for( ruota_t ruota : { ruota_t::UNKNOWN, ruota_t::TUTTE, ruota_t::NAZIONALE, ruota_t::VENEZIA } )
+		{
+			combo_result_t expected, found;
+			naive_combo(records, numbers, ruota, from_date, to_date, expected);
+			BOOST_REQUIRE_EQUAL(0, query_combo("out.db", numbers.data(), numbers.size(), ruota, from_date, to_date, found));
+			check_same_result(expected, found);
+		}
+	}
+	BOOST_CHECK(boost::filesystem::exists(bitset_index_path("out.db")));
+}
+
+BOOST_AUTO_TEST_CASE(index_is_rebuilt_for_a_changed_db)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 200);
+	const std::vector<extraction_t> head(records.begin(), records.begin() + 1000);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(head, "out.db"));
+	BOOST_REQUIRE_EQUAL(0, build_bitset_index("out.db"));
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+
+	const uint32_t numbers[] = { records.back().a(), records.back().e() };
+	combo_result_t expected, found;
+	naive_combo(records, std::vector<uint32_t>(numbers, numbers + 2), ruota_t::UNKNOWN, 0, make_date(2100, 1, 1), expected);
+	BOOST_REQUIRE_EQUAL(0, query_combo("out.db", numbers, 2, ruota_t::UNKNOWN, 0, make_date(2100, 1, 1), found));
+	check_same_result(expected, found);
+	BOOST_CHECK_EQUAL(records.back().date(), found.last_date[ruota_t::TUTTE]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,132 @@
+/*
+ * bounded_queue_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "bounded_queue.h"
+#include "db_io.h"
+#include "db_file.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(bounded_queue)
+
+BOOST_AUTO_TEST_CASE(items_come_out_in_order)
+{
+	bounded_queue_t<int> queue(4);
+	for( int i = 0; i < 4; i++ )
+	{
+		BOOST_REQUIRE(queue.push(i));
+	}
+	for( int i = 0; i < 4; i++ )
+	{
+		int item = -1;
+		BOOST_REQUIRE(queue.pop(item));
+		BOOST_CHECK_EQUAL(i, item);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(close_drains_then_stops)
+{
+	bounded_queue_t<int> queue(4);
+	BOOST_REQUIRE(queue.push(1));
+	BOOST_REQUIRE(queue.push(2));
+	queue.close();
+	BOOST_CHECK(!queue.push(3));
+
+	int item = 0;
+	BOOST_CHECK(queue.pop(item));
+	BOOST_CHECK_EQUAL(1, item);
+	BOOST_CHECK(queue.pop(item));
+	BOOST_CHECK_EQUAL(2, item);
+	BOOST_CHECK(!queue.pop(item));
+}
+
+BOOST_AUTO_TEST_CASE(a_full_queue_holds_the_producer)
+{
+	bounded_queue_t<int> queue(2);
+	std::atomic<int> pushed(0);
+	std::thread producer([&]()
+	{
+		for( int i = 0; i < 5; i++ )
+		{
+			if( !queue.push(i) )
+				break;
+			pushed++;
+		}
+	});
+
+	while( pushed < 2 )
+	{
+		std::this_thread::yield();
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	BOOST_CHECK_EQUAL(2, pushed.load());
+
+	int item = -1;
+	for( int i = 0; i < 5; i++ )
+	{
+		BOOST_REQUIRE(queue.pop(item));
+		BOOST_CHECK_EQUAL(i, item);
+	}
+	producer.join();
+	BOOST_CHECK_EQUAL(5, pushed.load());
+}
+
+BOOST_AUTO_TEST_CASE(close_releases_a_blocked_producer)
+{
+	bounded_queue_t<int> queue(1);
+	BOOST_REQUIRE(queue.push(0));
+	std::atomic<bool> result(true);
+	std::thread producer([&]() { result = queue.push(1); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	queue.close();
+	producer.join();
+	BOOST_CHECK(!result);
+}
+
+// the streaming import: records encoded in chunks by one stage and
+// written by another make the db that saving them at once makes
+BOOST_AUTO_TEST_CASE(streamed_chunks_write_the_same_db)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1950, 3000);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "whole.db"));
+
+	const size_t chunk_records = 1000;
+	bounded_queue_t<std::vector<uint8_t>> queue(2);
+	std::thread encoder([&]()
+	{
+		for( size_t i = 0; i < records.size(); i += chunk_records )
+		{
+			const size_t n = std::min(chunk_records, records.size() - i);
+			std::vector<uint8_t> chunk(n * LOTTO_RECORD_BYTES);
+			encode_records(records.data() + i, n, chunk.data());
+			if( !queue.push(std::move(chunk)) )
+				break;
+		}
+		queue.close();
+	});
+
+	db_file_writer_t writer;
+	BOOST_REQUIRE_EQUAL(0, writer.open_db("streamed.db", 0));
+	std::vector<uint8_t> chunk;
+	while( queue.pop(chunk) )
+	{
+		BOOST_REQUIRE_EQUAL(0, writer.write_encoded_records(chunk.data(), chunk.size() / LOTTO_RECORD_BYTES));
+	}
+	encoder.join();
+	BOOST_REQUIRE_EQUAL(0, writer.write_trailer());
+	BOOST_REQUIRE_EQUAL(0, writer.commit());
+
+	BOOST_CHECK(read_whole_file("whole.db") == read_whole_file("streamed.db"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
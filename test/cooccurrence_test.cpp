@@ -0,0 +1,113 @@
+/*
+ * cooccurrence_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "utilities.h"
+#include "db_file.h"
+#include "cooccurrence.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(cooccurrence)
+
+static void naive_cooccurrence(const std::vector<extraction_t>& records, const date_window_t& window,
+		cooccurrence_matrix_t& matrix)
+{
+	std::memset(&matrix, 0, sizeof(matrix));
+	for( const auto& ex : records )
+	{
+		if( ex.date() < window.from_date || ex.date() > window.to_date )
+			continue;
+		const uint32_t drawn[5] = { ex.a(), ex.b(), ex.c(), ex.d(), ex.e() };
+		for( uint32_t a : drawn )
+		{
+			for( uint32_t b : drawn )
+			{
+				matrix.counts[ex.ruota()][a][b]++;
+				matrix.counts[ruota_t::TUTTE][a][b]++;
+			}
+		}
+	}
+}
+
+static void check_same_matrix(const cooccurrence_matrix_t& expected, const cooccurrence_matrix_t& found)
+{
+	BOOST_REQUIRE(0 == std::memcmp(&expected, &found, sizeof(expected)));
+}
+
+static const std::vector<date_window_t> test_windows =
+{
+	{ make_date(1990, 1, 1), make_date(2100, 1, 1) },
+	{ make_date(1991, 2, 8), make_date(1993, 11, 22) },
+	{ make_date(1994, 6, 15), make_date(1994, 6, 15) },
+	{ make_date(2001, 1, 1), make_date(2002, 1, 1) },
+};
+
+BOOST_AUTO_TEST_CASE(matrices_match_a_naive_count_with_any_jobs)
+{
+	const std::vector<extraction_t> records = make_records(1990, 300);
+	std::vector<cooccurrence_matrix_t> expected(test_windows.size());
+	for( size_t w = 0; w < test_windows.size(); w++ )
+	{
+		naive_cooccurrence(records, test_windows[w], expected[w]);
+	}
+
+	for( uint32_t jobs : { 1u, 3u, 8u } )
+	{
+		std::vector<cooccurrence_matrix_t> matrices;
+		BOOST_REQUIRE_EQUAL(0, compute_cooccurrence(records, test_windows, jobs, matrices));
+		BOOST_REQUIRE_EQUAL(test_windows.size(), matrices.size());
+		for( size_t w = 0; w < test_windows.size(); w++ )
+		{
+			check_same_matrix(expected[w], matrices[w]);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(matrices_of_a_db)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 200);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+
+	std::vector<cooccurrence_matrix_t> from_db, from_memory;
+	BOOST_REQUIRE_EQUAL(0, query_cooccurrence("out.db", test_windows, 2, from_db));
+	BOOST_REQUIRE_EQUAL(0, compute_cooccurrence(records, test_windows, 1, from_memory));
+	BOOST_REQUIRE_EQUAL(from_memory.size(), from_db.size());
+	for( size_t w = 0; w < from_db.size(); w++ )
+	{
+		check_same_matrix(from_memory[w], from_db[w]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(csv_lists_the_pairs_drawn_together)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = { make_extraction(2000, 1, 8, ruota_t::BARI, 5, 1, 90, 33, 12) };
+	const std::vector<date_window_t> windows = { { make_date(2000, 1, 1), make_date(2000, 12, 31) } };
+	std::vector<cooccurrence_matrix_t> matrices;
+	BOOST_REQUIRE_EQUAL(0, compute_cooccurrence(records, windows, 1, matrices));
+	BOOST_REQUIRE_EQUAL(0, save_cooccurrence_csv(matrices, "out.csv"));
+
+	std::ifstream in("out.csv");
+	std::vector<std::string> lines;
+	for( std::string line; std::getline(in, line); )
+	{
+		lines.push_back(line);
+	}
+	// ten pairs on BARI and on TUTTE, a < b
+	BOOST_REQUIRE_EQUAL(21u, lines.size());
+	BOOST_CHECK_EQUAL("window,ruota,a,b,count", lines[0]);
+	BOOST_CHECK_EQUAL("0,BARI,1,5,1", lines[1]);
+	BOOST_CHECK_EQUAL("0,BARI,33,90,1", lines[10]);
+	BOOST_CHECK_EQUAL("0,TUTTE,1,5,1", lines[11]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,125 @@
+/*
+ * crc32c_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "crc32c.h"
+#include "db_io.h"
+#include "db_file.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(crc32c)
+
+// one bit at a time, reflected, polynomial 0x82F63B78
+static uint32_t crc32c_bitwise(uint32_t crc, const uint8_t *data, size_t n)
+{
+	crc = ~crc;
+	for( size_t i = 0; i < n; i++ )
+	{
+		crc ^= data[i];
+		for( int k = 0; k < 8; k++ )
+		{
+			crc = (crc >> 1) ^ ( (crc & 1) ? 0x82F63B78u : 0 );
+		}
+	}
+	return ~crc;
+}
+
+BOOST_AUTO_TEST_CASE(check_value)
+{
+	const char *check = "123456789";
+	BOOST_CHECK_EQUAL(0xE3069283u, crc32c_update(0, (const uint8_t *) check, 9));
+	BOOST_CHECK_EQUAL(0u, crc32c_update(0, NULL, 0));
+}
+
+BOOST_AUTO_TEST_CASE(every_length_and_alignment)
+{
+	std::vector<uint8_t> data(300);
+	for( size_t i = 0; i < data.size(); i++ )
+	{
+		data[i] = (uint8_t) (i * 37 + 11);
+	}
+	for( size_t offset = 0; offset < 8; offset++ )
+	{
+		for( size_t n = 0; offset + n <= data.size(); n += 7 )
+		{
+			BOOST_REQUIRE_EQUAL(crc32c_bitwise(0, data.data() + offset, n), crc32c_update(0, data.data() + offset, n));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(extends_the_previous_bytes)
+{
+	std::vector<uint8_t> data(1000);
+	for( size_t i = 0; i < data.size(); i++ )
+	{
+		data[i] = (uint8_t) (i ^ (i >> 3));
+	}
+	const uint32_t whole = crc32c_update(0, data.data(), data.size());
+	for( size_t cut : { 1, 8, 13, 512, 999 } )
+	{
+		BOOST_CHECK_EQUAL(whole, crc32c_update(crc32c_update(0, data.data(), cut), data.data() + cut, data.size() - cut));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(trailer_round_trip)
+{
+	db_trailer_t trailer;
+	trailer.n_records = 123456789012ull;
+	trailer.crc = 0xDEADBEEF;
+	uint8_t bytes[LOTTO_TRAILER_BYTES];
+	encode_trailer(trailer, bytes);
+
+	db_trailer_t decoded;
+	BOOST_REQUIRE(decode_trailer(bytes, decoded));
+	BOOST_CHECK_EQUAL(trailer.n_records, decoded.n_records);
+	BOOST_CHECK_EQUAL(trailer.crc, decoded.crc);
+
+	bytes[LOTTO_TRAILER_BYTES - 1] ^= 1;
+	BOOST_CHECK(!decode_trailer(bytes, decoded));
+}
+
+BOOST_AUTO_TEST_CASE(db_checksum_covers_the_records)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 100);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+
+	std::vector<uint8_t> bytes(records.size() * LOTTO_RECORD_BYTES);
+	encode_records(records.data(), records.size(), bytes.data());
+	uint64_t n_records = 0;
+	uint32_t crc = 0;
+	BOOST_REQUIRE_EQUAL(0, verify_file_db_checksum("out.db", n_records, crc));
+	BOOST_CHECK_EQUAL(records.size(), n_records);
+	BOOST_CHECK_EQUAL(crc32c_update(0, bytes.data(), bytes.size()), crc);
+}
+
+BOOST_AUTO_TEST_CASE(a_flipped_bit_is_found)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 100);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+
+	// the low bit of the last number of a record in the middle, the
+	// header and month index are still valid
+	std::string file = read_whole_file("out.db");
+	file[LOTTO_HEADER_BYTES + 500 * LOTTO_RECORD_BYTES + 7] ^= 1;
+	{
+		std::ofstream out("out.db", std::ios::binary | std::ios::trunc);
+		out << file;
+	}
+
+	uint64_t n_records = 0;
+	uint32_t crc = 0;
+	BOOST_CHECK_EQUAL(-1, verify_file_db_checksum("out.db", n_records, crc));
+	BOOST_CHECK_EQUAL(-1, verify_file_db(records, "out.db", 0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+/*
+ * db_columnar_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "db_io.h"
+#include "db_columnar.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(db_columnar)
+
+static uint32_t column_value(const std::string& file, const column_entry_t& column, uint64_t i)
+{
+	const uint8_t *element = (const uint8_t *) file.data() + column.offset + i * column.element_bytes;
+	return (uint32_t) load_be(element, column.element_bytes);
+}
+
+BOOST_AUTO_TEST_CASE(columns_hold_the_fields)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 150);
+	BOOST_REQUIRE_EQUAL(0, save_file_columnar(records, "out.col"));
+	BOOST_CHECK_EQUAL(0, verify_file_columnar(records, "out.col"));
+
+	const std::string file = read_whole_file("out.col");
+	columnar_directory_t directory;
+	BOOST_REQUIRE_EQUAL(0, parse_columnar_directory((const uint8_t *) file.data(), file.size(), directory));
+	BOOST_CHECK_EQUAL(LOTTO_COLUMNAR_VERSION, directory.version);
+	BOOST_REQUIRE_EQUAL(records.size(), directory.n_records);
+	BOOST_CHECK_EQUAL(2u, directory.columns[COL_YEAR].element_bytes);
+	for( uint32_t c = 0; c < COL_COUNT; c++ )
+	{
+		BOOST_CHECK_EQUAL(c, directory.columns[c].id);
+		BOOST_CHECK_EQUAL(0u, directory.columns[c].offset % LOTTO_COLUMNAR_ALIGN);
+		BOOST_CHECK_EQUAL(records.size() * directory.columns[c].element_bytes, directory.columns[c].bytes);
+	}
+
+	for( uint64_t i = 0; i < records.size(); i++ )
+	{
+		const extraction_t& ex = records[i];
+		BOOST_REQUIRE_EQUAL(ex.year(), column_value(file, directory.columns[COL_YEAR], i));
+		BOOST_REQUIRE_EQUAL(ex.month(), column_value(file, directory.columns[COL_MONTH], i));
+		BOOST_REQUIRE_EQUAL(ex.day(), column_value(file, directory.columns[COL_DAY], i));
+		BOOST_REQUIRE_EQUAL(ex.ruota(), column_value(file, directory.columns[COL_RUOTA], i));
+		BOOST_REQUIRE_EQUAL(ex.a(), column_value(file, directory.columns[COL_A], i));
+		BOOST_REQUIRE_EQUAL(ex.c(), column_value(file, directory.columns[COL_C], i));
+		BOOST_REQUIRE_EQUAL(ex.e(), column_value(file, directory.columns[COL_E], i));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(a_changed_value_is_found)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 20);
+	BOOST_REQUIRE_EQUAL(0, save_file_columnar(records, "out.col"));
+
+	std::string file = read_whole_file("out.col");
+	columnar_directory_t directory;
+	BOOST_REQUIRE_EQUAL(0, parse_columnar_directory((const uint8_t *) file.data(), file.size(), directory));
+	file[directory.columns[COL_D].offset + 17] ^= 1;
+	{
+		std::ofstream out("out.col", std::ios::binary | std::ios::trunc);
+		out << file;
+	}
+	BOOST_CHECK_EQUAL(-1, verify_file_columnar(records, "out.col"));
+}
+
+BOOST_AUTO_TEST_CASE(a_cut_file_is_refused)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 20);
+	BOOST_REQUIRE_EQUAL(0, save_file_columnar(records, "out.col"));
+
+	const std::string file = read_whole_file("out.col");
+	columnar_directory_t directory;
+	BOOST_REQUIRE_EQUAL(0, parse_columnar_directory((const uint8_t *) file.data(), file.size(), directory));
+	uint64_t columns_end = 0;
+	for( uint32_t c = 0; c < COL_COUNT; c++ )
+	{
+		columns_end = std::max(columns_end, directory.columns[c].offset + directory.columns[c].bytes);
+	}
+	BOOST_CHECK_EQUAL(-1, parse_columnar_directory((const uint8_t *) file.data(), columns_end - 1, directory));
+	BOOST_CHECK_EQUAL(-1, parse_columnar_directory((const uint8_t *) file.data(), 16, directory));
+	std::string bad_magic = file;
+	bad_magic[0] = 'X';
+	BOOST_CHECK_EQUAL(-1, parse_columnar_directory((const uint8_t *) bad_magic.data(), bad_magic.size(), directory));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
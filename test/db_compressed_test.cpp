@@ -0,0 +1,140 @@
+/*
+ * db_compressed_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "utilities.h"
+#include "db_compressed.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(db_compressed)
+
+static void check_round_trip(const std::vector<extraction_t>& records)
+{
+	BOOST_REQUIRE_EQUAL(0, save_file_compressed(records, "out.z"));
+	BOOST_CHECK_EQUAL(0, verify_file_compressed(records, "out.z"));
+
+	std::vector<extraction_t> loaded;
+	BOOST_REQUIRE_EQUAL(0, load_file_compressed("out.z", loaded));
+	BOOST_REQUIRE_EQUAL(records.size(), loaded.size());
+	for( size_t i = 0; i < records.size(); i++ )
+	{
+		BOOST_REQUIRE_EQUAL(records[i].raw, loaded[i].raw);
+	}
+}
+
+static void write_file(const char *filename, const std::string& content)
+{
+	std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+	out << content;
+}
+
+BOOST_AUTO_TEST_CASE(unpacks_seven_bit_fields)
+{
+	const uint8_t values[] = { 1, 90, 45, 127, 0, 64, 33, 7, 88, 2 };
+	const size_t n = sizeof(values);
+	std::vector<uint8_t> packed((n * 7 + 7) / 8, 0);
+	for( size_t k = 0; k < n; k++ )
+	{
+		for( size_t bit = 0; bit < 7; bit++ )
+		{
+			if( values[k] & (1 << bit) )
+			{
+				packed[(k * 7 + bit) / 8] |= (uint8_t) (1 << ((k * 7 + bit) % 8));
+			}
+		}
+	}
+
+	uint8_t unpacked[sizeof(values)];
+	unpack_numbers(packed.data(), packed.size(), n, unpacked);
+	BOOST_CHECK_EQUAL_COLLECTIONS(values, values + n, unpacked, unpacked + n);
+}
+
+BOOST_AUTO_TEST_CASE(round_trip_over_several_blocks)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1900, 1500);
+	check_round_trip(records);
+
+	const std::string file = read_whole_file("out.z");
+	uint64_t n_records = 0;
+	uint32_t records_crc = 0;
+	std::vector<compressed_block_t> blocks;
+	BOOST_REQUIRE_EQUAL(0, parse_compressed_directory((const uint8_t *) file.data(), file.size(), n_records, records_crc, blocks));
+	BOOST_CHECK_EQUAL(records.size(), n_records);
+	BOOST_REQUIRE_GT(blocks.size(), 1u);
+	// smaller than the records as stored in a db
+	BOOST_CHECK_LT(file.size(), records.size() * 8);
+
+	uint64_t next = 0;
+	for( const auto& block : blocks )
+	{
+		BOOST_CHECK_EQUAL(next, block.first_record);
+		BOOST_CHECK_LE(block.n_records, (uint32_t) LOTTO_COMPRESSED_BLOCK_RECORDS);
+		BOOST_CHECK_EQUAL(records[block.first_record].date(), block.first_date);
+		BOOST_CHECK_EQUAL(records[block.first_record + block.n_records - 1].date(), block.last_date);
+		// blocks end on a draw
+		if( block.first_record > 0 )
+		{
+			BOOST_CHECK_NE(records[block.first_record - 1].date(), block.first_date);
+		}
+
+		std::vector<extraction_t> decoded(block.n_records);
+		BOOST_REQUIRE_EQUAL(0, decode_compressed_block((const uint8_t *) file.data() + block.offset, block, decoded.data()));
+		for( uint32_t i = 0; i < block.n_records; i++ )
+		{
+			BOOST_REQUIRE_EQUAL(records[block.first_record + i].raw, decoded[i].raw);
+		}
+		next += block.n_records;
+	}
+	BOOST_CHECK_EQUAL(records.size(), next);
+}
+
+BOOST_AUTO_TEST_CASE(draws_that_do_not_pack)
+{
+	scratch_dir_t scratch;
+	std::vector<extraction_t> records = make_records(1950, 30);
+	// a draw with some ruote missing, one with a ruota twice, and
+	// numbers out of range
+	records.erase(records.begin() + 3 * ruota_t::TUTTE + 2, records.begin() + 3 * ruota_t::TUTTE + 5);
+	records.insert(records.begin() + 10 * ruota_t::TUTTE, records[10 * ruota_t::TUTTE]);
+	records.push_back(make_extraction(1960, 1, 1, ruota_t::BARI, 0, 91, 127, 1, 2));
+	records.push_back(make_extraction(1960, 1, 8, ruota_t::TUTTE, 1, 2, 3, 4, 5));
+	check_round_trip(records);
+}
+
+BOOST_AUTO_TEST_CASE(empty_file)
+{
+	scratch_dir_t scratch;
+	check_round_trip(std::vector<extraction_t>());
+}
+
+BOOST_AUTO_TEST_CASE(a_damaged_block_is_found)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1900, 1500);
+	BOOST_REQUIRE_EQUAL(0, save_file_compressed(records, "out.z"));
+
+	std::string file = read_whole_file("out.z");
+	uint64_t n_records = 0;
+	uint32_t records_crc = 0;
+	std::vector<compressed_block_t> blocks;
+	BOOST_REQUIRE_EQUAL(0, parse_compressed_directory((const uint8_t *) file.data(), file.size(), n_records, records_crc, blocks));
+	file[blocks[1].offset + blocks[1].bytes / 2] ^= 0x04;
+	write_file("out.z", file);
+
+	std::vector<extraction_t> loaded;
+	BOOST_CHECK_EQUAL(-1, load_file_compressed("out.z", loaded));
+	BOOST_CHECK_EQUAL(-1, verify_file_compressed(records, "out.z"));
+
+	write_file("cut.z", file.substr(0, file.size() - 1));
+	BOOST_CHECK_EQUAL(-1, load_file_compressed("cut.z", loaded));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
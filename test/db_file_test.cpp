@@ -0,0 +1,269 @@
+/*
+ * db_file_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "crc32c.h"
+#include "utilities.h"
+#include "db_io.h"
+#include "db_file.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(db_file)
+
+// the word of the former bitfield record, as extraction_from_legacy() reads it
+static uint64_t legacy_word(const extraction_t& ex)
+{
+	return ( (uint64_t) ex.date() << LOTTO_SHIFT_DATE ) | \
+	       ( (uint64_t) ex.ruota() << LOTTO_LEGACY_SHIFT_RUOTA ) | \
+	       ( (uint64_t) ex.a() << LOTTO_LEGACY_SHIFT_A ) | \
+	       ( (uint64_t) ex.b() << LOTTO_LEGACY_SHIFT_B ) | \
+	       ( (uint64_t) ex.c() << LOTTO_LEGACY_SHIFT_C ) | \
+	       ( (uint64_t) ex.d() << LOTTO_LEGACY_SHIFT_D ) | \
+	       ( (uint64_t) ex.e() << LOTTO_LEGACY_SHIFT_E );
+}
+
+// a db of an older version: 0 the bare legacy words, 1 with the trailer,
+// 2 with the header too and no month index
+static void write_legacy_db(const char *filename, const std::vector<extraction_t>& records, uint32_t version)
+{
+	std::string records_bytes(records.size() * LOTTO_RECORD_BYTES, '\0');
+	for( size_t i = 0; i < records.size(); i++ )
+	{
+		store_be((uint8_t *) &records_bytes[i * LOTTO_RECORD_BYTES], legacy_word(records[i]), LOTTO_RECORD_BYTES);
+	}
+	db_trailer_t trailer;
+	trailer.n_records = records.size();
+	trailer.crc = crc32c_update(0, (const uint8_t *) records_bytes.data(), records_bytes.size());
+	uint8_t trailer_bytes[LOTTO_TRAILER_BYTES];
+	encode_trailer(trailer, trailer_bytes);
+
+	std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+	if( version >= 2 )
+	{
+		db_header_t header;
+		header.version = 2;
+		header.n_records = records.size();
+		header.first_date = records.empty() ? 0 : records.front().date();
+		header.last_date = records.empty() ? 0 : records.back().date();
+		header.index_offset = LOTTO_HEADER_BYTES + records_bytes.size();
+		header.n_months = 0;
+		header.index_crc = 0;
+		uint8_t header_bytes[LOTTO_HEADER_BYTES];
+		encode_header(header, header_bytes);
+		out.write((const char *) header_bytes, sizeof(header_bytes));
+	}
+	out << records_bytes;
+	if( version >= 1 )
+	{
+		out.write((const char *) trailer_bytes, sizeof(trailer_bytes));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(legacy_word_layout)
+{
+	const extraction_t ex = make_extraction(2020, 12, 27, 5, 34, 17, 66, 89, 85);
+	BOOST_CHECK_EQUAL(0x07E4CDD5B3088A25ull, legacy_word(ex));
+	BOOST_CHECK_EQUAL(ex.raw, extraction_from_legacy(legacy_word(ex)).raw);
+}
+
+BOOST_AUTO_TEST_CASE(every_version_reads_the_same_records)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 100);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "v3.db"));
+	write_legacy_db("v2.db", records, 2);
+	write_legacy_db("v1.db", records, 1);
+	write_legacy_db("v0.db", records, 0);
+
+	for( uint32_t version = 0; version <= 3; version++ )
+	{
+		const std::string filename = "v" + std::to_string(version) + ".db";
+		db_reader_t reader;
+		BOOST_REQUIRE_EQUAL(0, reader.open(filename.c_str()));
+		BOOST_CHECK_EQUAL(version, reader.layout().version);
+		BOOST_CHECK_EQUAL(version >= 1, reader.layout().has_trailer);
+		BOOST_CHECK_EQUAL(version < LOTTO_DB_SORTED_VERSION, reader.records().legacy());
+		// a header without a month index tells records out of date order
+		BOOST_CHECK_EQUAL(2 != version, reader.date_ordered());
+		BOOST_REQUIRE_EQUAL(records.size(), reader.size());
+		for( size_t i = 0; i < records.size(); i++ )
+		{
+			BOOST_REQUIRE_EQUAL(records[i].raw, reader[i].raw);
+		}
+
+		// bulk decoding and encoding give the current records
+		std::vector<extraction_t> decoded(records.size());
+		reader.records().decode(0, records.size(), decoded.data());
+		std::vector<uint8_t> encoded(records.size() * LOTTO_RECORD_BYTES), expected(encoded.size());
+		reader.records().encode(0, records.size(), encoded.data());
+		encode_records(records.data(), records.size(), expected.data());
+		BOOST_CHECK(expected == encoded);
+
+		std::vector<extraction_t> read_back;
+		BOOST_REQUIRE_EQUAL(0, read_file_db(filename, read_back, records.size()));
+		auto same_raw = [](const extraction_t& a, const extraction_t& b){ return a.raw == b.raw; };
+		BOOST_CHECK(std::equal(records.begin(), records.end(), decoded.begin(), decoded.end(), same_raw));
+		BOOST_CHECK(std::equal(records.begin(), records.end(), read_back.begin(), read_back.end(), same_raw));
+
+		uint32_t crc = 0;
+		BOOST_CHECK_EQUAL(version >= 1 ? 0 : -1, reader.verify(crc));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ranges_without_an_index_are_the_whole_db)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 100);
+	write_legacy_db("v2.db", records, 2);
+
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open("v2.db"));
+	BOOST_CHECK(NULL == reader.layout().months);
+	BOOST_CHECK_EQUAL(records.size(), reader.range(make_date(1991, 1, 1), make_date(1991, 2, 1)).size());
+	BOOST_CHECK(reader.range(make_date(1991, 2, 1), make_date(1991, 1, 1)).empty());
+}
+
+BOOST_AUTO_TEST_CASE(range_iterators_are_random_access)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 50);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open("out.db"));
+
+	const db_range_t all = reader.records();
+	BOOST_CHECK_EQUAL((std::ptrdiff_t) records.size(), all.end() - all.begin());
+	BOOST_CHECK_EQUAL(records.back().raw, all.back().raw);
+	BOOST_CHECK_EQUAL(records[17].raw, all.begin()[17].raw);
+	BOOST_CHECK_EQUAL(records[16].raw, (*(all.begin() + 17 - 1)).raw);
+
+	// the records of a date, found with a binary search on the range
+	const uint32_t date = records[200].date();
+	auto first = std::partition_point(all.begin(), all.end(), [date](const extraction_t& e){ return e.date() < date; });
+	auto end = std::partition_point(all.begin(), all.end(), [date](const extraction_t& e){ return e.date() <= date; });
+	BOOST_CHECK_EQUAL((std::ptrdiff_t) ruota_t::TUTTE, end - first);
+	BOOST_CHECK_EQUAL(date, (*first).date());
+
+	const db_range_t sub = all.subrange(100, 30);
+	BOOST_CHECK_EQUAL(100u, sub.first_record());
+	BOOST_CHECK_EQUAL(30u, sub.size());
+	BOOST_CHECK_EQUAL(records[100].raw, sub.front().raw);
+	BOOST_CHECK_EQUAL(records[129].raw, sub.back().raw);
+}
+
+BOOST_AUTO_TEST_CASE(files_that_are_no_db)
+{
+	scratch_dir_t scratch;
+	{
+		std::ofstream out("odd.db", std::ios::binary);
+		out << "not a db";
+		out << "x";
+	}
+	db_reader_t reader;
+	BOOST_CHECK_EQUAL(-1, reader.open("missing.db"));
+	BOOST_CHECK_EQUAL(-1, reader.open("odd.db"));
+	BOOST_CHECK(!reader.is_open());
+
+	const std::vector<extraction_t> records = make_records(1990, 10);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+	std::vector<extraction_t> read_back;
+	BOOST_CHECK_EQUAL(-1, read_file_db("out.db", read_back, records.size() + 1));
+	BOOST_CHECK_EQUAL(-1, verify_file_db(records, "out.db", 1));
+}
+
+BOOST_AUTO_TEST_CASE(record_fields_and_order)
+{
+	const extraction_t top = make_extraction(LOTTO_MASK_YEAR, 12, 31, ruota_t::TUTTE, 90, 89, 88, 87, 86);
+	BOOST_CHECK_EQUAL((uint32_t) LOTTO_MASK_YEAR, top.year());
+	BOOST_CHECK_EQUAL(12u, top.month());
+	BOOST_CHECK_EQUAL(31u, top.day());
+	BOOST_CHECK_EQUAL((uint32_t) ruota_t::TUTTE, top.ruota());
+	BOOST_CHECK_EQUAL(90u, top.a());
+	BOOST_CHECK_EQUAL(86u, top.e());
+	BOOST_CHECK_EQUAL(make_date(LOTTO_MASK_YEAR, 12, 31), top.date());
+	BOOST_CHECK_EQUAL(0u, make_extraction(0, 0, 0, 0, 0, 0, 0, 0, 0).raw);
+
+	// the raw words sort as date, ruota and then the numbers
+	const std::vector<extraction_t> records = make_records(1990, 60);
+	std::vector<extraction_t> reversed(records.rbegin(), records.rend());
+	std::sort(reversed.begin(), reversed.end(), [](const extraction_t& a, const extraction_t& b){ return a.raw < b.raw; });
+	for( size_t i = 0; i < records.size(); i++ )
+	{
+		BOOST_REQUIRE_EQUAL(records[i].raw, reversed[i].raw);
+		if( i > 0 )
+		{
+			BOOST_REQUIRE_LT(records[i - 1].key(), records[i].key());
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(convert_sorts_the_legacy_records)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 100);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "fresh.db"));
+	const std::string fresh = read_whole_file("fresh.db");
+
+	// the older parser wrote a draw in the ruote order of the year
+	// files, NAZIONALE last
+	std::vector<extraction_t> file_order = records;
+	for( size_t i = 0; i < file_order.size(); i += ruota_t::TUTTE )
+	{
+		std::rotate(file_order.begin() + i, file_order.begin() + i + 1, file_order.begin() + i + ruota_t::TUTTE);
+	}
+	BOOST_REQUIRE_EQUAL((uint32_t) ruota_t::NAZIONALE, file_order[ruota_t::TUTTE - 1].ruota());
+
+	for( uint32_t version = 0; version <= 2; version++ )
+	{
+		const std::string from = "v" + std::to_string(version) + ".db";
+		const std::string to = from + ".v3";
+		write_legacy_db(from.c_str(), file_order, version);
+		BOOST_REQUIRE_EQUAL(0, convert_file_db(from, to));
+		// the db of a fresh import, with its month index
+		BOOST_CHECK(fresh == read_whole_file(to));
+		db_reader_t reader;
+		BOOST_REQUIRE_EQUAL(0, reader.open(to.c_str()));
+		BOOST_CHECK_EQUAL((uint32_t) LOTTO_DB_VERSION, reader.layout().version);
+		BOOST_CHECK(NULL != reader.layout().months);
+	}
+
+	// a current db is written again as it is
+	BOOST_REQUIRE_EQUAL(0, convert_file_db("fresh.db", "again.db"));
+	BOOST_CHECK(fresh == read_whole_file("again.db"));
+}
+
+BOOST_AUTO_TEST_CASE(convert_writes_no_other_db)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 20);
+	write_legacy_db("old.db", records, 1);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(make_records(2000, 5), "other.db"));
+	const std::string other = read_whole_file("other.db");
+
+	BOOST_CHECK_EQUAL(-1, convert_file_db("old.db", "other.db"));
+	BOOST_CHECK(other == read_whole_file("other.db"));
+	BOOST_CHECK_EQUAL(-1, convert_file_db("missing.db", "new.db"));
+	BOOST_CHECK(!boost::filesystem::exists("new.db"));
+
+	// the source itself is rewritten in place, also by another name
+	BOOST_REQUIRE_EQUAL(0, convert_file_db("old.db", "./old.db"));
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open("old.db"));
+	BOOST_CHECK_EQUAL((uint32_t) LOTTO_DB_VERSION, reader.layout().version);
+	BOOST_REQUIRE_EQUAL(records.size(), reader.size());
+	for( size_t i = 0; i < records.size(); i++ )
+	{
+		BOOST_REQUIRE_EQUAL(records[i].raw, reader[i].raw);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
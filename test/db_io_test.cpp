@@ -0,0 +1,432 @@
+/*
+ * db_io_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "utilities.h"
+#include "db_io.h"
+#include "db_file.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(db_io)
+
+BOOST_AUTO_TEST_CASE(records_are_big_endian_words)
+{
+	const extraction_t ex = make_extraction(2020, 12, 27, ruota_t::MILANO, 17, 34, 51, 68, 85);
+	uint8_t bytes[LOTTO_RECORD_BYTES];
+	encode_records(&ex, 1, bytes);
+	for( size_t i = 0; i < LOTTO_RECORD_BYTES; i++ )
+	{
+		BOOST_CHECK_EQUAL((uint32_t) (uint8_t) (ex.raw >> (56 - 8 * i)), (uint32_t) bytes[i]);
+	}
+	BOOST_CHECK_EQUAL(ex.raw, decode_record(bytes).raw);
+	BOOST_CHECK_EQUAL(make_date(2020, 12, 27), stored_record_date(bytes));
+}
+
+BOOST_AUTO_TEST_CASE(records_round_trip_at_every_length)
+{
+	// the bulk paths work in blocks, the tails one record at a time
+	const std::vector<extraction_t> records = make_records(1990, 10);
+	for( size_t n = 0; n <= records.size(); n++ )
+	{
+		std::vector<uint8_t> bytes(n * LOTTO_RECORD_BYTES + 1, 0xA5);
+		encode_records(records.data(), n, bytes.data());
+		BOOST_REQUIRE_EQUAL(0xA5, bytes[n * LOTTO_RECORD_BYTES]);
+
+		std::vector<extraction_t> decoded(n);
+		decode_records(bytes.data(), n, decoded.data());
+		for( size_t i = 0; i < n; i++ )
+		{
+			BOOST_REQUIRE_EQUAL(records[i].raw, decoded[i].raw);
+			BOOST_REQUIRE_EQUAL(records[i].raw, decode_record(bytes.data() + i * LOTTO_RECORD_BYTES).raw);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(writer_spans_several_buffers)
+{
+	scratch_dir_t scratch;
+	// more than the 1 MB write buffer, in writes of odd sizes
+	std::string data(3 * (1 << 20) + 12345, '\0');
+	for( size_t i = 0; i < data.size(); i++ )
+	{
+		data[i] = (char) (i * 131 + i / 7);
+	}
+
+	db_file_writer_t writer;
+	BOOST_REQUIRE_EQUAL(0, writer.open("out.bin", data.size()));
+	for( size_t i = 0; i < data.size(); i += 99991 )
+	{
+		BOOST_REQUIRE_EQUAL(0, writer.write_bytes(data.data() + i, std::min((size_t) 99991, data.size() - i)));
+	}
+	BOOST_CHECK_EQUAL(data.size(), writer.offset());
+	BOOST_CHECK(!boost::filesystem::exists("out.bin"));
+	BOOST_REQUIRE_EQUAL(0, writer.commit());
+
+	BOOST_CHECK(data == read_whole_file("out.bin"));
+	BOOST_CHECK(!boost::filesystem::exists("out.bin.tmp"));
+}
+
+BOOST_AUTO_TEST_CASE(abort_leaves_the_destination_untouched)
+{
+	scratch_dir_t scratch;
+	{
+		db_file_writer_t writer;
+		BOOST_REQUIRE_EQUAL(0, writer.open("out.bin", 0));
+		BOOST_REQUIRE_EQUAL(0, writer.write_bytes("old", 3));
+		BOOST_REQUIRE_EQUAL(0, writer.commit());
+	}
+	{
+		db_file_writer_t writer;
+		BOOST_REQUIRE_EQUAL(0, writer.open("out.bin", 1 << 20));
+		BOOST_REQUIRE_EQUAL(0, writer.write_bytes("new contents", 12));
+		writer.abort();
+	}
+	{
+		// dropped with the writer, never committed
+		db_file_writer_t writer;
+		BOOST_REQUIRE_EQUAL(0, writer.open("out.bin", 0));
+		BOOST_REQUIRE_EQUAL(0, writer.write_bytes("newer", 5));
+	}
+
+	BOOST_CHECK_EQUAL("old", read_whole_file("out.bin"));
+	BOOST_CHECK(!boost::filesystem::exists("out.bin.tmp"));
+}
+
+BOOST_AUTO_TEST_CASE(save_and_read_a_db)
+{
+	scratch_dir_t scratch;
+	// enough records for several write buffers
+	const std::vector<extraction_t> records = make_records(1900, 2000);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+	BOOST_CHECK_EQUAL(0, verify_file_db(records, "out.db", 0));
+
+	std::vector<extraction_t> read_back;
+	BOOST_REQUIRE_EQUAL(0, read_file_db("out.db", read_back, records.size()));
+	BOOST_REQUIRE_EQUAL(records.size(), read_back.size());
+	for( size_t i = 0; i < records.size(); i++ )
+	{
+		BOOST_REQUIRE_EQUAL(records[i].raw, read_back[i].raw);
+	}
+
+	// the records are stored as encode_records() gives them
+	const std::string file = read_whole_file("out.db");
+	std::vector<uint8_t> bytes(records.size() * LOTTO_RECORD_BYTES);
+	encode_records(records.data(), records.size(), bytes.data());
+	BOOST_REQUIRE_GE(file.size(), LOTTO_HEADER_BYTES + bytes.size());
+	BOOST_CHECK(0 == std::memcmp(file.data() + LOTTO_HEADER_BYTES, bytes.data(), bytes.size()));
+}
+
+BOOST_AUTO_TEST_CASE(empty_db)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records;
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+	BOOST_CHECK_EQUAL(0, verify_file_db(records, "out.db", 0));
+
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open("out.db"));
+	BOOST_CHECK_EQUAL(0u, reader.size());
+	BOOST_CHECK(reader.range(make_date(1900, 1, 1), make_date(2100, 1, 1)).empty());
+}
+
+// records [first, end) of records written by an append to file_db,
+// over its records from first_record on
+static int32_t append_records(const char *file_db, uint64_t first_record, const std::vector<extraction_t>& records,
+		size_t first, size_t end)
+{
+	db_file_writer_t writer;
+	if( writer.open_db_append(file_db, first_record) || \
+		writer.write_records(records.data() + first, end - first) || \
+		writer.write_trailer() )
+	{
+		return -1;
+	}
+	return writer.commit();
+}
+
+BOOST_AUTO_TEST_CASE(append_writes_the_db_a_full_save_writes)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 1200);
+	const std::vector<extraction_t> head(records.begin(), records.begin() + 7000);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "whole.db"));
+	BOOST_REQUIRE_EQUAL(0, save_file_db(head, "out.db"));
+
+	BOOST_REQUIRE_EQUAL(0, append_records("out.db", head.size(), records, head.size(), records.size()));
+	BOOST_CHECK(read_whole_file("whole.db") == read_whole_file("out.db"));
+	BOOST_CHECK(!boost::filesystem::exists("out.db.tmp"));
+}
+
+BOOST_AUTO_TEST_CASE(append_rewrites_the_last_draw)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 200);
+	// the last draw of the db is incomplete, 4 of its 11 ruote
+	const size_t draw_end = 100 * ruota_t::TUTTE;
+	std::vector<extraction_t> head(records.begin(), records.begin() + draw_end - 7);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "whole.db"));
+	BOOST_REQUIRE_EQUAL(0, save_file_db(head, "out.db"));
+
+	std::vector<extraction_t> last_draw;
+	uint64_t n_records = 0;
+	uint32_t version = 0;
+	BOOST_REQUIRE_EQUAL(0, read_last_draw("out.db", last_draw, n_records, version));
+	BOOST_CHECK_EQUAL(head.size(), n_records);
+	BOOST_CHECK_EQUAL(LOTTO_DB_VERSION, version);
+	BOOST_REQUIRE_EQUAL(4u, last_draw.size());
+	for( size_t k = 0; k < last_draw.size(); k++ )
+	{
+		BOOST_CHECK_EQUAL(head[head.size() - 4 + k].raw, last_draw[k].raw);
+	}
+
+	const uint64_t first_record = n_records - last_draw.size();
+	BOOST_REQUIRE_EQUAL(0, append_records("out.db", first_record, records, first_record, records.size()));
+	BOOST_CHECK(read_whole_file("whole.db") == read_whole_file("out.db"));
+	BOOST_CHECK_EQUAL(0, verify_file_db(records, "out.db", 0));
+}
+
+BOOST_AUTO_TEST_CASE(append_keeps_a_mapped_reader_whole)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 400);
+	const std::vector<extraction_t> head(records.begin(), records.begin() + 2000);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(head, "out.db"));
+	const std::string before = read_whole_file("out.db");
+
+	// a reader mapping the db, as the query daemon, sees the file it
+	// mapped while the db is replaced
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open("out.db"));
+	BOOST_REQUIRE_EQUAL(0, append_records("out.db", 1000, records, 1000, records.size()));
+	BOOST_CHECK_EQUAL(head.size(), reader.size());
+	BOOST_CHECK(0 == std::memcmp(before.data(), reader.data(), before.size()));
+	uint32_t crc = 0;
+	BOOST_CHECK_EQUAL(0, reader.verify(crc));
+
+	db_reader_t after;
+	BOOST_REQUIRE_EQUAL(0, after.open("out.db"));
+	BOOST_CHECK_EQUAL(records.size(), after.size());
+}
+
+BOOST_AUTO_TEST_CASE(append_needs_a_current_db)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 20);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+	const std::string before = read_whole_file("out.db");
+
+	db_file_writer_t writer;
+	BOOST_CHECK_EQUAL(-1, writer.open_db_append("missing.db", 0));
+	BOOST_CHECK_EQUAL(-1, writer.open_db_append("out.db", records.size() + 1));
+	{
+		// a bare record stream, version 0
+		db_file_writer_t raw;
+		BOOST_REQUIRE_EQUAL(0, raw.open("raw.db", 0));
+		BOOST_REQUIRE_EQUAL(0, raw.write_records(records.data(), records.size()));
+		BOOST_REQUIRE_EQUAL(0, raw.commit());
+	}
+	BOOST_CHECK_EQUAL(-1, writer.open_db_append("raw.db", 0));
+	BOOST_CHECK(before == read_whole_file("out.db"));
+}
+
+BOOST_AUTO_TEST_CASE(no_last_draw_out_of_date_order)
+{
+	scratch_dir_t scratch;
+	// records not in date order get no month index
+	std::vector<extraction_t> records = make_records(1990, 20);
+	std::swap(records.front(), records.back());
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open("out.db"));
+	BOOST_CHECK(!reader.date_ordered());
+
+	std::vector<extraction_t> last_draw;
+	uint64_t n_records = 0;
+	uint32_t version = 0;
+	BOOST_CHECK_EQUAL(-1, read_last_draw("out.db", last_draw, n_records, version));
+}
+
+BOOST_AUTO_TEST_CASE(append_of_bytes_keeps_the_prefix)
+{
+	scratch_dir_t scratch;
+	{
+		db_file_writer_t writer;
+		BOOST_REQUIRE_EQUAL(0, writer.open("out.bin", 0));
+		BOOST_REQUIRE_EQUAL(0, writer.write_bytes("0123456789", 10));
+		BOOST_REQUIRE_EQUAL(0, writer.commit());
+	}
+
+	db_file_writer_t writer;
+	BOOST_REQUIRE_EQUAL(0, writer.open_append("out.bin", 4));
+	BOOST_CHECK_EQUAL(4u, writer.offset());
+	BOOST_REQUIRE_EQUAL(0, writer.write_bytes("abc", 3));
+	BOOST_REQUIRE_EQUAL(0, writer.commit());
+	BOOST_CHECK_EQUAL("0123abc", read_whole_file("out.bin"));
+
+	BOOST_CHECK_EQUAL(-1, writer.open_append("out.bin", 8));
+	BOOST_CHECK_EQUAL("0123abc", read_whole_file("out.bin"));
+}
+
+BOOST_AUTO_TEST_CASE(header_round_trip)
+{
+	db_header_t header;
+	header.version = LOTTO_DB_VERSION;
+	header.n_records = 1234;
+	header.first_date = make_date(1871, 1, 7);
+	header.last_date = make_date(2020, 12, 29);
+	header.index_offset = LOTTO_HEADER_BYTES + 1234 * LOTTO_RECORD_BYTES;
+	header.n_months = 17;
+	header.index_crc = 0xCAFEBABE;
+	uint8_t bytes[LOTTO_HEADER_BYTES];
+	encode_header(header, bytes);
+
+	db_header_t decoded;
+	BOOST_REQUIRE_EQUAL(0, decode_header(bytes, decoded));
+	BOOST_CHECK_EQUAL(header.version, decoded.version);
+	BOOST_CHECK_EQUAL(header.n_records, decoded.n_records);
+	BOOST_CHECK_EQUAL(header.first_date, decoded.first_date);
+	BOOST_CHECK_EQUAL(header.last_date, decoded.last_date);
+	BOOST_CHECK_EQUAL(header.index_offset, decoded.index_offset);
+	BOOST_CHECK_EQUAL(header.n_months, decoded.n_months);
+	BOOST_CHECK_EQUAL(header.index_crc, decoded.index_crc);
+
+	// any changed byte fails the checksum or a check before it
+	for( size_t i = 0; i < 60; i++ )
+	{
+		bytes[i] ^= 0x10;
+		BOOST_CHECK_EQUAL(-1, decode_header(bytes, decoded));
+		bytes[i] ^= 0x10;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(month_index_of_a_db)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 100);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open("out.db"));
+	const db_layout_t& layout = reader.layout();
+	BOOST_CHECK_EQUAL(LOTTO_DB_VERSION, layout.version);
+	BOOST_CHECK_EQUAL((uint64_t) LOTTO_HEADER_BYTES, layout.records_offset);
+	BOOST_CHECK_EQUAL(records.size(), layout.n_records);
+	BOOST_CHECK_EQUAL(records.front().date(), layout.first_date);
+	BOOST_CHECK_EQUAL(records.back().date(), layout.last_date);
+	BOOST_REQUIRE(NULL != layout.months);
+	// four draws a month, 25 months
+	BOOST_REQUIRE_EQUAL(25u, layout.n_months);
+	for( uint32_t k = 0; k < layout.n_months; k++ )
+	{
+		const uint8_t *entry = layout.months + k * LOTTO_MONTH_BYTES;
+		const uint64_t first_record = load_be(entry + 8, 8);
+		BOOST_CHECK_EQUAL(4u * ruota_t::TUTTE, load_be(entry + 4, 4));
+		BOOST_CHECK_EQUAL(k * 4u * ruota_t::TUTTE, first_record);
+		BOOST_CHECK_EQUAL(make_month_key(records[first_record].date()), load_be(entry, 4));
+	}
+	BOOST_CHECK(reader.date_ordered());
+}
+
+BOOST_AUTO_TEST_CASE(date_ranges_match_a_linear_scan)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 300);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open("out.db"));
+
+	// every pair of bounds among the dates drawn, the days between them
+	// and dates out of the db
+	std::vector<uint32_t> dates = { make_date(1900, 1, 1), make_date(2100, 1, 1), make_date(1995, 2, 31) };
+	for( size_t i = 0; i < records.size(); i += 5 * ruota_t::TUTTE )
+	{
+		dates.push_back(records[i].date());
+		dates.push_back(records[i].date() + 1);
+	}
+	for( uint32_t from_date : dates )
+	{
+		for( uint32_t to_date : dates )
+		{
+			uint64_t first = 0, end = 0;
+			while( first < records.size() && records[first].date() < from_date )
+				first++;
+			end = first;
+			while( end < records.size() && records[end].date() <= to_date )
+				end++;
+
+			const db_range_t range = reader.range(from_date, to_date);
+			BOOST_REQUIRE_EQUAL(end - first, range.size());
+			if( !range.empty() )
+			{
+				BOOST_REQUIRE_EQUAL(first, range.first_record());
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(inverted_date_range_is_empty)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 100);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open("out.db"));
+
+	uint64_t first = 1, end = 1;
+	locate_date_range(reader.data(), reader.layout(), make_date(1991, 1, 1), make_date(1990, 1, 1), first, end);
+	BOOST_CHECK_EQUAL(0u, first);
+	BOOST_CHECK_EQUAL(0u, end);
+	BOOST_CHECK(reader.range(make_date(1991, 1, 1), make_date(1990, 1, 1)).empty());
+}
+
+BOOST_AUTO_TEST_CASE(no_index_gives_the_whole_db)
+{
+	scratch_dir_t scratch;
+	// records out of date order are written without a month index, a
+	// date range is then the whole db for the caller to filter
+	std::vector<extraction_t> records = make_records(1990, 100);
+	std::swap(records.front(), records.back());
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open("out.db"));
+	BOOST_CHECK(NULL == reader.layout().months);
+	BOOST_CHECK_EQUAL(0u, reader.layout().n_months);
+
+	const db_range_t range = reader.range(make_date(1991, 1, 1), make_date(1991, 12, 31));
+	BOOST_CHECK_EQUAL(0u, range.first_record());
+	BOOST_CHECK_EQUAL(records.size(), range.size());
+	BOOST_CHECK(reader.range(make_date(1991, 1, 1), make_date(1990, 1, 1)).empty());
+}
+
+BOOST_AUTO_TEST_CASE(inconsistent_layouts_are_refused)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 20);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+	const std::string file = read_whole_file("out.db");
+	const uint8_t *data = (const uint8_t *) file.data();
+
+	db_layout_t layout;
+	BOOST_REQUIRE_EQUAL(0, parse_db_layout(data, file.size(), layout));
+	// a record more or less than the header tells
+	std::string cut = file.substr(0, LOTTO_HEADER_BYTES + 8) + file.substr(LOTTO_HEADER_BYTES + 16);
+	BOOST_CHECK_EQUAL(-1, parse_db_layout((const uint8_t *) cut.data(), cut.size(), layout));
+	std::string longer = file.substr(0, LOTTO_HEADER_BYTES + 8) + file.substr(LOTTO_HEADER_BYTES);
+	BOOST_CHECK_EQUAL(-1, parse_db_layout((const uint8_t *) longer.data(), longer.size(), layout));
+	// a changed month index entry
+	std::string bad_index = file;
+	bad_index[file.size() - LOTTO_TRAILER_BYTES - 1] ^= 1;
+	BOOST_CHECK_EQUAL(-1, parse_db_layout((const uint8_t *) bad_index.data(), bad_index.size(), layout));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,178 @@
+/*
+ * db_merge_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "db_file.h"
+#include "ritardo_index.h"
+#include "bitset_index.h"
+#include "import_stats.h"
+#include "db_merge.h"
+#include "test_helpers.h"
+
+// the same record with other numbers
+static extraction_t reprint_of(const extraction_t& ex)
+{
+	return make_extraction(ex.year(), ex.month(), ex.day(), ex.ruota(), ex.b(), ex.a(), ex.c(), ex.d(), ex.e());
+}
+
+// no file of the merge is left besides the output and its indexes
+static size_t count_files()
+{
+	return std::distance(boost::filesystem::directory_iterator("."), boost::filesystem::directory_iterator());
+}
+
+static void check_db_records(const char *file_db, const std::vector<extraction_t>& records)
+{
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open(file_db));
+	BOOST_CHECK_EQUAL((uint32_t) LOTTO_DB_VERSION, reader.layout().version);
+	BOOST_CHECK(reader.date_ordered());
+	BOOST_REQUIRE_EQUAL(records.size(), reader.size());
+	for( size_t i = 0; i < records.size(); i++ )
+	{
+		BOOST_REQUIRE_EQUAL(records[i].raw, reader[i].raw);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(db_merge)
+
+BOOST_AUTO_TEST_CASE(split_dbs_merge_into_the_whole)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 200);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "whole.db"));
+
+	// the draws dealt round to three dbs, each in key order
+	std::vector<extraction_t> parts[3];
+	for( size_t i = 0; i < records.size(); i++ )
+	{
+		parts[(i / ruota_t::TUTTE) % 3].push_back(records[i]);
+	}
+	BOOST_REQUIRE_EQUAL(0, save_file_db(parts[0], "a.db"));
+	BOOST_REQUIRE_EQUAL(0, save_file_db(parts[1], "b.db"));
+	BOOST_REQUIRE_EQUAL(0, save_file_db(parts[2], "c.db"));
+	const size_t n_files = count_files();
+
+	import_stats_t stats;
+	BOOST_REQUIRE_EQUAL(0, merge_file_dbs({ "c.db", "a.db", "b.db" }, "out.db", MERGE_FAIL, stats));
+	BOOST_CHECK(read_whole_file("whole.db") == read_whole_file("out.db"));
+	BOOST_CHECK(boost::filesystem::exists(ritardo_index_path("out.db")));
+	BOOST_CHECK(boost::filesystem::exists(bitset_index_path("out.db")));
+	BOOST_CHECK_EQUAL(n_files + 3, count_files());
+
+	BOOST_REQUIRE_EQUAL(4u, stats.phases().size());
+	BOOST_CHECK_EQUAL(std::string("merge"), stats.phases()[1].name);
+	BOOST_CHECK_EQUAL(records.size(), stats.phases()[1].records);
+}
+
+BOOST_AUTO_TEST_CASE(same_records_are_kept_once)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 100);
+	const std::vector<extraction_t> head(records.begin(), records.begin() + 60 * ruota_t::TUTTE);
+	const std::vector<extraction_t> tail(records.begin() + 40 * ruota_t::TUTTE, records.end());
+	BOOST_REQUIRE_EQUAL(0, save_file_db(head, "head.db"));
+	BOOST_REQUIRE_EQUAL(0, save_file_db(tail, "tail.db"));
+
+	import_stats_t stats;
+	BOOST_REQUIRE_EQUAL(0, merge_file_dbs({ "head.db", "tail.db", "head.db" }, "out.db", MERGE_FAIL, stats));
+	check_db_records("out.db", records);
+}
+
+BOOST_AUTO_TEST_CASE(different_records_follow_the_policy)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 50);
+	std::vector<extraction_t> reprinted = records;
+	reprinted[7] = reprint_of(records[7]);
+	reprinted[300] = reprint_of(records[300]);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "first.db"));
+	BOOST_REQUIRE_EQUAL(0, save_file_db(reprinted, "last.db"));
+
+	import_stats_t stats;
+	BOOST_CHECK_EQUAL(-1, merge_file_dbs({ "first.db", "last.db" }, "fail.db", MERGE_FAIL, stats));
+	BOOST_CHECK(!boost::filesystem::exists("fail.db"));
+
+	BOOST_REQUIRE_EQUAL(0, merge_file_dbs({ "first.db", "last.db" }, "keep_first.db", MERGE_KEEP_FIRST, stats));
+	check_db_records("keep_first.db", records);
+	BOOST_REQUIRE_EQUAL(0, merge_file_dbs({ "first.db", "last.db" }, "keep_last.db", MERGE_KEEP_LAST, stats));
+	check_db_records("keep_last.db", reprinted);
+	BOOST_REQUIRE_EQUAL(0, merge_file_dbs({ "last.db", "first.db" }, "swapped.db", MERGE_KEEP_LAST, stats));
+	check_db_records("swapped.db", records);
+}
+
+BOOST_AUTO_TEST_CASE(later_record_of_one_db_is_the_last)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 20);
+	std::vector<extraction_t> expected = records;
+	expected[30] = reprint_of(records[30]);
+	// the reprint right after the record it replaces
+	std::vector<extraction_t> twice = records;
+	twice.insert(twice.begin() + 31, expected[30]);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(twice, "twice.db"));
+
+	import_stats_t stats;
+	BOOST_CHECK_EQUAL(-1, merge_file_dbs({ "twice.db" }, "fail.db", MERGE_FAIL, stats));
+	BOOST_REQUIRE_EQUAL(0, merge_file_dbs({ "twice.db" }, "keep_first.db", MERGE_KEEP_FIRST, stats));
+	check_db_records("keep_first.db", records);
+	BOOST_REQUIRE_EQUAL(0, merge_file_dbs({ "twice.db" }, "keep_last.db", MERGE_KEEP_LAST, stats));
+	check_db_records("keep_last.db", expected);
+}
+
+BOOST_AUTO_TEST_CASE(unsorted_db_is_sorted_in_runs)
+{
+	scratch_dir_t scratch;
+	// more records than a run, in reverse order, merged with a sorted db
+	const uint32_t n_draws = 1 + LOTTO_MERGE_RUN_RECORDS / ruota_t::TUTTE;
+	const std::vector<extraction_t> records = make_records(1000, n_draws);
+	BOOST_REQUIRE_GT(records.size(), (size_t) LOTTO_MERGE_RUN_RECORDS);
+	const std::vector<extraction_t> reversed(records.rbegin(), records.rend() - 100);
+	const std::vector<extraction_t> head(records.begin(), records.begin() + 200);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(reversed, "reversed.db"));
+	BOOST_REQUIRE_EQUAL(0, save_file_db(head, "head.db"));
+	{
+		db_reader_t reader;
+		BOOST_REQUIRE_EQUAL(0, reader.open("reversed.db"));
+		BOOST_REQUIRE(!reader.date_ordered());
+	}
+	const size_t n_files = count_files();
+
+	import_stats_t stats;
+	BOOST_REQUIRE_EQUAL(0, merge_file_dbs({ "reversed.db", "head.db" }, "out.db", MERGE_FAIL, stats));
+	check_db_records("out.db", records);
+	// the run files are gone
+	BOOST_CHECK_EQUAL(n_files + 3, count_files());
+}
+
+BOOST_AUTO_TEST_CASE(output_is_a_new_file)
+{
+	scratch_dir_t scratch;
+	BOOST_REQUIRE_EQUAL(0, save_file_db(make_records(1990, 20), "a.db"));
+	BOOST_REQUIRE_EQUAL(0, save_file_db(make_records(2000, 20), "b.db"));
+	const std::string a = read_whole_file("a.db");
+	const std::string b = read_whole_file("b.db");
+
+	import_stats_t stats;
+	BOOST_CHECK_EQUAL(-1, merge_file_dbs({ "a.db", "b.db" }, "b.db", MERGE_KEEP_LAST, stats));
+	BOOST_CHECK_EQUAL(-1, merge_file_dbs({ "a.db", "b.db" }, "./a.db", MERGE_KEEP_LAST, stats));
+	BOOST_CHECK(a == read_whole_file("a.db"));
+	BOOST_CHECK(b == read_whole_file("b.db"));
+
+	// an existing file that is no input
+	BOOST_CHECK_EQUAL(-1, merge_file_dbs({ "a.db" }, "b.db", MERGE_KEEP_LAST, stats));
+	BOOST_CHECK(b == read_whole_file("b.db"));
+
+	BOOST_CHECK_EQUAL(-1, merge_file_dbs({ "a.db", "missing.db" }, "out.db", MERGE_FAIL, stats));
+	BOOST_CHECK(!boost::filesystem::exists("out.db"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
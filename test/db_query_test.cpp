@@ -0,0 +1,105 @@
+/*
+ * db_query_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstring>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "utilities.h"
+#include "db_file.h"
+#include "db_query.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(db_query)
+
+// one record at a time over the whole vector
+static void naive_frequencies(const std::vector<extraction_t>& records, uint32_t from_date, uint32_t to_date,
+		frequency_table_t& table)
+{
+	std::memset(&table, 0, sizeof(table));
+	for( const auto& ex : records )
+	{
+		if( ex.date() < from_date || ex.date() > to_date )
+			continue;
+		table.n_records++;
+		for( uint32_t number : { ex.a(), ex.b(), ex.c(), ex.d(), ex.e() } )
+		{
+			table.counts[ex.ruota()][number]++;
+			table.counts[ruota_t::TUTTE][number]++;
+		}
+	}
+}
+
+static void check_same_table(const frequency_table_t& expected, const frequency_table_t& found)
+{
+	BOOST_REQUIRE_EQUAL(expected.n_records, found.n_records);
+	for( uint32_t r = 0; r < ruota_t::UNKNOWN; r++ )
+	{
+		for( uint32_t n = 1; n <= 90; n++ )
+		{
+			BOOST_REQUIRE_EQUAL(expected.counts[r][n], found.counts[r][n]);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(frequencies_match_a_naive_count)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 480);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+
+	const uint32_t ranges[][2] =
+	{
+		{ make_date(1990, 1, 1), make_date(1999, 12, 31) },
+		{ make_date(1993, 3, 8), make_date(1993, 3, 8) },
+		{ make_date(1993, 3, 9), make_date(1996, 7, 14) },
+		{ make_date(1900, 1, 1), make_date(1990, 1, 1) },
+		{ make_date(1999, 12, 22), make_date(2100, 1, 1) },
+		{ make_date(2001, 1, 1), make_date(2002, 1, 1) },
+	};
+	for( const auto& range : ranges )
+	{
+		frequency_table_t expected, found;
+		naive_frequencies(records, range[0], range[1], expected);
+		BOOST_REQUIRE_EQUAL(0, query_frequencies("out.db", range[0], range[1], found));
+		check_same_table(expected, found);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(inverted_range_counts_nothing)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 100);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+
+	frequency_table_t table;
+	BOOST_REQUIRE_EQUAL(0, query_frequencies("out.db", make_date(1991, 1, 1), make_date(1990, 1, 1), table));
+	BOOST_CHECK_EQUAL(0u, table.n_records);
+	BOOST_CHECK_EQUAL(0u, table.counts[ruota_t::TUTTE][1]);
+}
+
+BOOST_AUTO_TEST_CASE(frequencies_of_a_range_in_memory)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 100);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open("out.db"));
+	frequency_table_t expected, found;
+	naive_frequencies(records, make_date(1990, 6, 1), make_date(1991, 6, 1), expected);
+	compute_frequencies(reader.records(), make_date(1990, 6, 1), make_date(1991, 6, 1), found);
+	check_same_table(expected, found);
+}
+
+BOOST_AUTO_TEST_CASE(missing_db)
+{
+	scratch_dir_t scratch;
+	frequency_table_t table;
+	BOOST_CHECK_EQUAL(-1, query_frequencies("missing.db", 0, make_date(2100, 1, 1), table));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,90 @@
+/*
+ * import_stats_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "db_file.h"
+#include "import_stats.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(import_stats)
+
+BOOST_AUTO_TEST_CASE(phases_count_their_own_work)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 300);
+	import_stats_t stats;
+
+	stats.begin("save");
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+	stats.end(records.size());
+
+	stats.begin("read");
+	std::vector<extraction_t> read_back;
+	BOOST_REQUIRE_EQUAL(0, read_file_db("out.db", read_back, records.size()));
+	stats.end(read_back.size());
+
+	const uint64_t file_size = boost::filesystem::file_size("out.db");
+	const std::vector<phase_stats_t>& phases = stats.phases();
+	BOOST_REQUIRE_EQUAL(2u, phases.size());
+	BOOST_CHECK_EQUAL("save", phases[0].name);
+	BOOST_CHECK_EQUAL(records.size(), phases[0].records);
+	BOOST_CHECK_EQUAL(file_size, phases[0].bytes_written);
+	BOOST_CHECK_EQUAL(0u, phases[0].bytes_read);
+	BOOST_CHECK_GT(phases[0].allocations, 0u);
+
+	BOOST_CHECK_EQUAL("read", phases[1].name);
+	BOOST_CHECK_EQUAL(file_size, phases[1].bytes_read);
+	BOOST_CHECK_EQUAL(0u, phases[1].bytes_written);
+	// the records read back at least
+	BOOST_CHECK_GE(phases[1].allocated_bytes, records.size() * sizeof(extraction_t));
+	BOOST_CHECK_GT(phases[1].peak_rss_kb, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(json_is_one_object_per_phase)
+{
+	import_stats_t stats;
+	stats.begin("parse");
+	stats.end(10);
+	stats.begin("save");
+	stats.end(20);
+
+	std::ostringstream out;
+	stats.print(STATS_JSON, out);
+	const std::string json = out.str();
+	BOOST_CHECK_EQUAL(0u, json.find("{\"phases\":[{\"name\":\"parse\",\"wall_ns\":"));
+	BOOST_CHECK_NE(std::string::npos, json.find("},{\"name\":\"save\",\"wall_ns\":"));
+	BOOST_CHECK_NE(std::string::npos, json.find(",\"records\":20,"));
+	BOOST_CHECK_NE(std::string::npos, json.find("],\"wall_ns\":"));
+	// one line, braces balanced
+	BOOST_CHECK_EQUAL(json.size() - 1, json.find('\n'));
+	int depth = 0;
+	for( char c : json )
+	{
+		depth += ( '{' == c || '[' == c ) ? 1 : ( '}' == c || ']' == c ) ? -1 : 0;
+		BOOST_REQUIRE_GE(depth, 0);
+	}
+	BOOST_CHECK_EQUAL(0, depth);
+}
+
+BOOST_AUTO_TEST_CASE(text_is_one_line_per_phase)
+{
+	import_stats_t stats;
+	stats.begin("parse");
+	stats.end(10);
+
+	std::ostringstream out;
+	stats.print(STATS_TEXT, out);
+	const std::string text = out.str();
+	BOOST_CHECK_EQUAL(0u, text.find("stats parse: wall "));
+	BOOST_CHECK_NE(std::string::npos, text.find("\nstats total: wall "));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
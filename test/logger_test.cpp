@@ -0,0 +1,163 @@
+/*
+ * logger_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/test/unit_test.hpp>
+#include "logger.h"
+#include "test_helpers.h"
+
+// the level of the test run is restored after each case
+struct log_level_guard_t
+{
+	log_level_guard_t() : saved(log_get_level()) {}
+	~log_level_guard_t() { log_set_level(saved); }
+
+	log_level_t saved;
+};
+
+// stdout sent to a file for the life of the capture, the lines queued
+// before are written first
+struct stdout_capture_t
+{
+	explicit stdout_capture_t(const char *file) : saved(-1)
+	{
+		log_flush();
+		std::cout.flush();
+		const int fd = ::open(file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if( fd >= 0 )
+		{
+			saved = ::dup(STDOUT_FILENO);
+			::dup2(fd, STDOUT_FILENO);
+			::close(fd);
+		}
+	}
+	~stdout_capture_t() { restore(); }
+
+	void restore()
+	{
+		if( saved < 0 )
+			return;
+		log_flush();
+		::dup2(saved, STDOUT_FILENO);
+		::close(saved);
+		saved = -1;
+	}
+
+	int saved;
+};
+
+static int side_effects = 0;
+
+static int count_side_effect()
+{
+	return ++side_effects;
+}
+
+BOOST_AUTO_TEST_SUITE(logger)
+
+BOOST_AUTO_TEST_CASE(threshold_filters_the_levels)
+{
+	log_level_guard_t guard;
+	log_set_level(LOG_WARN);
+	BOOST_CHECK_EQUAL(LOG_WARN, log_get_level());
+	BOOST_CHECK(log_enabled(LOG_ERROR));
+	BOOST_CHECK(log_enabled(LOG_WARN));
+	BOOST_CHECK(!log_enabled(LOG_INFO));
+	BOOST_CHECK(!log_enabled(LOG_DEBUG));
+
+	log_set_level(LOG_SILENT);
+	BOOST_CHECK(!log_enabled(LOG_ERROR));
+	log_set_level(LOG_DEBUG);
+	BOOST_CHECK(log_enabled(LOG_DEBUG));
+}
+
+BOOST_AUTO_TEST_CASE(filtered_line_is_not_formatted)
+{
+	log_level_guard_t guard;
+	scratch_dir_t scratch;
+	side_effects = 0;
+	{
+		stdout_capture_t capture("out.txt");
+		log_set_level(LOG_ERROR);
+		LOTTO_LOG(LOG_INFO) << "info " << count_side_effect();
+		LOTTO_LOG(LOG_DEBUG) << "debug " << count_side_effect();
+		LOTTO_LOG(LOG_ERROR) << "error " << count_side_effect();
+		// a branch without braces takes the whole statement
+		if( 0 == side_effects )
+			LOTTO_LOG(LOG_ERROR) << "not reached";
+		else
+			LOTTO_LOG(LOG_ERROR) << "reached";
+	}
+	BOOST_CHECK_EQUAL(1, side_effects);
+	BOOST_CHECK_EQUAL(std::string("error 1\nreached\n"), read_whole_file("out.txt"));
+}
+
+BOOST_AUTO_TEST_CASE(long_line_is_cut)
+{
+	log_level_guard_t guard;
+	scratch_dir_t scratch;
+	const std::string long_text(3 * LOTTO_LOG_LINE_BYTES, 'x');
+	{
+		stdout_capture_t capture("out.txt");
+		log_set_level(LOG_INFO);
+		LOTTO_LOG(LOG_INFO) << long_text;
+		LOTTO_LOG(LOG_INFO) << "after";
+	}
+	BOOST_CHECK_EQUAL(long_text.substr(0, LOTTO_LOG_LINE_BYTES - 1) + "\nafter\n", read_whole_file("out.txt"));
+}
+
+BOOST_AUTO_TEST_CASE(lines_of_many_threads_are_all_written_in_order)
+{
+	log_level_guard_t guard;
+	scratch_dir_t scratch;
+	// more lines than the ring holds, the callers wait for the writer
+	const int n_threads = 4;
+	const int n_lines = 3 * LOTTO_LOG_RING_SLOTS;
+	{
+		stdout_capture_t capture("out.txt");
+		log_set_level(LOG_DEBUG);
+		std::vector<std::thread> threads;
+		for( int t = 0; t < n_threads; t++ )
+		{
+			threads.emplace_back([t](){
+				for( int i = 0; i < n_lines; i++ )
+				{
+					LOTTO_LOG(LOG_DEBUG) << "thread " << t << " line " << i;
+				}
+			});
+		}
+		for( auto& thread : threads )
+		{
+			thread.join();
+		}
+	}
+
+	// the lines of each thread in the order it queued them
+	std::istringstream in(read_whole_file("out.txt"));
+	std::vector<int> next(n_threads, 0);
+	std::string line;
+	int total = 0;
+	while( std::getline(in, line) )
+	{
+		int t = -1, i = -1;
+		BOOST_REQUIRE_EQUAL(2, std::sscanf(line.c_str(), "thread %d line %d", &t, &i));
+		BOOST_REQUIRE(t >= 0 && t < n_threads);
+		BOOST_REQUIRE_EQUAL(next[t], i);
+		next[t]++;
+		total++;
+	}
+	BOOST_CHECK_EQUAL(n_threads * n_lines, total);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
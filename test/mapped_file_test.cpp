@@ -0,0 +1,115 @@
+/*
+ * mapped_file_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "mapped_file.h"
+#include "year_parser.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(mapped_file)
+
+static void write_file(const char *filename, const std::string& content)
+{
+	std::ofstream out(filename, std::ios::binary);
+	out << content;
+}
+
+BOOST_AUTO_TEST_CASE(maps_the_whole_file)
+{
+	scratch_dir_t scratch;
+	const std::string content = "1871 BARI FIRENZE 1871\n07 GEN 1 2 3 4 5 6 7 8 9 10 X\nEND\n";
+	write_file("a.txt", content);
+
+	mapped_file_t file;
+	BOOST_REQUIRE_EQUAL(0, file.open("a.txt"));
+	BOOST_CHECK(file.is_open());
+	BOOST_CHECK_EQUAL(content.size(), file.size());
+	BOOST_CHECK(content == file.view());
+
+	file.close();
+	BOOST_CHECK(!file.is_open());
+	BOOST_CHECK_EQUAL(0u, file.size());
+	BOOST_CHECK(NULL == file.data());
+}
+
+BOOST_AUTO_TEST_CASE(empty_file_is_an_empty_view)
+{
+	scratch_dir_t scratch;
+	write_file("empty.txt", "");
+
+	mapped_file_t file;
+	BOOST_REQUIRE_EQUAL(0, file.open("empty.txt"));
+	BOOST_CHECK(file.is_open());
+	BOOST_CHECK_EQUAL(0u, file.size());
+	BOOST_CHECK(file.view().empty());
+}
+
+BOOST_AUTO_TEST_CASE(missing_file)
+{
+	scratch_dir_t scratch;
+	mapped_file_t file;
+	BOOST_CHECK_EQUAL(-1, file.open("missing.txt"));
+	BOOST_CHECK(!file.is_open());
+}
+
+BOOST_AUTO_TEST_CASE(reopen_maps_the_new_file)
+{
+	scratch_dir_t scratch;
+	write_file("a.txt", "first");
+	write_file("b.txt", "the second one");
+
+	mapped_file_t file;
+	BOOST_REQUIRE_EQUAL(0, file.open("a.txt"));
+	BOOST_REQUIRE_EQUAL(0, file.open("b.txt"));
+	BOOST_CHECK(std::string_view("the second one") == file.view());
+}
+
+BOOST_AUTO_TEST_CASE(lines_and_tokens_are_views_of_the_mapping)
+{
+	scratch_dir_t scratch;
+	write_file("a.txt", "07 GEN  1 2\n\nlast line without newline");
+
+	mapped_file_t file;
+	BOOST_REQUIRE_EQUAL(0, file.open("a.txt"));
+	const char *cursor = file.data();
+	const char *end = file.data() + file.size();
+
+	const std::string_view first = next_line(cursor, end);
+	BOOST_CHECK(std::string_view("07 GEN  1 2") == first);
+	BOOST_CHECK(first.data() == file.data());
+
+	std::vector<std::string_view> tokens;
+	split_tokens(first, tokens);
+	BOOST_REQUIRE_EQUAL(4u, tokens.size());
+	BOOST_CHECK(std::string_view("GEN") == tokens[1]);
+	BOOST_CHECK(std::string_view("1") == tokens[2]);
+	BOOST_CHECK(tokens[3].data() >= file.data() && tokens[3].data() < end);
+
+	BOOST_CHECK(next_line(cursor, end).empty());
+	BOOST_CHECK(std::string_view("last line without newline") == next_line(cursor, end));
+	BOOST_CHECK(cursor == end);
+}
+
+BOOST_AUTO_TEST_CASE(parse_uint_accepts_as_strtoul)
+{
+	uint32_t value = 0;
+	BOOST_CHECK(parse_uint("42", value));
+	BOOST_CHECK_EQUAL(42u, value);
+	BOOST_CHECK(parse_uint(" +7", value));
+	BOOST_CHECK_EQUAL(7u, value);
+	BOOST_CHECK(parse_uint("12abc", value));
+	BOOST_CHECK_EQUAL(12u, value);
+	BOOST_CHECK(!parse_uint("--", value));
+	BOOST_CHECK(!parse_uint("", value));
+	BOOST_CHECK(!parse_uint("+", value));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
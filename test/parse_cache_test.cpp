@@ -0,0 +1,202 @@
+/*
+ * parse_cache_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "crc32c.h"
+#include "db_io.h"
+#include "year_parser.h"
+#include "parse_cache.h"
+#include "test_helpers.h"
+
+// a cache of the year file holding records, as the layout documents it
+static void write_cache(uint32_t year, const std::vector<extraction_t>& records, uint32_t version = LOTTO_PARSE_CACHE_VERSION)
+{
+	const std::string text = read_whole_file(std::to_string(year) + ".txt");
+	std::vector<uint8_t> bytes(LOTTO_PARSE_CACHE_HEADER + records.size() * LOTTO_RECORD_BYTES, 0);
+	encode_records(records.data(), records.size(), bytes.data() + LOTTO_PARSE_CACHE_HEADER);
+	std::memcpy(bytes.data(), LOTTO_PARSE_CACHE_MAGIC, 8);
+	store_be(bytes.data() + 8, version, 4);
+	store_be(bytes.data() + 12, year, 4);
+	store_be(bytes.data() + 16, text.size(), 8);
+	store_be(bytes.data() + 24, crc32c_update(0, (const uint8_t *) text.data(), text.size()), 4);
+	store_be(bytes.data() + 28, crc32c_update(0, bytes.data() + LOTTO_PARSE_CACHE_HEADER, records.size() * LOTTO_RECORD_BYTES), 4);
+	store_be(bytes.data() + 32, records.size(), 8);
+	store_be(bytes.data() + 40, crc32c_update(0, bytes.data(), 40), 4);
+
+	boost::filesystem::create_directories(LOTTO_PARSE_CACHE_DIR);
+	std::ofstream out(parse_cache_path(year).c_str(), std::ios::binary | std::ios::trunc);
+	out.write((const char *) bytes.data(), bytes.size());
+}
+
+static void overwrite_byte(const boost::filesystem::path& file, uint64_t offset, char value)
+{
+	std::fstream io(file.c_str(), std::ios::binary | std::ios::in | std::ios::out);
+	io.seekp(offset);
+	io.put(value);
+}
+
+static void check_same_records(const std::vector<extraction_t>& expected, const std::vector<extraction_t>& found)
+{
+	BOOST_REQUIRE_EQUAL(expected.size(), found.size());
+	for( size_t i = 0; i < expected.size(); i++ )
+	{
+		BOOST_REQUIRE_EQUAL(expected[i].raw, found[i].raw);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(parse_cache)
+
+BOOST_AUTO_TEST_CASE(cache_path_is_per_year)
+{
+	BOOST_CHECK_EQUAL(std::string(LOTTO_PARSE_CACHE_DIR "/1999.cache"), parse_cache_path(1999).string());
+	BOOST_CHECK_EQUAL(std::string(LOTTO_PARSE_CACHE_DIR "/0871.cache"), parse_cache_path(871).string());
+}
+
+BOOST_AUTO_TEST_CASE(miss_writes_the_cache_a_hit_reads_it)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> parsed = make_year_files(2005, 2005, 40);
+	BOOST_REQUIRE(!boost::filesystem::exists(parse_cache_path(2005)));
+
+	std::vector<extraction_t> missed;
+	BOOST_REQUIRE_EQUAL(0, process_file_cached(missed, 2005));
+	check_same_records(parsed, missed);
+	BOOST_REQUIRE(boost::filesystem::exists(parse_cache_path(2005)));
+	BOOST_CHECK_EQUAL(LOTTO_PARSE_CACHE_HEADER + parsed.size() * LOTTO_RECORD_BYTES, boost::filesystem::file_size(parse_cache_path(2005)));
+	const std::string cache = read_whole_file(parse_cache_path(2005));
+
+	// a hit is appended to the records given and leaves the cache as it is
+	std::vector<extraction_t> hit(1, parsed.back());
+	BOOST_REQUIRE_EQUAL(0, process_file_cached(hit, 2005));
+	BOOST_REQUIRE_EQUAL(parsed.size() + 1, hit.size());
+	hit.erase(hit.begin());
+	check_same_records(parsed, hit);
+	BOOST_CHECK(cache == read_whole_file(parse_cache_path(2005)));
+}
+
+BOOST_AUTO_TEST_CASE(matching_cache_is_not_parsed_again)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> parsed = make_year_files(2005, 2005, 40);
+
+	// records that are not those of the text come back as they are
+	const std::vector<extraction_t> other = make_records(1990, 3);
+	write_cache(2005, other);
+	std::vector<extraction_t> found;
+	BOOST_REQUIRE_EQUAL(0, process_file_cached(found, 2005));
+	check_same_records(other, found);
+}
+
+BOOST_AUTO_TEST_CASE(changed_year_file_is_parsed_again)
+{
+	scratch_dir_t scratch;
+	make_year_files(2005, 2005, 40);
+	write_cache(2005, make_records(1990, 3));
+
+	// another text, of the same size too
+	std::string text = read_whole_file("2005.txt");
+	const size_t at = text.find(" 01 ");
+	BOOST_REQUIRE_NE(std::string::npos, at);
+	text[at + 1] = '1';
+	{
+		std::ofstream out("2005.txt", std::ios::binary | std::ios::trunc);
+		out << text;
+	}
+	std::vector<extraction_t> parsed;
+	BOOST_REQUIRE_EQUAL(0, process_file(parsed, 2005));
+
+	std::vector<extraction_t> found;
+	BOOST_REQUIRE_EQUAL(0, process_file_cached(found, 2005));
+	check_same_records(parsed, found);
+	// and the cache now matches the new text
+	found.clear();
+	BOOST_REQUIRE_EQUAL(0, process_file_cached(found, 2005));
+	check_same_records(parsed, found);
+	BOOST_CHECK_EQUAL(LOTTO_PARSE_CACHE_HEADER + parsed.size() * LOTTO_RECORD_BYTES, boost::filesystem::file_size(parse_cache_path(2005)));
+}
+
+BOOST_AUTO_TEST_CASE(damaged_cache_falls_back_to_the_parser)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> parsed = make_year_files(2005, 2005, 40);
+	std::vector<extraction_t> found;
+	BOOST_REQUIRE_EQUAL(0, process_file_cached(found, 2005));
+	const std::string cache = read_whole_file(parse_cache_path(2005));
+
+	// a record, the magic, the year and the number of records
+	const uint64_t offsets[] = { LOTTO_PARSE_CACHE_HEADER + 3, 0, 13, 39 };
+	for( uint64_t offset : offsets )
+	{
+		overwrite_byte(parse_cache_path(2005), offset, cache[offset] ^ 0x10);
+		found.clear();
+		BOOST_REQUIRE_EQUAL(0, process_file_cached(found, 2005));
+		check_same_records(parsed, found);
+		BOOST_CHECK(cache == read_whole_file(parse_cache_path(2005)));
+	}
+
+	// a cut file and one of another parser
+	boost::filesystem::resize_file(parse_cache_path(2005), cache.size() - LOTTO_RECORD_BYTES);
+	found.clear();
+	BOOST_REQUIRE_EQUAL(0, process_file_cached(found, 2005));
+	check_same_records(parsed, found);
+	BOOST_CHECK(cache == read_whole_file(parse_cache_path(2005)));
+
+	write_cache(2005, parsed, LOTTO_PARSE_CACHE_VERSION + 1);
+	found.clear();
+	BOOST_REQUIRE_EQUAL(0, process_file_cached(found, 2005));
+	check_same_records(parsed, found);
+	BOOST_CHECK(cache == read_whole_file(parse_cache_path(2005)));
+}
+
+BOOST_AUTO_TEST_CASE(unwritable_cache_keeps_the_parse)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> parsed = make_year_files(2005, 2005, 40);
+	{
+		std::ofstream out(LOTTO_PARSE_CACHE_DIR);
+		out << "not a directory";
+	}
+	std::vector<extraction_t> found;
+	BOOST_REQUIRE_EQUAL(0, process_file_cached(found, 2005));
+	check_same_records(parsed, found);
+	BOOST_CHECK(boost::filesystem::is_regular_file(LOTTO_PARSE_CACHE_DIR));
+}
+
+BOOST_AUTO_TEST_CASE(missing_year_is_not_cached)
+{
+	scratch_dir_t scratch;
+	std::vector<extraction_t> found;
+	BOOST_CHECK_NE(0, process_file_cached(found, 2005));
+	BOOST_CHECK(!boost::filesystem::exists(parse_cache_path(2005)));
+}
+
+BOOST_AUTO_TEST_CASE(cached_parse_equals_the_parse)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> parsed = make_year_files(1990, 2001, 30);
+	for( uint32_t jobs : { 1u, 4u } )
+	{
+		// the first run fills the cache, the second reads it
+		for( int run = 0; run < 2; run++ )
+		{
+			std::vector<extraction_t> found;
+			BOOST_REQUIRE_EQUAL(0, parse_all_files(found, 1990, 2001, jobs, true));
+			check_same_records(parsed, found);
+		}
+	}
+	for( uint32_t year = 1990; year <= 2001; year++ )
+	{
+		BOOST_CHECK(boost::filesystem::exists(parse_cache_path(year)));
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
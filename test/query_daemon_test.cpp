@@ -0,0 +1,307 @@
+/*
+ * query_daemon_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "utilities.h"
+#include "db_io.h"
+#include "db_file.h"
+#include "db_query.h"
+#include "ritardo_index.h"
+#include "query_daemon.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(query_daemon)
+
+// a daemon serving out.db of the scratch directory from a thread, it
+// is stopped as a signal stops it
+struct daemon_fixture_t
+{
+	daemon_fixture_t(const std::vector<extraction_t>& records) : served(0), running(true), fd(-1)
+	{
+		BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+		server = std::thread([this]() { served = serve_db("out.db", "out.db.sock"); running = false; });
+		for( int attempt = 0; attempt < 500 && fd < 0 && running; attempt++ )
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			fd = daemon_connect("out.db.sock");
+		}
+		if( fd < 0 )
+		{
+			stop();
+			BOOST_FAIL("the daemon did not start");
+		}
+		// a reply tells that the daemon handles the stop signal
+		info();
+	}
+	~daemon_fixture_t()
+	{
+		stop();
+	}
+
+	void stop()
+	{
+		if( fd >= 0 )
+		{
+			::close(fd);
+			fd = -1;
+		}
+		if( running )
+		{
+			std::raise(SIGTERM);
+		}
+		if( server.joinable() )
+		{
+			server.join();
+		}
+		BOOST_CHECK_EQUAL(0, served);
+	}
+
+	// the payloads of the replies to the requests, one each
+	std::vector<std::vector<uint8_t>> query(const std::vector<daemon_request_t>& requests, std::vector<uint32_t>& statuses)
+	{
+		std::vector<size_t> offsets;
+		std::vector<uint8_t> payload;
+		statuses.clear();
+		BOOST_REQUIRE_EQUAL(0, daemon_query(fd, requests.data(), requests.size(), statuses, offsets, payload));
+		BOOST_REQUIRE_EQUAL(requests.size(), statuses.size());
+		std::vector<std::vector<uint8_t>> replies;
+		for( size_t i = 0; i < offsets.size(); i++ )
+		{
+			const size_t end = ( i + 1 < offsets.size() ) ? offsets[i + 1] : payload.size();
+			replies.emplace_back(payload.begin() + offsets[i], payload.begin() + end);
+		}
+		return replies;
+	}
+
+	std::vector<uint8_t> query_one(query_op_t op, uint64_t ruota, uint32_t from_date, uint32_t to_date, uint32_t limit)
+	{
+		std::vector<uint32_t> statuses;
+		const std::vector<std::vector<uint8_t>> replies = query({ { op, (ruota_t) ruota, from_date, to_date, limit } }, statuses);
+		BOOST_REQUIRE_EQUAL((uint32_t) REPLY_OK, statuses[0]);
+		return replies[0];
+	}
+
+	std::vector<uint8_t> info()
+	{
+		const std::vector<uint8_t> reply = query_one(QUERY_INFO, 0, 0, 0, 0);
+		BOOST_REQUIRE_EQUAL(32u, reply.size());
+		return reply;
+	}
+
+	std::thread       server;
+	int32_t           served;
+	std::atomic<bool> running;
+	int               fd;
+};
+
+static const uint32_t all_dates[2] = { make_date(1900, 1, 1), make_date(2100, 1, 1) };
+
+static void check_frequencies(daemon_fixture_t& daemon, const char *file_db, uint32_t from_date, uint32_t to_date)
+{
+	frequency_table_t expected;
+	BOOST_REQUIRE_EQUAL(0, query_frequencies(file_db, from_date, to_date, expected));
+	for( uint64_t ruota : { (uint64_t) ruota_t::NAZIONALE, (uint64_t) ruota_t::ROMA, (uint64_t) ruota_t::TUTTE } )
+	{
+		const std::vector<uint8_t> reply = daemon.query_one(QUERY_FREQUENCY, ruota, from_date, to_date, 0);
+		BOOST_REQUIRE_EQUAL(8u + 90 * 4, reply.size());
+		BOOST_REQUIRE_EQUAL(expected.n_records, load_be(reply.data(), 8));
+		for( uint32_t number = 1; number <= 90; number++ )
+		{
+			BOOST_REQUIRE_EQUAL(expected.counts[ruota][number], load_be(reply.data() + 8 + (number - 1) * 4, 4));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(info_of_the_db)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 100);
+	daemon_fixture_t daemon(records);
+
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open("out.db"));
+	const std::vector<uint8_t> reply = daemon.info();
+	BOOST_CHECK_EQUAL(1u, load_be(reply.data(), 4));
+	BOOST_CHECK_EQUAL(LOTTO_DB_VERSION, load_be(reply.data() + 4, 4));
+	BOOST_CHECK_EQUAL(records.size(), load_be(reply.data() + 8, 8));
+	BOOST_CHECK_EQUAL(reader.layout().crc, load_be(reply.data() + 16, 4));
+	BOOST_CHECK_EQUAL(records.front().date(), load_be(reply.data() + 20, 4));
+	BOOST_CHECK_EQUAL(records.back().date(), load_be(reply.data() + 24, 4));
+}
+
+BOOST_AUTO_TEST_CASE(frequencies_match_the_db)
+{
+	scratch_dir_t scratch;
+	// several blocks of the prefix sums
+	daemon_fixture_t daemon(make_records(1990, 800));
+	check_frequencies(daemon, "out.db", all_dates[0], all_dates[1]);
+	check_frequencies(daemon, "out.db", make_date(1991, 3, 15), make_date(1994, 10, 8));
+	check_frequencies(daemon, "out.db", make_date(1992, 5, 8), make_date(1992, 5, 8));
+	check_frequencies(daemon, "out.db", make_date(2010, 1, 1), make_date(2011, 1, 1));
+}
+
+BOOST_AUTO_TEST_CASE(ritardo_matches_the_index)
+{
+	scratch_dir_t scratch;
+	daemon_fixture_t daemon(make_records(1990, 200));
+	ritardo_index_t index;
+	BOOST_REQUIRE_EQUAL(0, build_ritardo_index("out.db", index));
+
+	const std::vector<uint8_t> reply = daemon.query_one(QUERY_RITARDO, ruota_t::VENEZIA, 0, 0, 0);
+	BOOST_REQUIRE_EQUAL(8u + 90 * 8, reply.size());
+	BOOST_CHECK_EQUAL(index.draws[ruota_t::VENEZIA], load_be(reply.data(), 4));
+	BOOST_CHECK_EQUAL(index.last_date[ruota_t::VENEZIA], load_be(reply.data() + 4, 4));
+	for( uint32_t number = 1; number <= 90; number++ )
+	{
+		const uint8_t *entry = reply.data() + 8 + (number - 1) * 8;
+		BOOST_REQUIRE_EQUAL(ritardo_current(index, ruota_t::VENEZIA, number), load_be(entry, 4));
+		BOOST_REQUIRE_EQUAL(ritardo_max(index, ruota_t::VENEZIA, number), load_be(entry + 4, 4));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(range_returns_up_to_limit_records)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 100);
+	daemon_fixture_t daemon(records);
+
+	// 1990/03/08 to 1990/04/22, records 9 to 31 of the draws
+	const uint32_t from_date = make_date(1990, 3, 8), to_date = make_date(1990, 4, 22);
+	const size_t first = 9 * ruota_t::TUTTE, total = 7 * ruota_t::TUTTE;
+	for( uint32_t limit : { 0u, 5u, (uint32_t) total, 1000u } )
+	{
+		const std::vector<uint8_t> reply = daemon.query_one(QUERY_RANGE, 0, from_date, to_date, limit);
+		const uint32_t returned = std::min<uint32_t>(limit, total);
+		BOOST_REQUIRE_EQUAL(16u + returned * LOTTO_RECORD_BYTES, reply.size());
+		BOOST_CHECK_EQUAL(total, load_be(reply.data(), 8));
+		BOOST_CHECK_EQUAL(returned, load_be(reply.data() + 8, 4));
+		for( uint32_t i = 0; i < returned; i++ )
+		{
+			BOOST_REQUIRE_EQUAL(records[first + i].raw, decode_record(reply.data() + 16 + i * LOTTO_RECORD_BYTES).raw);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(inverted_range_has_no_records)
+{
+	scratch_dir_t scratch;
+	daemon_fixture_t daemon(make_records(1990, 300));
+
+	const uint32_t from_date = make_date(1993, 1, 1), to_date = make_date(1991, 1, 1);
+	const std::vector<uint8_t> frequency = daemon.query_one(QUERY_FREQUENCY, ruota_t::TUTTE, from_date, to_date, 0);
+	BOOST_REQUIRE_EQUAL(8u + 90 * 4, frequency.size());
+	BOOST_CHECK_EQUAL(0u, load_be(frequency.data(), 8));
+	for( uint32_t number = 1; number <= 90; number++ )
+	{
+		BOOST_REQUIRE_EQUAL(0u, load_be(frequency.data() + 8 + (number - 1) * 4, 4));
+	}
+
+	const std::vector<uint8_t> range = daemon.query_one(QUERY_RANGE, 0, from_date, to_date, 1000);
+	BOOST_REQUIRE_EQUAL(16u, range.size());
+	BOOST_CHECK_EQUAL(0u, load_be(range.data(), 8));
+	BOOST_CHECK_EQUAL(0u, load_be(range.data() + 8, 4));
+}
+
+BOOST_AUTO_TEST_CASE(db_without_an_index_is_filtered)
+{
+	scratch_dir_t scratch;
+	// out of date order, the db has no month index
+	std::vector<extraction_t> records = make_records(1990, 100);
+	std::swap(records[5], records[records.size() - 5]);
+	daemon_fixture_t daemon(records);
+	check_frequencies(daemon, "out.db", make_date(1991, 1, 1), make_date(1991, 12, 31));
+
+	const std::vector<uint8_t> range = daemon.query_one(QUERY_RANGE, 0, make_date(1991, 1, 1), make_date(1991, 12, 31), 1000);
+	BOOST_CHECK_EQUAL(48u * ruota_t::TUTTE, load_be(range.data(), 8));
+
+	const std::vector<uint8_t> inverted = daemon.query_one(QUERY_RANGE, 0, make_date(1991, 12, 31), make_date(1991, 1, 1), 1000);
+	BOOST_CHECK_EQUAL(0u, load_be(inverted.data(), 8));
+	const std::vector<uint8_t> frequency = daemon.query_one(QUERY_FREQUENCY, ruota_t::TUTTE, make_date(1991, 12, 31),
+			make_date(1991, 1, 1), 0);
+	BOOST_CHECK_EQUAL(0u, load_be(frequency.data(), 8));
+}
+
+BOOST_AUTO_TEST_CASE(bad_requests_are_answered)
+{
+	scratch_dir_t scratch;
+	daemon_fixture_t daemon(make_records(1990, 10));
+
+	std::vector<uint32_t> statuses;
+	const std::vector<std::vector<uint8_t>> replies = daemon.query(
+	{
+		{ (query_op_t) 9, ruota_t::BARI, 0, 0, 0 },
+		{ QUERY_FREQUENCY, ruota_t::UNKNOWN, all_dates[0], all_dates[1], 0 },
+		{ QUERY_RITARDO, ruota_t::TUTTE, 0, 0, 0 },
+		{ QUERY_INFO, ruota_t::BARI, 0, 0, 0 },
+	}, statuses);
+	BOOST_CHECK_EQUAL((uint32_t) REPLY_BAD_REQUEST, statuses[0]);
+	BOOST_CHECK_EQUAL((uint32_t) REPLY_BAD_REQUEST, statuses[1]);
+	BOOST_CHECK_EQUAL((uint32_t) REPLY_BAD_REQUEST, statuses[2]);
+	BOOST_CHECK(replies[0].empty());
+	// the connection goes on
+	BOOST_CHECK_EQUAL((uint32_t) REPLY_OK, statuses[3]);
+	BOOST_CHECK_EQUAL(32u, replies[3].size());
+}
+
+BOOST_AUTO_TEST_CASE(a_replaced_db_is_reloaded)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 100);
+	const std::vector<extraction_t> head(records.begin(), records.begin() + 500);
+	daemon_fixture_t daemon(head);
+
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+	std::vector<uint8_t> reply = daemon.info();
+	for( int attempt = 0; attempt < 100 && 1 == load_be(reply.data(), 4); attempt++ )
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(LOTTO_DAEMON_RELOAD_MS / 2));
+		reply = daemon.info();
+	}
+	BOOST_CHECK_EQUAL(2u, load_be(reply.data(), 4));
+	BOOST_CHECK_EQUAL(records.size(), load_be(reply.data() + 8, 8));
+	check_frequencies(daemon, "out.db", all_dates[0], all_dates[1]);
+}
+
+BOOST_AUTO_TEST_CASE(a_damaged_db_is_not_loaded)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 100);
+	daemon_fixture_t daemon(records);
+
+	// a new file whose records do not match its checksum
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "new.db"));
+	std::string file = read_whole_file("new.db");
+	file[LOTTO_HEADER_BYTES + 3] ^= 1;
+	{
+		std::ofstream out("new.db", std::ios::binary | std::ios::trunc);
+		out << file;
+	}
+	boost::filesystem::rename("new.db", "out.db");
+	std::this_thread::sleep_for(std::chrono::milliseconds(4 * LOTTO_DAEMON_RELOAD_MS));
+
+	const std::vector<uint8_t> reply = daemon.info();
+	BOOST_CHECK_EQUAL(1u, load_be(reply.data(), 4));
+	BOOST_CHECK_EQUAL(records.size(), load_be(reply.data() + 8, 8));
+}
+
+BOOST_AUTO_TEST_CASE(no_daemon)
+{
+	scratch_dir_t scratch;
+	BOOST_CHECK_LT(daemon_connect("missing.sock"), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,101 @@
+/*
+ * record_scanner_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <fstream>
+#include <string_view>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "utilities.h"
+#include "record_scanner.h"
+#include "year_parser.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(record_scanner)
+
+BOOST_AUTO_TEST_CASE(scans_a_record_line)
+{
+	record_t rec;
+	BOOST_REQUIRE_EQUAL(scan_status_t::SCAN_OK, scan_record("07 GEN 01 22 33 44 90 -- -- -- -- -- X", 2, rec));
+	BOOST_CHECK_EQUAL(7u, rec.day);
+	BOOST_CHECK_EQUAL(mese_t::GEN, rec.month);
+	BOOST_CHECK_EQUAL(13u, rec.tok_size);
+	const uint64_t expected[] = { 1, 22, 33, 44, 90, 0, 0, 0, 0, 0 };
+	BOOST_CHECK_EQUAL_COLLECTIONS(expected, expected + 10, rec.numbers, rec.numbers + 10);
+}
+
+BOOST_AUTO_TEST_CASE(extra_blanks_and_month_case)
+{
+	record_t rec;
+	BOOST_REQUIRE_EQUAL(scan_status_t::SCAN_OK, scan_record("  03   dic 05 06 07 08 09   X  ", 1, rec));
+	BOOST_CHECK_EQUAL(3u, rec.day);
+	BOOST_CHECK_EQUAL(mese_t::DIC, rec.month);
+	BOOST_CHECK_EQUAL(5u, rec.numbers[0]);
+	BOOST_CHECK_EQUAL(9u, rec.numbers[4]);
+}
+
+BOOST_AUTO_TEST_CASE(end_of_records)
+{
+	record_t rec;
+	BOOST_CHECK_EQUAL(scan_status_t::SCAN_END, scan_record("END", 2, rec));
+	BOOST_CHECK_EQUAL(scan_status_t::SCAN_ILL_FORMED, scan_record("", 2, rec));
+	BOOST_CHECK_EQUAL(scan_status_t::SCAN_ILL_FORMED, scan_record("07 GEN 01 02 03 04 05 X", 2, rec));
+}
+
+BOOST_AUTO_TEST_CASE(bad_fields_are_reported)
+{
+	record_t rec;
+	BOOST_CHECK_EQUAL(scan_status_t::SCAN_BAD_DAY, scan_record("32 GEN 01 02 03 04 05 X", 1, rec));
+	BOOST_CHECK_EQUAL(32u, rec.bad_value);
+
+	BOOST_CHECK_EQUAL(scan_status_t::SCAN_BAD_MONTH, scan_record("07 JAN 01 02 03 04 05 X", 1, rec));
+	BOOST_CHECK(std::string_view("JAN") == rec.bad_token);
+
+	BOOST_CHECK_EQUAL(scan_status_t::SCAN_BAD_NUMBER, scan_record("07 GEN 01 02 91 04 05 X", 1, rec));
+	BOOST_CHECK(std::string_view("91") == rec.bad_token);
+	BOOST_CHECK_EQUAL(91u, rec.bad_value);
+
+	BOOST_CHECK_EQUAL(scan_status_t::SCAN_BAD_NUMBER, scan_record("07 GEN 01 02 ab 04 05 X", 1, rec));
+	BOOST_CHECK_EQUAL(0u, rec.bad_value);
+
+	// numbers and days have two characters, as in the year files
+	BOOST_CHECK_EQUAL(scan_status_t::SCAN_BAD_NUMBER, scan_record("07 GEN 01 02 3 04 05 X", 1, rec));
+	BOOST_CHECK_EQUAL(scan_status_t::SCAN_BAD_DAY, scan_record("7 GEN 01 02 03 04 05 X", 1, rec));
+}
+
+BOOST_AUTO_TEST_CASE(process_file_skips_the_ruote_not_drawn)
+{
+	scratch_dir_t scratch;
+	{
+		std::ofstream out("1950.txt", std::ios::binary);
+		out << "1950 ROMA BARI 1950\n" \
+		       "07 GEN 01 02 03 04 05 10 20 30 40 50 X\n" \
+		       "14 GEN -- -- -- -- -- 11 21 31 41 51 X\n" \
+		       "END\n";
+	}
+
+	std::vector<extraction_t> extraction_vec;
+	BOOST_REQUIRE_EQUAL(0, process_file(extraction_vec, 1950));
+	BOOST_REQUIRE_EQUAL(3u, extraction_vec.size());
+	// in ruota order within a draw, whatever the order of the header
+	BOOST_CHECK_EQUAL(make_extraction(1950, 1, 7, ruota_t::BARI, 10, 20, 30, 40, 50).raw, extraction_vec[0].raw);
+	BOOST_CHECK_EQUAL(make_extraction(1950, 1, 7, ruota_t::ROMA, 1, 2, 3, 4, 5).raw, extraction_vec[1].raw);
+	BOOST_CHECK_EQUAL(make_extraction(1950, 1, 14, ruota_t::BARI, 11, 21, 31, 41, 51).raw, extraction_vec[2].raw);
+}
+
+BOOST_AUTO_TEST_CASE(process_file_fails_on_a_bad_number)
+{
+	scratch_dir_t scratch;
+	{
+		std::ofstream out("1950.txt", std::ios::binary);
+		out << "1950 ROMA 1950\n07 GEN 1 2 3 4 95 X\nEND\n";
+	}
+
+	std::vector<extraction_t> extraction_vec;
+	BOOST_CHECK_EQUAL(-1, process_file(extraction_vec, 1950));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
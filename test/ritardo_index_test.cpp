@@ -0,0 +1,157 @@
+/*
+ * ritardo_index_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "db_file.h"
+#include "ritardo_index.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(ritardo_index)
+
+// current and maximum delays by walking the draws of every ruota
+static void naive_delays(const std::vector<extraction_t>& records, uint32_t current[ruota_t::TUTTE][91],
+		uint32_t maximum[ruota_t::TUTTE][91])
+{
+	uint32_t draws[ruota_t::TUTTE] = { 0 };
+	uint32_t last_seen[ruota_t::TUTTE][91] = { { 0 } };
+	std::memset(maximum, 0, sizeof(uint32_t) * ruota_t::TUTTE * 91);
+	for( const auto& ex : records )
+	{
+		const uint32_t draw = ++draws[ex.ruota()];
+		for( uint32_t number : { ex.a(), ex.b(), ex.c(), ex.d(), ex.e() } )
+		{
+			const uint32_t delay = draw - 1 - last_seen[ex.ruota()][number];
+			maximum[ex.ruota()][number] = std::max(maximum[ex.ruota()][number], delay);
+			last_seen[ex.ruota()][number] = draw;
+		}
+	}
+	for( uint32_t r = 0; r < ruota_t::TUTTE; r++ )
+	{
+		for( uint32_t number = 1; number <= 90; number++ )
+		{
+			current[r][number] = draws[r] - last_seen[r][number];
+			maximum[r][number] = std::max(maximum[r][number], current[r][number]);
+		}
+	}
+}
+
+static void check_same_index(const ritardo_index_t& expected, const ritardo_index_t& found)
+{
+	for( uint32_t r = 0; r < ruota_t::TUTTE; r++ )
+	{
+		BOOST_REQUIRE_EQUAL(expected.draws[r], found.draws[r]);
+		BOOST_REQUIRE_EQUAL(expected.last_date[r], found.last_date[r]);
+		for( uint32_t number = 1; number <= 90; number++ )
+		{
+			BOOST_REQUIRE_EQUAL(expected.entries[r][number].last_seen, found.entries[r][number].last_seen);
+			BOOST_REQUIRE_EQUAL(expected.entries[r][number].max_delay, found.entries[r][number].max_delay);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(delays_match_a_naive_walk)
+{
+	const std::vector<extraction_t> records = make_records(1990, 600);
+	ritardo_index_t index;
+	ritardo_reset(index);
+	ritardo_update(index, records.data(), records.size());
+
+	static uint32_t current[ruota_t::TUTTE][91], maximum[ruota_t::TUTTE][91];
+	naive_delays(records, current, maximum);
+	for( uint32_t r = 0; r < ruota_t::TUTTE; r++ )
+	{
+		BOOST_REQUIRE_EQUAL(600u, index.draws[r]);
+		for( uint32_t number = 1; number <= 90; number++ )
+		{
+			BOOST_REQUIRE_EQUAL(current[r][number], ritardo_current(index, (ruota_t) r, number));
+			BOOST_REQUIRE_EQUAL(maximum[r][number], ritardo_max(index, (ruota_t) r, number));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(updates_in_chunks_as_in_one_go)
+{
+	const std::vector<extraction_t> records = make_records(1990, 300);
+	ritardo_index_t whole, chunked;
+	ritardo_reset(whole);
+	ritardo_update(whole, records.data(), records.size());
+
+	ritardo_reset(chunked);
+	for( size_t i = 0; i < records.size(); i += 1000 )
+	{
+		ritardo_update(chunked, records.data() + i, std::min((size_t) 1000, records.size() - i));
+	}
+	check_same_index(whole, chunked);
+
+	// the records of a draw already indexed are not counted again, as
+	// the last draw written again by an append
+	ritardo_update(chunked, records.data() + records.size() - 2 * ruota_t::TUTTE, 2 * ruota_t::TUTTE);
+	check_same_index(whole, chunked);
+}
+
+BOOST_AUTO_TEST_CASE(index_tied_to_its_db)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 200);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+	BOOST_CHECK(boost::filesystem::path("out.db.rit") == ritardo_index_path("out.db"));
+
+	ritardo_index_t built, loaded;
+	BOOST_CHECK_EQUAL(-1, load_current_ritardo_index("out.db", loaded));
+	BOOST_REQUIRE_EQUAL(0, build_ritardo_index("out.db", built));
+	BOOST_REQUIRE_EQUAL(0, load_current_ritardo_index("out.db", loaded));
+	BOOST_CHECK_EQUAL(records.size(), loaded.db_records);
+	check_same_index(built, loaded);
+
+	// the db changes, the index no longer matches it
+	const std::vector<extraction_t> fewer(records.begin(), records.end() - 1);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(fewer, "out.db"));
+	BOOST_CHECK_EQUAL(-1, load_current_ritardo_index("out.db", loaded));
+}
+
+BOOST_AUTO_TEST_CASE(incremental_index_equals_a_rebuild)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 200);
+	const std::vector<extraction_t> head(records.begin(), records.begin() + 1100);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(head, "out.db"));
+	ritardo_index_t index;
+	BOOST_REQUIRE_EQUAL(0, build_ritardo_index("out.db", index));
+
+	// as an append carries the index forward
+	db_file_writer_t writer;
+	BOOST_REQUIRE_EQUAL(0, writer.open_db_append("out.db", head.size()));
+	BOOST_REQUIRE_EQUAL(0, writer.write_records(records.data() + head.size(), records.size() - head.size()));
+	BOOST_REQUIRE_EQUAL(0, writer.write_trailer());
+	BOOST_REQUIRE_EQUAL(0, writer.commit());
+	ritardo_update(index, records.data() + head.size(), records.size() - head.size());
+	index.db_records = records.size();
+	index.db_crc = writer.crc();
+	BOOST_REQUIRE_EQUAL(0, save_ritardo_index(index, ritardo_index_path("out.db")));
+
+	ritardo_index_t loaded, rebuilt;
+	BOOST_REQUIRE_EQUAL(0, load_current_ritardo_index("out.db", loaded));
+	BOOST_REQUIRE_EQUAL(0, build_ritardo_index("out.db", rebuilt));
+	check_same_index(rebuilt, loaded);
+}
+
+BOOST_AUTO_TEST_CASE(a_foreign_file_is_no_index)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> records = make_records(1990, 20);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+
+	ritardo_index_t index;
+	BOOST_CHECK_EQUAL(-1, load_ritardo_index("missing.rit", index));
+	BOOST_CHECK_EQUAL(-1, load_ritardo_index("out.db", index));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,60 @@
+/*
+ * test_helpers.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <fstream>
+#include <iterator>
+#include <boost/test/unit_test.hpp>
+#include "year_generator.h"
+#include "year_parser.h"
+#include "test_helpers.h"
+
+std::vector<extraction_t> make_year_files(uint32_t start_year, uint32_t end_year, uint32_t draws)
+{
+	std::vector<extraction_t> extraction_vec;
+	BOOST_REQUIRE_EQUAL(0, generate_year_files(start_year, end_year, draws, LOTTO_TEST_SEED));
+	BOOST_REQUIRE_EQUAL(0, parse_all_files(extraction_vec, start_year, end_year, 1, false));
+	return extraction_vec;
+}
+
+std::vector<extraction_t> make_records(uint32_t start_year, uint32_t n_draws)
+{
+	std::vector<extraction_t> extraction_vec;
+	extraction_vec.reserve((size_t) n_draws * ruota_t::TUTTE);
+	uint64_t state = LOTTO_TEST_SEED;
+	for( uint32_t d = 0; d < n_draws; d++ )
+	{
+		const uint32_t year = start_year + d / 48;
+		const uint32_t month = 1 + (d / 4) % 12;
+		const uint32_t day = 1 + (d % 4) * 7;
+		for( uint64_t r = ruota_t::NAZIONALE; r < ruota_t::TUTTE; r++ )
+		{
+			uint64_t numbers[5];
+			for( size_t k = 0; k < 5; k++ )
+			{
+				bool again = true;
+				while( again )
+				{
+					state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+					numbers[k] = 1 + (state >> 33) % 90;
+					again = false;
+					for( size_t j = 0; j < k; j++ )
+					{
+						again = again || numbers[j] == numbers[k];
+					}
+				}
+			}
+			extraction_vec.push_back(make_extraction(year, month, day, r, numbers[0], numbers[1], numbers[2], numbers[3], numbers[4]));
+		}
+	}
+	return extraction_vec;
+}
+
+std::string read_whole_file(const boost::filesystem::path& file)
+{
+	std::ifstream in(file.c_str(), std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
@@ -0,0 +1,50 @@
+// helpers shared by the unit tests: a scratch directory per test case
+// and the records of synthetic year files
+
+#ifndef LOTTO_TEST_HELPERS_H
+#define LOTTO_TEST_HELPERS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "basic_types.h"
+
+// the seed of the synthetic year files of the tests
+#define LOTTO_TEST_SEED    (20261016)
+
+// a fresh directory made the current one for the life of the fixture,
+// as the importer reads the year files and writes the dbs there; the
+// previous current directory is restored and the scratch one removed
+struct scratch_dir_t
+{
+	scratch_dir_t() : previous(boost::filesystem::current_path())
+	{
+		dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("lotto_test_%%%%-%%%%-%%%%");
+		boost::filesystem::create_directories(dir);
+		boost::filesystem::current_path(dir);
+	}
+	~scratch_dir_t()
+	{
+		boost::system::error_code ec;
+		boost::filesystem::current_path(previous, ec);
+		boost::filesystem::remove_all(dir, ec);
+	}
+
+	boost::filesystem::path previous;
+	boost::filesystem::path dir;
+};
+
+// write the synthetic year files from start_year to end_year in the
+// current directory and return their records as the parser gives them
+std::vector<extraction_t> make_year_files(uint32_t start_year, uint32_t end_year, uint32_t draws);
+
+// n_draws draws in date order from the 1st of January of start_year,
+// four a month, each on the eleven ruote in ruota order with five
+// distinct numbers; the same arguments give the same records
+std::vector<extraction_t> make_records(uint32_t start_year, uint32_t n_draws);
+
+// the whole content of a file, empty when it can not be read
+std::string read_whole_file(const boost::filesystem::path& file);
+
+#endif // LOTTO_TEST_HELPERS_H
@@ -0,0 +1,28 @@
+/*
+ * test_main.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#define BOOST_TEST_MODULE lotto_importer
+#include <cstdlib>
+#include <boost/test/included/unit_test.hpp>
+#include "logger.h"
+
+// the diagnostics of the cases that expect an error are not written,
+// LOTTO_TEST_LOG=1 shows them
+struct log_level_fixture_t
+{
+	log_level_fixture_t()
+	{
+		const char *verbose = std::getenv("LOTTO_TEST_LOG");
+		log_set_level( ( NULL != verbose && '1' == verbose[0] ) ? LOG_DEBUG : LOG_SILENT );
+	}
+	~log_level_fixture_t()
+	{
+		log_flush();
+	}
+};
+
+BOOST_TEST_GLOBAL_FIXTURE(log_level_fixture_t);
@@ -0,0 +1,68 @@
+/*
+ * utilities_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <string>
+#include <string_view>
+#include <boost/test/unit_test.hpp>
+#include "utilities.h"
+
+BOOST_AUTO_TEST_SUITE(utilities)
+
+BOOST_AUTO_TEST_CASE(every_ruota_name_round_trips)
+{
+	for( uint64_t r = ruota_t::NAZIONALE; r < ruota_t::UNKNOWN; r++ )
+	{
+		const std::string_view name = convert_ruota_to_string((ruota_t) r);
+		BOOST_CHECK_EQUAL(r, (uint64_t) convert_string_to_ruota(name));
+
+		std::string lower(name);
+		for( auto& c : lower )
+		{
+			c = (char) (c - 'A' + 'a');
+		}
+		BOOST_CHECK_EQUAL(r, (uint64_t) convert_string_to_ruota(lower));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(unknown_ruota_names)
+{
+	BOOST_CHECK_EQUAL(ruota_t::UNKNOWN, convert_string_to_ruota(""));
+	BOOST_CHECK_EQUAL(ruota_t::UNKNOWN, convert_string_to_ruota("BAR"));
+	BOOST_CHECK_EQUAL(ruota_t::UNKNOWN, convert_string_to_ruota("BARII"));
+	BOOST_CHECK_EQUAL(ruota_t::UNKNOWN, convert_string_to_ruota("UNKNOWN"));
+	BOOST_CHECK_EQUAL(ruota_t::UNKNOWN, convert_string_to_ruota("1871"));
+	BOOST_CHECK(std::string_view("UNKNOWN") == convert_ruota_to_string((ruota_t) 14));
+}
+
+BOOST_AUTO_TEST_CASE(every_mese_name_round_trips)
+{
+	for( uint64_t m = mese_t::GEN; m <= mese_t::DIC; m++ )
+	{
+		const std::string_view name = convert_mese_to_string((mese_t) m);
+		BOOST_CHECK_EQUAL(m, (uint64_t) convert_string_to_mese(name));
+		const std::string mixed = std::string(1, name[0]) + (char) (name[1] - 'A' + 'a') + name[2];
+		BOOST_CHECK_EQUAL(m, (uint64_t) convert_string_to_mese(mixed));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(unknown_mese_names)
+{
+	BOOST_CHECK_EQUAL(mese_t::NULL_MESE, convert_string_to_mese(""));
+	BOOST_CHECK_EQUAL(mese_t::NULL_MESE, convert_string_to_mese("GE"));
+	BOOST_CHECK_EQUAL(mese_t::NULL_MESE, convert_string_to_mese("GENN"));
+	BOOST_CHECK_EQUAL(mese_t::NULL_MESE, convert_string_to_mese("JAN"));
+	BOOST_CHECK(std::string_view("UNKNOWN") == convert_mese_to_string((mese_t) 13));
+}
+
+BOOST_AUTO_TEST_CASE(dates_order_as_the_calendar)
+{
+	BOOST_CHECK_LT(make_date(2019, 12, 31), make_date(2020, 1, 1));
+	BOOST_CHECK_LT(make_date(2020, 1, 31), make_date(2020, 2, 1));
+	BOOST_CHECK_EQUAL(make_date(1871, 1, 7), extraction_date(make_extraction(1871, 1, 7, ruota_t::VENEZIA, 1, 2, 3, 4, 5)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
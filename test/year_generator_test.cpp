@@ -0,0 +1,82 @@
+/*
+ * year_generator_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "year_generator.h"
+#include "year_parser.h"
+#include "test_helpers.h"
+
+BOOST_AUTO_TEST_SUITE(year_generator)
+
+BOOST_AUTO_TEST_CASE(text_depends_on_year_draws_and_seed)
+{
+	std::string text, again, other;
+	generate_year_text(2001, 100, 7, text);
+	generate_year_text(2001, 100, 7, again);
+	BOOST_CHECK(text == again);
+
+	generate_year_text(2001, 100, 8, other);
+	BOOST_CHECK(text != other);
+	generate_year_text(2002, 100, 7, other);
+	BOOST_CHECK(text != other);
+
+	BOOST_CHECK_EQUAL(0u, text.find("2001 BARI CAGLIARI "));
+	BOOST_CHECK_EQUAL(text.size() - 4, text.rfind("END\n"));
+}
+
+BOOST_AUTO_TEST_CASE(files_parse_into_distinct_dates)
+{
+	scratch_dir_t scratch;
+	for( uint32_t draws : { 1u, 156u, (uint32_t) LOTTO_SYNTHETIC_MAX_DRAWS } )
+	{
+		boost::filesystem::remove("1999.txt");
+		std::vector<extraction_t> records = make_year_files(1999, 1999, draws);
+
+		// every draw on its own date, a ruota in 64 not drawn
+		std::set<uint32_t> dates;
+		for( const auto& ex : records )
+		{
+			BOOST_REQUIRE_EQUAL(1999u, ex.year());
+			const uint32_t numbers[5] = { ex.a(), ex.b(), ex.c(), ex.d(), ex.e() };
+			for( size_t i = 0; i < 5; i++ )
+			{
+				BOOST_REQUIRE(numbers[i] >= 1 && numbers[i] <= 90);
+				for( size_t j = 0; j < i; j++ )
+				{
+					BOOST_REQUIRE_NE(numbers[i], numbers[j]);
+				}
+			}
+			dates.insert(ex.date());
+		}
+		BOOST_CHECK_EQUAL(draws, dates.size());
+		BOOST_CHECK_LE(records.size(), draws * 11u);
+		BOOST_CHECK_GT(records.size(), draws * 9u);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(existing_files_are_left_untouched)
+{
+	scratch_dir_t scratch;
+	make_year_files(2000, 2000, 10);
+	const std::string before = read_whole_file("2000.txt");
+	BOOST_CHECK_EQUAL(-1, generate_year_files(1999, 2001, 20, LOTTO_TEST_SEED));
+	BOOST_CHECK(before == read_whole_file("2000.txt"));
+}
+
+BOOST_AUTO_TEST_CASE(draws_out_of_range)
+{
+	scratch_dir_t scratch;
+	BOOST_CHECK_EQUAL(-1, generate_year_files(2000, 2000, 0, LOTTO_TEST_SEED));
+	BOOST_CHECK_EQUAL(-1, generate_year_files(2000, 2000, LOTTO_SYNTHETIC_MAX_DRAWS + 1, LOTTO_TEST_SEED));
+	BOOST_CHECK(!boost::filesystem::exists("2000.txt"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
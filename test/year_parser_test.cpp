@@ -0,0 +1,171 @@
+/*
+ * year_parser_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "year_parser.h"
+#include "test_helpers.h"
+
+// a history file of the year files in the order given
+static void write_history_file(const char *file_history, const std::vector<uint32_t>& years)
+{
+	std::ofstream out(file_history, std::ios::binary | std::ios::trunc);
+	for( uint32_t year : years )
+	{
+		out << read_whole_file(std::to_string(year) + ".txt");
+	}
+}
+
+static std::vector<uint32_t> year_range(uint32_t start_year, uint32_t end_year)
+{
+	std::vector<uint32_t> years;
+	for( uint32_t year = start_year; year <= end_year; year++ )
+	{
+		years.push_back(year);
+	}
+	return years;
+}
+
+BOOST_AUTO_TEST_SUITE(year_parser)
+
+BOOST_AUTO_TEST_CASE(parallel_parse_keeps_the_year_order)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> serial = make_year_files(1990, 2009, 40);
+	BOOST_REQUIRE(!serial.empty());
+	BOOST_CHECK_EQUAL(1990u, serial.front().year());
+	BOOST_CHECK_EQUAL(2009u, serial.back().year());
+
+	for( uint32_t jobs : { 2u, 4u, 32u } )
+	{
+		std::vector<extraction_t> parallel;
+		BOOST_REQUIRE_EQUAL(0, parse_all_files(parallel, 1990, 2009, jobs, false));
+		BOOST_REQUIRE_EQUAL(serial.size(), parallel.size());
+		for( size_t i = 0; i < serial.size(); i++ )
+		{
+			BOOST_REQUIRE_EQUAL(serial[i].raw, parallel[i].raw);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(parallel_parse_appends_to_the_records_given)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> all = make_year_files(2000, 2003, 20);
+	std::vector<extraction_t> head;
+	BOOST_REQUIRE_EQUAL(0, parse_all_files(head, 2000, 2001, 1, false));
+
+	std::vector<extraction_t> joined = head;
+	BOOST_REQUIRE_EQUAL(0, parse_all_files(joined, 2002, 2003, 3, false));
+	BOOST_REQUIRE_EQUAL(all.size(), joined.size());
+	for( size_t i = 0; i < all.size(); i++ )
+	{
+		BOOST_REQUIRE_EQUAL(all[i].raw, joined[i].raw);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(parallel_parse_fails_on_a_missing_year)
+{
+	scratch_dir_t scratch;
+	make_year_files(2000, 2007, 10);
+	boost::filesystem::remove("2005.txt");
+
+	for( uint32_t jobs : { 1u, 4u } )
+	{
+		std::vector<extraction_t> extraction_vec;
+		BOOST_CHECK_EQUAL(-1, parse_all_files(extraction_vec, 2000, 2007, jobs, false));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(empty_year_range)
+{
+	scratch_dir_t scratch;
+	std::vector<extraction_t> extraction_vec;
+	BOOST_CHECK_EQUAL(0, process_all_files_parallel(extraction_vec, 2001, 2000, 4, false));
+	BOOST_CHECK(extraction_vec.empty());
+}
+
+BOOST_AUTO_TEST_CASE(history_file_equals_the_year_files)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> all = make_year_files(1960, 2001, 365);
+	write_history_file("history.txt", year_range(1960, 2001));
+	// cut in chunks that end inside the years
+	BOOST_REQUIRE_GT(boost::filesystem::file_size("history.txt"), 2 * LOTTO_HISTORY_CHUNK_BYTES);
+
+	for( uint32_t jobs : { 1u, 4u } )
+	{
+		std::vector<extraction_t> history;
+		BOOST_REQUIRE_EQUAL(0, parse_history_file(history, "history.txt", 1960, 2001, jobs));
+		BOOST_REQUIRE_EQUAL(all.size(), history.size());
+		for( size_t i = 0; i < all.size(); i++ )
+		{
+			BOOST_REQUIRE_EQUAL(all[i].raw, history[i].raw);
+		}
+
+		// some of the years, after the records given
+		std::vector<extraction_t> head;
+		BOOST_REQUIRE_EQUAL(0, parse_all_files(head, 1960, 1989, 1, false));
+		std::vector<extraction_t> part;
+		BOOST_REQUIRE_EQUAL(0, parse_all_files(part, 1990, 1995, 1, false));
+		const size_t n_head = head.size();
+		BOOST_REQUIRE_EQUAL(0, parse_history_file(head, "history.txt", 1990, 1995, jobs));
+		BOOST_REQUIRE_EQUAL(n_head + part.size(), head.size());
+		for( size_t i = 0; i < part.size(); i++ )
+		{
+			BOOST_REQUIRE_EQUAL(part[i].raw, head[n_head + i].raw);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(history_file_fails_on_a_missing_year)
+{
+	scratch_dir_t scratch;
+	make_year_files(2000, 2007, 40);
+	std::vector<uint32_t> years = year_range(2000, 2007);
+	years.erase(years.begin() + 3);
+	write_history_file("history.txt", years);
+
+	for( uint32_t jobs : { 1u, 4u } )
+	{
+		std::vector<extraction_t> extraction_vec;
+		BOOST_CHECK_EQUAL(-1, parse_history_file(extraction_vec, "history.txt", 2000, 2007, jobs));
+		BOOST_CHECK_EQUAL(-1, parse_history_file(extraction_vec, "history.txt", 1999, 2002, jobs));
+		BOOST_CHECK_EQUAL(-1, parse_history_file(extraction_vec, "history.txt", 2004, 2008, jobs));
+		BOOST_CHECK_EQUAL(-1, parse_history_file(extraction_vec, "history.txt", 2003, 2003, jobs));
+		// the years around the gap are there
+		extraction_vec.clear();
+		BOOST_CHECK_EQUAL(0, parse_history_file(extraction_vec, "history.txt", 2004, 2007, jobs));
+		BOOST_CHECK(!extraction_vec.empty());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(history_file_out_of_order_or_without_header)
+{
+	scratch_dir_t scratch;
+	make_year_files(2000, 2003, 20);
+	std::vector<extraction_t> extraction_vec;
+
+	write_history_file("history.txt", { 2000, 2002, 2001, 2003 });
+	BOOST_CHECK_EQUAL(-1, parse_history_file(extraction_vec, "history.txt", 2000, 2003, 2));
+	write_history_file("history.txt", { 2000, 2001, 2001, 2002, 2003 });
+	BOOST_CHECK_EQUAL(-1, parse_history_file(extraction_vec, "history.txt", 2000, 2003, 2));
+
+	{
+		std::ofstream out("history.txt", std::ios::binary | std::ios::trunc);
+		out << "01 GEN 11 22 33 44 55\n" << read_whole_file("2000.txt");
+	}
+	BOOST_CHECK_EQUAL(-1, parse_history_file(extraction_vec, "history.txt", 2000, 2000, 2));
+	write_history_file("history.txt", {});
+	BOOST_CHECK_EQUAL(-1, parse_history_file(extraction_vec, "history.txt", 2000, 2000, 2));
+	BOOST_CHECK_EQUAL(-1, parse_history_file(extraction_vec, "missing.txt", 2000, 2000, 2));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
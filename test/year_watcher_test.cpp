@@ -0,0 +1,139 @@
+/*
+ * year_watcher_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: fstrati
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "db_file.h"
+#include "year_generator.h"
+#include "year_parser.h"
+#include "year_watcher.h"
+#include "test_helpers.h"
+
+// the db holds the records of a full import of the year files
+static void check_db_equals_import(uint32_t start_year, uint32_t end_year)
+{
+	std::vector<extraction_t> imported;
+	BOOST_REQUIRE_EQUAL(0, parse_all_files(imported, start_year, end_year, 1, false));
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open("out.db"));
+	BOOST_REQUIRE_EQUAL(imported.size(), reader.size());
+	BOOST_CHECK(reader.date_ordered());
+	uint32_t crc = 0;
+	BOOST_CHECK_EQUAL(0, reader.verify(crc));
+	for( size_t i = 0; i < imported.size(); i++ )
+	{
+		BOOST_REQUIRE_EQUAL(imported[i].raw, reader[i].raw);
+	}
+}
+
+// write the year file again with another number of draws
+static void rewrite_year_file(uint32_t year, uint32_t draws)
+{
+	boost::filesystem::remove(std::to_string(year) + ".txt");
+	BOOST_REQUIRE_EQUAL(0, generate_year_files(year, year, draws, LOTTO_TEST_SEED + 1));
+}
+
+BOOST_AUTO_TEST_SUITE(year_watcher)
+
+BOOST_AUTO_TEST_CASE(splice_equals_a_full_import)
+{
+	scratch_dir_t scratch;
+	BOOST_REQUIRE_EQUAL(0, save_file_db(make_year_files(2000, 2004, 30), "out.db"));
+
+	// a year in the middle growing and shrinking, then the first and last
+	rewrite_year_file(2002, 45);
+	BOOST_REQUIRE_EQUAL(0, splice_year_file("out.db", 2002));
+	check_db_equals_import(2000, 2004);
+
+	rewrite_year_file(2002, 12);
+	BOOST_REQUIRE_EQUAL(0, splice_year_file("out.db", 2002));
+	check_db_equals_import(2000, 2004);
+
+	rewrite_year_file(2000, 50);
+	BOOST_REQUIRE_EQUAL(0, splice_year_file("out.db", 2000));
+	check_db_equals_import(2000, 2004);
+
+	rewrite_year_file(2004, 5);
+	BOOST_REQUIRE_EQUAL(0, splice_year_file("out.db", 2004));
+	check_db_equals_import(2000, 2004);
+}
+
+BOOST_AUTO_TEST_CASE(unchanged_year_is_not_written)
+{
+	scratch_dir_t scratch;
+	BOOST_REQUIRE_EQUAL(0, save_file_db(make_year_files(2000, 2002, 20), "out.db"));
+	const std::string before = read_whole_file("out.db");
+	const std::time_t written = boost::filesystem::last_write_time("out.db");
+	// a leftover of a write would be left next to the db
+	const size_t n_files = std::distance(boost::filesystem::directory_iterator("."), boost::filesystem::directory_iterator());
+
+	BOOST_CHECK_EQUAL(0, splice_year_file("out.db", 2001));
+	BOOST_CHECK(before == read_whole_file("out.db"));
+	BOOST_CHECK_EQUAL(written, boost::filesystem::last_write_time("out.db"));
+	BOOST_CHECK_EQUAL(n_files, (size_t) std::distance(boost::filesystem::directory_iterator("."), boost::filesystem::directory_iterator()));
+}
+
+BOOST_AUTO_TEST_CASE(mapped_reader_keeps_the_old_db)
+{
+	scratch_dir_t scratch;
+	const std::vector<extraction_t> old_records = make_year_files(2000, 2002, 20);
+	BOOST_REQUIRE_EQUAL(0, save_file_db(old_records, "out.db"));
+
+	db_reader_t reader;
+	BOOST_REQUIRE_EQUAL(0, reader.open("out.db"));
+	rewrite_year_file(2001, 60);
+	BOOST_REQUIRE_EQUAL(0, splice_year_file("out.db", 2001));
+	check_db_equals_import(2000, 2002);
+
+	// the db was replaced whole, the old mapping is still the old file
+	BOOST_REQUIRE_EQUAL(old_records.size(), reader.size());
+	uint32_t crc = 0;
+	BOOST_CHECK_EQUAL(0, reader.verify(crc));
+	for( size_t i = 0; i < old_records.size(); i++ )
+	{
+		BOOST_REQUIRE_EQUAL(old_records[i].raw, reader[i].raw);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(db_without_month_index_is_refused)
+{
+	scratch_dir_t scratch;
+	std::vector<extraction_t> records = make_year_files(2000, 2002, 20);
+	// the records of 2002 first: the writer drops the month index
+	std::rotate(records.begin(), std::find_if(records.begin(), records.end(),
+			[](const extraction_t& ex){ return 2002 == ex.year(); }), records.end());
+	BOOST_REQUIRE_EQUAL(0, save_file_db(records, "out.db"));
+	{
+		db_reader_t reader;
+		BOOST_REQUIRE_EQUAL(0, reader.open("out.db"));
+		BOOST_REQUIRE(!reader.date_ordered());
+	}
+	const std::string before = read_whole_file("out.db");
+
+	rewrite_year_file(2001, 40);
+	BOOST_CHECK_EQUAL(-1, splice_year_file("out.db", 2001));
+	BOOST_CHECK(before == read_whole_file("out.db"));
+}
+
+BOOST_AUTO_TEST_CASE(unreadable_year_or_db_is_refused)
+{
+	scratch_dir_t scratch;
+	BOOST_REQUIRE_EQUAL(0, save_file_db(make_year_files(2000, 2002, 20), "out.db"));
+	const std::string before = read_whole_file("out.db");
+
+	boost::filesystem::remove("2001.txt");
+	BOOST_CHECK_EQUAL(-1, splice_year_file("out.db", 2001));
+	BOOST_CHECK(before == read_whole_file("out.db"));
+
+	BOOST_CHECK_EQUAL(-1, splice_year_file("missing.db", 2002));
+	BOOST_CHECK(!boost::filesystem::exists("missing.db"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()